@@ -0,0 +1,230 @@
+# Compare google-benchmark results against a stored baseline and flag statistically significant regressions.
+
+"""
+
+Record a baseline (on the reference commit):
+
+python3 ./bench/compare.py ./bench/data/fib.base.json -b ./build/rel/bench/benchmark -f "fib_libfork" --save
+
+Then, after a change, re-run the same subset and compare:
+
+python3 ./bench/compare.py ./bench/data/fib.base.json -b ./build/rel/bench/benchmark -f "fib_libfork"
+
+Or compare two existing result files (both must have been run with --benchmark_repetitions > 1):
+
+python3 ./bench/compare.py old.json -c new.json
+
+The exit code is 1 if any benchmark regressed, such that this can be used as a CI gate.
+
+"""
+
+import argparse
+import json
+import math
+import subprocess
+import sys
+import tempfile
+from functools import lru_cache
+from statistics import median
+
+parser = argparse.ArgumentParser(
+    description="Compare libfork's benchmarks against a baseline using a Mann-Whitney U test."
+)
+
+parser.add_argument("baseline", type=str, help="The baseline google-benchmark JSON file")
+parser.add_argument(
+    "-c", "--contender", type=str, help="Compare this JSON file instead of running the binary"
+)
+parser.add_argument("-b", "--binary", type=str, help="The benchmark binary to run")
+parser.add_argument("-f", "--filter", type=str, default=".", help="Regex passed to --benchmark_filter")
+parser.add_argument("-r", "--repetitions", type=int, default=10, help="Repetitions of each benchmark")
+parser.add_argument(
+    "-s", "--save", action="store_true", help="Run the binary and store the result as the baseline"
+)
+parser.add_argument("-a", "--alpha", type=float, default=0.05, help="Significance level of the test")
+parser.add_argument(
+    "-t", "--threshold", type=float, default=0.05, help="Ignore changes smaller than this fraction"
+)
+parser.add_argument("-m", "--metric", type=str, default="real_time", help="Field to compare, e.g. cpu_time")
+parser.add_argument(
+    "--higher-is-better", action="store_true", help="The metric is a rate (implied for *_per_second metrics)"
+)
+
+args = parser.parse_args()
+
+# Conversion of google-benchmark time units to nanoseconds.
+unit = {"ns": 1, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def run(out):
+    """
+    Run the selected subset of the binary writing the JSON results to out.
+    """
+    if args.binary is None:
+        sys.exit("--binary is required unless --contender is given")
+
+    cmd = [
+        args.binary,
+        f"--benchmark_filter={args.filter}",
+        f"--benchmark_repetitions={args.repetitions}",
+        # Interleave repetitions such that slow drifts (thermals, other tenants) do not bias one benchmark.
+        "--benchmark_enable_random_interleaving=true",
+        "--benchmark_out_format=json",
+        f"--benchmark_out={out}",
+    ]
+
+    print("Running:", " ".join(cmd), file=sys.stderr)
+
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+
+
+def load(path):
+    """
+    Collect the samples of each benchmark as {name: (threads, [sample, ...])}, aggregates are discarded.
+    """
+    with open(path) as f:
+        data = json.load(f)
+
+    samples = {}
+
+    for bench in data["benchmarks"]:
+        if bench.get("run_type", "iteration") != "iteration":
+            continue
+
+        if "error_occurred" in bench and bench["error_occurred"]:
+            continue
+
+        name = bench.get("run_name", bench["name"])
+
+        # Our parallel benchmarks report their worker count as a counter.
+        threads = int(bench.get("green_threads", bench.get("threads", 1)) + 0.5)
+
+        value = bench[args.metric]
+
+        if args.metric.endswith("_time"):
+            value *= unit[bench.get("time_unit", "ns")]
+
+        samples.setdefault(name, (threads, []))[1].append(value)
+
+    return samples
+
+
+@lru_cache(maxsize=None)
+def arrangements(n, m, u):
+    """
+    The number of orderings of n x's and m y's in which exactly u (x, y) pairs have x > y.
+    """
+    if u < 0 or u > n * m:
+        return 0
+    if n == 0 or m == 0:
+        return 1 if u == 0 else 0
+    # Either the largest element is an x (beating all m y's) or it is a y.
+    return arrangements(n - 1, m, u - m) + arrangements(n, m - 1, u)
+
+
+def mann_whitney(x, y):
+    """
+    Two-sided Mann-Whitney U test, returns the p-value for the null hypothesis that x and y have the same
+    distribution. Exact for small untied samples, otherwise uses the tie-corrected normal approximation.
+    """
+    n, m = len(x), len(y)
+
+    pooled = sorted([(v, 0) for v in x] + [(v, 1) for v in y])
+
+    # Assign mid-ranks to ties.
+    ranks = [0.0] * len(pooled)
+    ties = []
+    i = 0
+    while i < len(pooled):
+        j = i
+        while j + 1 < len(pooled) and pooled[j + 1][0] == pooled[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2 + 1
+        ties.append(j - i + 1)
+        i = j + 1
+
+    r_x = sum(r for r, (_, g) in zip(ranks, pooled) if g == 0)
+
+    u = r_x - n * (n + 1) / 2
+    mean_u = n * m / 2
+
+    if all(t == 1 for t in ties) and n <= 30 and m <= 30:
+        total = math.comb(n + m, n)
+        lo = sum(arrangements(n, m, k) for k in range(0, int(u) + 1)) / total
+        hi = sum(arrangements(n, m, k) for k in range(int(u), n * m + 1)) / total
+        return min(1.0, 2 * min(lo, hi))
+
+    N = n + m
+    var_u = n * m / 12 * ((N + 1) - sum(t**3 - t for t in ties) / (N * (N - 1)))
+
+    if var_u <= 0:
+        return 1.0
+
+    z = (abs(u - mean_u) - 0.5) / math.sqrt(var_u)
+
+    return min(1.0, math.erfc(max(z, 0) / math.sqrt(2)))
+
+
+def pretty(ns):
+    for suffix, scale in [("s", 1e9), ("ms", 1e6), ("us", 1e3)]:
+        if ns >= scale:
+            return f"{ns / scale:.3g}{suffix}"
+    return f"{ns:.3g}ns"
+
+
+if args.save:
+    run(args.baseline)
+    print(f"Saved baseline to {args.baseline}", file=sys.stderr)
+    sys.exit(0)
+
+if args.contender is not None:
+    new = load(args.contender)
+else:
+    with tempfile.NamedTemporaryFile(suffix=".json") as tmp:
+        run(tmp.name)
+        new = load(tmp.name)
+
+old = load(args.baseline)
+
+fmt = "{:<60} {:>7} {:>9} {:>9} {:>8} {:>8}  {}"
+
+print(fmt.format("benchmark", "threads", "baseline", "new", "change", "p", "verdict"))
+
+regressions = 0
+
+higher_is_better = args.higher_is_better or args.metric.endswith("per_second")
+
+for name in sorted(set(old) | set(new), key=lambda k: (old.get(k, new.get(k))[0], k)):
+    if name not in old or name not in new:
+        print(fmt.format(name, "", "", "", "", "", "missing in " + ("baseline" if name in new else "new")))
+        continue
+
+    threads, x = old[name]
+    _, y = new[name]
+
+    base, cont = median(x), median(y)
+
+    change = cont / base - 1 if base != 0 else 0.0
+
+    if len(x) < 2 or len(y) < 2:
+        p = math.nan
+        verdict = "too few repetitions"
+    else:
+        p = mann_whitney(x, y)
+
+        if p >= args.alpha or abs(change) < args.threshold:
+            verdict = ""
+        elif (change > 0) != higher_is_better:
+            verdict = "REGRESSION"
+            regressions += 1
+        else:
+            verdict = "improved"
+
+    value = pretty if args.metric.endswith("_time") else (lambda v: f"{v:.4g}")
+
+    print(fmt.format(name, threads, value(base), value(cont), f"{100 * change:+.1f}%", f"{p:.3f}", verdict))
+
+print(f"\n{regressions} regression(s) at alpha = {args.alpha}, threshold = {100 * args.threshold:.0f}%")
+
+sys.exit(1 if regressions > 0 else 0)
@@ -0,0 +1,154 @@
+#ifndef E2A9C6F1_4D83_4B7A_9C52_1F6E8D3B0A47
+#define E2A9C6F1_4D83_4B7A_9C52_1F6E8D3B0A47
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include "../util.hpp"
+
+/**
+ * Memory-bound benchmarks of the algorithm layer, swept over working-set sizes from the L1 cache to ten
+ * times the last-level cache. Every variant reports the bandwidth it achieved, assuming each element is
+ * moved to/from memory exactly once per pass.
+ */
+
+using elem_t = std::uint32_t;
+
+/**
+ * @brief The size of a cache level in bytes or, `fallback` if the OS does not know.
+ */
+inline auto cache_bytes(int name, long fallback) -> std::size_t {
+  long bytes = sysconf(name);
+  return static_cast<std::size_t>(bytes > 0 ? bytes : fallback);
+}
+
+/**
+ * @brief Element counts from L1 up to 10x the last-level cache, growing by a factor of four.
+ */
+inline auto algo_sizes() -> std::vector<std::int64_t> {
+
+  std::size_t l1 = cache_bytes(_SC_LEVEL1_DCACHE_SIZE, 32 * 1024);
+
+  std::size_t llc = std::max({
+      cache_bytes(_SC_LEVEL2_CACHE_SIZE, 0),
+      cache_bytes(_SC_LEVEL3_CACHE_SIZE, 0),
+      std::size_t{32} * 1024 * 1024,
+  });
+
+  std::vector<std::int64_t> out;
+
+  for (std::size_t bytes = l1; bytes < 10 * llc; bytes *= 4) {
+    out.push_back(static_cast<std::int64_t>(bytes / sizeof(elem_t)));
+  }
+
+  out.push_back(static_cast<std::int64_t>(10 * llc / sizeof(elem_t)));
+
+  return out;
+}
+
+/**
+ * @brief Serial benchmarks, `range(0)` is the number of elements.
+ */
+inline void algo_sizes_args(benchmark::internal::Benchmark *bench) {
+  for (std::int64_t n : algo_sizes()) {
+    bench->Arg(n);
+  }
+}
+
+/**
+ * @brief Parallel benchmarks, `range(0)` is the number of threads and `range(1)` the number of elements.
+ */
+inline void algo_args(benchmark::internal::Benchmark *bench) {
+  for (int t : thread_counts()) {
+    for (std::int64_t n : algo_sizes()) {
+      bench->Args({t, n});
+    }
+  }
+}
+
+/**
+ * @brief The grain size used by every parallel variant, a few chunks per thread.
+ */
+inline auto algo_chunk(std::size_t n, std::size_t threads) -> std::size_t {
+  return std::max<std::size_t>(n / (8 * threads), 1024);
+}
+
+/**
+ * @brief Set the standard counters, `passes` is the number of arrays each element touches.
+ */
+inline void algo_counters(benchmark::State &state, std::size_t threads, std::size_t n, std::size_t passes) {
+
+  state.counters["green_threads"] = static_cast<double>(threads);
+  state.counters["n"] = static_cast<double>(n);
+  state.counters["bytes"] = static_cast<double>(n * sizeof(elem_t));
+
+  state.counters["GB"] = benchmark::Counter(static_cast<double>(passes * n * sizeof(elem_t)) / 1e9,
+                                              benchmark::Counter::kIsIterationInvariantRate);
+}
+
+/**
+ * @brief The input `1, 2, ..., n`.
+ */
+inline auto algo_init(std::size_t n) -> std::vector<elem_t> {
+  std::vector<elem_t> out(n);
+  std::iota(out.begin(), out.end(), elem_t{1});
+  return out;
+}
+
+// ------------------------------- Operations ------------------------------- //
+
+inline constexpr auto algo_inc = [](elem_t &x) {
+  x += 1;
+};
+
+inline constexpr auto algo_map = [](elem_t x) -> elem_t {
+  return 2 * x + 1;
+};
+
+// ------------------------------- Verification ------------------------------- //
+
+/**
+ * @brief After `reps` passes of `algo_inc` over `algo_init`.
+ */
+inline auto check_for_each(std::vector<elem_t> const &v, std::int64_t reps) -> bool {
+  for (std::size_t i = 0; i < v.size(); i++) {
+    if (v[i] != static_cast<elem_t>(i + 1 + static_cast<std::size_t>(reps))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline auto check_map(std::vector<elem_t> const &in, std::vector<elem_t> const &out) -> bool {
+  for (std::size_t i = 0; i < in.size(); i++) {
+    if (out[i] != algo_map(in[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline auto check_fold(std::vector<elem_t> const &in, elem_t sum) -> bool {
+  return sum == std::accumulate(in.begin(), in.end(), elem_t{0});
+}
+
+inline auto check_scan(std::vector<elem_t> const &in, std::vector<elem_t> const &out) -> bool {
+
+  elem_t sum = 0;
+
+  for (std::size_t i = 0; i < in.size(); i++) {
+    if (out[i] != (sum += in[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#endif /* E2A9C6F1_4D83_4B7A_9C52_1F6E8D3B0A47 */
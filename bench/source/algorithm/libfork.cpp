@@ -0,0 +1,145 @@
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <libfork.hpp>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+template <lf::scheduler Sch>
+auto make_sched(benchmark::State &state) -> Sch {
+  if constexpr (std::constructible_from<Sch, int>) {
+    return Sch(state.range(0));
+  } else {
+    return Sch{};
+  }
+}
+
+template <lf::scheduler Sch, lf::numa_strategy Strategy>
+void algo_for_each_libfork(benchmark::State &state) {
+
+  auto t = static_cast<std::size_t>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+  auto chunk = static_cast<std::ptrdiff_t>(algo_chunk(n, t));
+
+  algo_counters(state, t, n, 2);
+
+  Sch sch = make_sched<Sch>(state);
+
+  peak_memory mem{state, sch};
+
+  std::vector in = lf::sync_wait(sch, lf::lift, algo_init, n);
+
+  for (auto _ : state) {
+    lf::sync_wait(sch, lf::for_each, in, chunk, algo_inc);
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_for_each(in, state.iterations())) {
+    std::cerr << "lf for_each wrong answer" << std::endl;
+  }
+#endif
+}
+
+template <lf::scheduler Sch, lf::numa_strategy Strategy>
+void algo_map_libfork(benchmark::State &state) {
+
+  auto t = static_cast<std::size_t>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+  auto chunk = static_cast<std::ptrdiff_t>(algo_chunk(n, t));
+
+  algo_counters(state, t, n, 2);
+
+  Sch sch = make_sched<Sch>(state);
+
+  peak_memory mem{state, sch};
+
+  std::vector in = lf::sync_wait(sch, lf::lift, algo_init, n);
+  std::vector out = lf::sync_wait(sch, lf::lift, algo_init, n);
+
+  for (auto _ : state) {
+    lf::sync_wait(sch, lf::map, in, out.begin(), chunk, algo_map);
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_map(in, out)) {
+    std::cerr << "lf map wrong answer" << std::endl;
+  }
+#endif
+}
+
+template <lf::scheduler Sch, lf::numa_strategy Strategy>
+void algo_fold_libfork(benchmark::State &state) {
+
+  auto t = static_cast<std::size_t>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+  auto chunk = static_cast<std::ptrdiff_t>(algo_chunk(n, t));
+
+  algo_counters(state, t, n, 1);
+
+  Sch sch = make_sched<Sch>(state);
+
+  peak_memory mem{state, sch};
+
+  std::vector in = lf::sync_wait(sch, lf::lift, algo_init, n);
+
+  elem_t sum = 0;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sum = *lf::sync_wait(sch, lf::fold, in, chunk, std::plus<>{}));
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_fold(in, sum)) {
+    std::cerr << "lf fold wrong answer" << std::endl;
+  }
+#endif
+}
+
+template <lf::scheduler Sch, lf::numa_strategy Strategy>
+void algo_scan_libfork(benchmark::State &state) {
+
+  auto t = static_cast<std::size_t>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+  auto chunk = static_cast<std::ptrdiff_t>(algo_chunk(n, t));
+
+  algo_counters(state, t, n, 2);
+
+  Sch sch = make_sched<Sch>(state);
+
+  peak_memory mem{state, sch};
+
+  std::vector in = lf::sync_wait(sch, lf::lift, algo_init, n);
+  std::vector out = lf::sync_wait(sch, lf::lift, algo_init, n);
+
+  for (auto _ : state) {
+    lf::sync_wait(sch, lf::scan, in, out.begin(), chunk, std::plus<>{});
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_scan(in, out)) {
+    std::cerr << "lf scan wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+using namespace lf;
+
+BENCHMARK(algo_for_each_libfork<lazy_pool, numa_strategy::fan>)->Apply(algo_args)->UseRealTime();
+BENCHMARK(algo_for_each_libfork<busy_pool, numa_strategy::fan>)->Apply(algo_args)->UseRealTime();
+
+BENCHMARK(algo_map_libfork<lazy_pool, numa_strategy::fan>)->Apply(algo_args)->UseRealTime();
+BENCHMARK(algo_map_libfork<busy_pool, numa_strategy::fan>)->Apply(algo_args)->UseRealTime();
+
+BENCHMARK(algo_fold_libfork<lazy_pool, numa_strategy::fan>)->Apply(algo_args)->UseRealTime();
+BENCHMARK(algo_fold_libfork<busy_pool, numa_strategy::fan>)->Apply(algo_args)->UseRealTime();
+
+BENCHMARK(algo_scan_libfork<lazy_pool, numa_strategy::fan>)->Apply(algo_args)->UseRealTime();
+BENCHMARK(algo_scan_libfork<busy_pool, numa_strategy::fan>)->Apply(algo_args)->UseRealTime();
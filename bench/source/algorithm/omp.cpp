@@ -0,0 +1,130 @@
+#include <iostream>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+void algo_for_each_omp(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto t = static_cast<int>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+
+  algo_counters(state, t, n, 2);
+
+  std::vector in = algo_init(n);
+
+  for (auto _ : state) {
+#pragma omp parallel for num_threads(t) schedule(static)
+    for (std::size_t i = 0; i < n; ++i) {
+      algo_inc(in[i]);
+    }
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_for_each(in, state.iterations())) {
+    std::cerr << "omp for_each wrong answer" << std::endl;
+  }
+#endif
+}
+
+void algo_map_omp(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto t = static_cast<int>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+
+  algo_counters(state, t, n, 2);
+
+  std::vector in = algo_init(n);
+  std::vector out = std::vector<elem_t>(n);
+
+  for (auto _ : state) {
+#pragma omp parallel for num_threads(t) schedule(static)
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = algo_map(in[i]);
+    }
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_map(in, out)) {
+    std::cerr << "omp map wrong answer" << std::endl;
+  }
+#endif
+}
+
+void algo_fold_omp(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto t = static_cast<int>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+
+  algo_counters(state, t, n, 1);
+
+  std::vector in = algo_init(n);
+
+  elem_t sum = 0;
+
+  for (auto _ : state) {
+
+    elem_t acc = 0;
+
+#pragma omp parallel for num_threads(t) schedule(static) reduction(+ : acc)
+    for (std::size_t i = 0; i < n; ++i) {
+      acc += in[i];
+    }
+
+    benchmark::DoNotOptimize(sum = acc);
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_fold(in, sum)) {
+    std::cerr << "omp fold wrong answer" << std::endl;
+  }
+#endif
+}
+
+void algo_scan_omp(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto t = static_cast<int>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+
+  algo_counters(state, t, n, 2);
+
+  std::vector in = algo_init(n);
+  std::vector out = std::vector<elem_t>(n);
+
+  for (auto _ : state) {
+
+    elem_t acc = 0;
+
+#pragma omp parallel for num_threads(t) reduction(inscan, + : acc)
+    for (std::size_t i = 0; i < n; ++i) {
+      acc += in[i];
+#pragma omp scan inclusive(acc)
+      out[i] = acc;
+    }
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_scan(in, out)) {
+    std::cerr << "omp scan wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(algo_for_each_omp)->Apply(algo_args)->UseRealTime();
+BENCHMARK(algo_map_omp)->Apply(algo_args)->UseRealTime();
+BENCHMARK(algo_fold_omp)->Apply(algo_args)->UseRealTime();
+BENCHMARK(algo_scan_omp)->Apply(algo_args)->UseRealTime();
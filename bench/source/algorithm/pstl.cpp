@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <execution>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <tbb/task_arena.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+// The parallel STL (libstdc++/libc++ with the TBB backend) runs in the calling thread's task arena.
+
+namespace {
+
+void algo_for_each_pstl(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto t = static_cast<std::size_t>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+
+  algo_counters(state, t, n, 2);
+
+  tbb::task_arena arena(static_cast<int>(t));
+
+  std::vector in = algo_init(n);
+
+  for (auto _ : state) {
+    arena.execute([&] {
+      std::for_each(std::execution::par, in.begin(), in.end(), algo_inc);
+    });
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_for_each(in, state.iterations())) {
+    std::cerr << "pstl for_each wrong answer" << std::endl;
+  }
+#endif
+}
+
+void algo_map_pstl(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto t = static_cast<std::size_t>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+
+  algo_counters(state, t, n, 2);
+
+  tbb::task_arena arena(static_cast<int>(t));
+
+  std::vector in = algo_init(n);
+  std::vector out = std::vector<elem_t>(n);
+
+  for (auto _ : state) {
+    arena.execute([&] {
+      std::transform(std::execution::par, in.begin(), in.end(), out.begin(), algo_map);
+    });
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_map(in, out)) {
+    std::cerr << "pstl map wrong answer" << std::endl;
+  }
+#endif
+}
+
+void algo_fold_pstl(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto t = static_cast<std::size_t>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+
+  algo_counters(state, t, n, 1);
+
+  tbb::task_arena arena(static_cast<int>(t));
+
+  std::vector in = algo_init(n);
+
+  elem_t sum = 0;
+
+  for (auto _ : state) {
+    sum = arena.execute([&] {
+      return std::reduce(std::execution::par, in.begin(), in.end(), elem_t{0});
+    });
+    benchmark::DoNotOptimize(sum);
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_fold(in, sum)) {
+    std::cerr << "pstl fold wrong answer" << std::endl;
+  }
+#endif
+}
+
+void algo_scan_pstl(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto t = static_cast<std::size_t>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+
+  algo_counters(state, t, n, 2);
+
+  tbb::task_arena arena(static_cast<int>(t));
+
+  std::vector in = algo_init(n);
+  std::vector out = std::vector<elem_t>(n);
+
+  for (auto _ : state) {
+    arena.execute([&] {
+      std::inclusive_scan(std::execution::par, in.begin(), in.end(), out.begin());
+    });
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_scan(in, out)) {
+    std::cerr << "pstl scan wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(algo_for_each_pstl)->Apply(algo_args)->UseRealTime();
+BENCHMARK(algo_map_pstl)->Apply(algo_args)->UseRealTime();
+BENCHMARK(algo_fold_pstl)->Apply(algo_args)->UseRealTime();
+BENCHMARK(algo_scan_pstl)->Apply(algo_args)->UseRealTime();
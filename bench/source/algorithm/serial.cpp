@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+void algo_for_each_serial(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto n = static_cast<std::size_t>(state.range(0));
+
+  algo_counters(state, 1, n, 2);
+
+  std::vector in = algo_init(n);
+
+  for (auto _ : state) {
+    std::ranges::for_each(in, algo_inc);
+    benchmark::ClobberMemory();
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_for_each(in, state.iterations())) {
+    std::cerr << "serial for_each wrong answer" << std::endl;
+  }
+#endif
+}
+
+void algo_map_serial(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto n = static_cast<std::size_t>(state.range(0));
+
+  algo_counters(state, 1, n, 2);
+
+  std::vector in = algo_init(n);
+  std::vector out = std::vector<elem_t>(n);
+
+  for (auto _ : state) {
+    std::ranges::transform(in, out.begin(), algo_map);
+    benchmark::ClobberMemory();
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_map(in, out)) {
+    std::cerr << "serial map wrong answer" << std::endl;
+  }
+#endif
+}
+
+void algo_fold_serial(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto n = static_cast<std::size_t>(state.range(0));
+
+  algo_counters(state, 1, n, 1);
+
+  std::vector in = algo_init(n);
+
+  elem_t sum = 0;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sum = std::reduce(in.begin(), in.end(), elem_t{0}));
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_fold(in, sum)) {
+    std::cerr << "serial fold wrong answer" << std::endl;
+  }
+#endif
+}
+
+void algo_scan_serial(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto n = static_cast<std::size_t>(state.range(0));
+
+  algo_counters(state, 1, n, 2);
+
+  std::vector in = algo_init(n);
+  std::vector out = std::vector<elem_t>(n);
+
+  for (auto _ : state) {
+    std::inclusive_scan(in.begin(), in.end(), out.begin());
+    benchmark::ClobberMemory();
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_scan(in, out)) {
+    std::cerr << "serial scan wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(algo_for_each_serial)->Apply(algo_sizes_args)->UseRealTime();
+BENCHMARK(algo_map_serial)->Apply(algo_sizes_args)->UseRealTime();
+BENCHMARK(algo_fold_serial)->Apply(algo_sizes_args)->UseRealTime();
+BENCHMARK(algo_scan_serial)->Apply(algo_sizes_args)->UseRealTime();
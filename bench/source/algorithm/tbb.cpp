@@ -0,0 +1,161 @@
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/parallel_scan.h>
+#include <tbb/task_arena.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+using range = tbb::blocked_range<std::size_t>;
+
+void algo_for_each_tbb(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto t = static_cast<std::size_t>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+
+  algo_counters(state, t, n, 2);
+
+  tbb::task_arena arena(static_cast<int>(t));
+
+  std::vector in = algo_init(n);
+
+  for (auto _ : state) {
+    arena.execute([&] {
+      tbb::parallel_for(range(0, n, algo_chunk(n, t)), [&](range const &r) {
+        for (std::size_t i = r.begin(); i < r.end(); ++i) {
+          algo_inc(in[i]);
+        }
+      });
+    });
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_for_each(in, state.iterations())) {
+    std::cerr << "tbb for_each wrong answer" << std::endl;
+  }
+#endif
+}
+
+void algo_map_tbb(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto t = static_cast<std::size_t>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+
+  algo_counters(state, t, n, 2);
+
+  tbb::task_arena arena(static_cast<int>(t));
+
+  std::vector in = algo_init(n);
+  std::vector out = std::vector<elem_t>(n);
+
+  for (auto _ : state) {
+    arena.execute([&] {
+      tbb::parallel_for(range(0, n, algo_chunk(n, t)), [&](range const &r) {
+        for (std::size_t i = r.begin(); i < r.end(); ++i) {
+          out[i] = algo_map(in[i]);
+        }
+      });
+    });
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_map(in, out)) {
+    std::cerr << "tbb map wrong answer" << std::endl;
+  }
+#endif
+}
+
+void algo_fold_tbb(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto t = static_cast<std::size_t>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+
+  algo_counters(state, t, n, 1);
+
+  tbb::task_arena arena(static_cast<int>(t));
+
+  std::vector in = algo_init(n);
+
+  elem_t sum = 0;
+
+  for (auto _ : state) {
+    sum = arena.execute([&] {
+      return tbb::parallel_reduce(
+          range(0, n, algo_chunk(n, t)),
+          elem_t{0},
+          [&](range const &r, elem_t acc) {
+            for (std::size_t i = r.begin(); i < r.end(); ++i) {
+              acc += in[i];
+            }
+            return acc;
+          },
+          std::plus<>{});
+    });
+    benchmark::DoNotOptimize(sum);
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_fold(in, sum)) {
+    std::cerr << "tbb fold wrong answer" << std::endl;
+  }
+#endif
+}
+
+void algo_scan_tbb(benchmark::State &state) {
+
+  peak_memory mem{state};
+
+  auto t = static_cast<std::size_t>(state.range(0));
+  auto n = static_cast<std::size_t>(state.range(1));
+
+  algo_counters(state, t, n, 2);
+
+  tbb::task_arena arena(static_cast<int>(t));
+
+  std::vector in = algo_init(n);
+  std::vector out = std::vector<elem_t>(n);
+
+  auto body = [&](range const &r, elem_t sum, bool is_final_scan) {
+    for (std::size_t i = r.begin(); i < r.end(); ++i) {
+      sum += in[i];
+      if (is_final_scan) {
+        out[i] = sum;
+      }
+    }
+    return sum;
+  };
+
+  for (auto _ : state) {
+    arena.execute([&] {
+      tbb::parallel_scan(range(0, n, algo_chunk(n, t)), elem_t{0}, body, std::plus<>{});
+    });
+  }
+
+#ifndef LF_NO_CHECK
+  if (!check_scan(in, out)) {
+    std::cerr << "tbb scan wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(algo_for_each_tbb)->Apply(algo_args)->UseRealTime();
+BENCHMARK(algo_map_tbb)->Apply(algo_args)->UseRealTime();
+BENCHMARK(algo_fold_tbb)->Apply(algo_args)->UseRealTime();
+BENCHMARK(algo_scan_tbb)->Apply(algo_args)->UseRealTime();
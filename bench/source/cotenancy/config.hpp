@@ -0,0 +1,43 @@
+#ifndef B4E91C27_5D3A_4F68_8B02_7C1E6A9D3F45
+#define B4E91C27_5D3A_4F68_8B02_7C1E6A9D3F45
+
+#include <cstddef>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+/**
+ * K independent pools, each sized to every hardware thread, run the same job concurrently from K external
+ * threads. Ideally each pool gets 1/K of the machine: idle workers must get out of the way of the other
+ * pools' busy workers rather than spinning/stealing, this exercises the sleeping logic of the pools.
+ */
+
+inline constexpr int cotenancy_fib = 36; // fib(n) per pool.
+inline constexpr int cotenancy_uts = 11; // T1 per pool.
+
+/**
+ * @brief The number of co-tenant pools.
+ */
+inline void cotenancy_args(benchmark::internal::Benchmark *bench) {
+  for (int k : {1, 2, 3, 4}) {
+    bench->Arg(k);
+  }
+}
+
+/**
+ * @brief Jain's fairness index of `x`, 1 if all equal down to 1/n if one element holds everything.
+ */
+inline auto jain_index(std::vector<double> const &x) -> double {
+
+  double sum = 0;
+  double sum_sq = 0;
+
+  for (double elem : x) {
+    sum += elem;
+    sum_sq += elem * elem;
+  }
+
+  return sum_sq == 0 ? 1 : sum * sum / (static_cast<double>(x.size()) * sum_sq);
+}
+
+#endif /* B4E91C27_5D3A_4F68_8B02_7C1E6A9D3F45 */
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <libfork.hpp>
+
+#include "../fib/config.hpp"
+#include "../fib/kernel.hpp"
+#include "../micro/team.hpp"
+#include "../util.hpp"
+#include "../uts/config.hpp"
+#include "../uts/kernel.hpp"
+#include "config.hpp"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+/**
+ * @brief Run `job(pool)` on `range(0)` pools at once, each pool is driven by its own external thread.
+ *
+ * Throughput is reported as jobs/s. The fairness is Jain's index of the per-pool rates (one over the time
+ * each pool took to finish its job) and the spread is the ratio of the slowest to the fastest pool.
+ */
+template <typename Sch, lf::numa_strategy Strategy, typename Job>
+void cotenants(benchmark::State &state, Job const &job) {
+
+  auto k = static_cast<std::size_t>(state.range(0));
+
+  state.counters["pools"] = static_cast<double>(k);
+  state.counters["green_threads"] = num_threads();
+
+  std::vector<std::unique_ptr<Sch>> pools;
+
+  for (std::size_t i = 0; i < k; ++i) {
+    pools.push_back(std::make_unique<Sch>(static_cast<std::size_t>(num_threads()), Strategy));
+  }
+
+  peak_memory mem{state};
+
+  team drivers(k);
+
+  std::vector<double> finish(k);
+  std::vector<double> rate(k);
+
+  double fairness = 0;
+  double spread = 0;
+
+  for (auto _ : state) {
+
+    auto start = clock_type::now();
+
+    drivers.run(
+        [&](std::size_t i) {
+          job(*pools[i]);
+          finish[i] = std::chrono::duration<double>(clock_type::now() - start).count();
+        },
+        [] {});
+
+    std::ranges::transform(finish, rate.begin(), [](double time) {
+      return 1 / time;
+    });
+
+    auto [fastest, slowest] = std::ranges::minmax(finish);
+
+    fairness += jain_index(rate);
+    spread += slowest / fastest;
+  }
+
+  auto iter = static_cast<double>(std::max<benchmark::IterationCount>(1, state.iterations()));
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * k));
+
+  state.counters["fairness"] = fairness / iter;
+  state.counters["spread"] = spread / iter;
+}
+
+template <lf::scheduler Sch, lf::numa_strategy Strategy>
+void cotenancy_fib_libfork(benchmark::State &state) {
+
+  state.counters["fib(n)"] = cotenancy_fib;
+
+  cotenants<Sch, Strategy>(state, [](Sch &sch) {
+    volatile int secret = cotenancy_fib;
+
+    [[maybe_unused]] int output = lf::sync_wait(sch, fib, secret);
+
+#ifndef LF_NO_CHECK
+    if (output != sfib(cotenancy_fib)) {
+      std::cerr << "lf cotenancy fib wrong answer" << std::endl;
+    }
+#endif
+  });
+}
+
+template <lf::scheduler Sch, lf::numa_strategy Strategy>
+void cotenancy_uts_libfork(benchmark::State &state) {
+
+  setup_tree(cotenancy_uts);
+
+  cotenants<Sch, Strategy>(state, [](Sch &sch) {
+    volatile int depth = 0;
+    Node root;
+
+    uts_initRoot(&root, type);
+
+    [[maybe_unused]] result r = lf::sync_wait(sch, uts, depth, &root);
+
+#ifndef LF_NO_CHECK
+    if (r != result_tree(cotenancy_uts)) {
+      std::cerr << "lf cotenancy uts wrong answer" << std::endl;
+    }
+#endif
+  });
+}
+
+} // namespace
+
+using namespace lf;
+
+BENCHMARK(cotenancy_fib_libfork<lazy_pool, numa_strategy::seq>)->Apply(cotenancy_args)->UseRealTime();
+BENCHMARK(cotenancy_fib_libfork<lazy_pool, numa_strategy::fan>)->Apply(cotenancy_args)->UseRealTime();
+BENCHMARK(cotenancy_fib_libfork<busy_pool, numa_strategy::seq>)->Apply(cotenancy_args)->UseRealTime();
+
+BENCHMARK(cotenancy_uts_libfork<lazy_pool, numa_strategy::seq>)->Apply(cotenancy_args)->UseRealTime();
+BENCHMARK(cotenancy_uts_libfork<lazy_pool, numa_strategy::fan>)->Apply(cotenancy_args)->UseRealTime();
+BENCHMARK(cotenancy_uts_libfork<busy_pool, numa_strategy::seq>)->Apply(cotenancy_args)->UseRealTime();
@@ -0,0 +1,118 @@
+#ifndef C1E8A5F3_7D24_4B96_A0C7_9B2F6E4D1A38
+#define C1E8A5F3_7D24_4B96_A0C7_9B2F6E4D1A38
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <numbers>
+#include <random>
+#include <vector>
+
+/**
+ * A recursive, out-of-place, radix-2 Cooley-Tukey FFT after the BOTS fft kernel.
+ *
+ * The transforms of the even/odd halves are independent and the butterflies of each level are split
+ * recursively hence, the task graph is a tree of trees with little work per task.
+ */
+
+inline constexpr std::size_t fft_work = std::size_t{1} << 22;
+inline constexpr std::size_t fft_cutoff = 1024;
+
+static_assert(std::has_single_bit(fft_work));
+
+using complex = std::complex<double>;
+
+/**
+ * @brief Twiddle factors `w^k = exp(-2 pi i k / N)` for `0 <= k < N / 2`.
+ *
+ * A sub-transform of size `n` uses every `N / n`-th factor.
+ */
+struct twiddles {
+
+  explicit twiddles(std::size_t n) : size(n), w(n / 2) {
+    for (std::size_t k = 0; k < n / 2; k++) {
+      w[k] = std::polar(1.0, -2 * std::numbers::pi * static_cast<double>(k) / static_cast<double>(n));
+    }
+  }
+
+  std::size_t size;
+  std::vector<complex> w;
+};
+
+/**
+ * @brief Combine the two half-transforms in `out[0, n/2)` and `out[n/2, n)`, butterflies `[lo, hi)` only.
+ */
+inline void fft_butterfly(complex *out, std::size_t n, std::size_t lo, std::size_t hi, twiddles const &tw) {
+
+  std::size_t step = tw.size / n;
+  std::size_t half = n / 2;
+
+  for (std::size_t k = lo; k < hi; k++) {
+    complex t = tw.w[k * step] * out[k + half];
+    out[k + half] = out[k] - t;
+    out[k] = out[k] + t;
+  }
+}
+
+/**
+ * @brief Transform the `n` elements `in[0], in[s], in[2s], ...` into `out[0, n)`.
+ */
+inline void fft_seq(complex const *in, complex *out, std::size_t n, std::size_t s, twiddles const &tw) {
+
+  if (n == 1) {
+    out[0] = in[0];
+    return;
+  }
+
+  fft_seq(in, out, n / 2, 2 * s, tw);
+  fft_seq(in + s, out + n / 2, n / 2, 2 * s, tw);
+
+  fft_butterfly(out, n, 0, n / 2, tw);
+}
+
+struct fft_args {
+  std::vector<complex> in;
+  std::vector<complex> out;
+  twiddles tw;
+};
+
+inline auto fft_init(std::size_t n = fft_work) -> fft_args {
+
+  std::mt19937_64 rng{42};
+  std::uniform_real_distribution<double> dist{-1, 1};
+
+  fft_args args{std::vector<complex>(n), std::vector<complex>(n), twiddles{n}};
+
+  for (auto &elem : args.in) {
+    elem = {dist(rng), dist(rng)};
+  }
+
+  return args;
+}
+
+/**
+ * @brief Compare a sample of the output bins with a direct DFT.
+ */
+inline auto fft_check(fft_args const &args) -> bool {
+
+  std::size_t n = args.in.size();
+
+  for (std::size_t k : {std::size_t{0}, std::size_t{1}, n / 3, n / 2, n - 1}) {
+
+    complex sum = 0;
+
+    for (std::size_t j = 0; j < n; j++) {
+      sum += args.in[j] * args.tw.w[(j * k) % n % (n / 2)] * ((j * k) % n >= n / 2 ? -1.0 : 1.0);
+    }
+
+    if (std::abs(sum - args.out[k]) > 1e-6 * std::max(1.0, std::abs(sum))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+#endif /* C1E8A5F3_7D24_4B96_A0C7_9B2F6E4D1A38 */
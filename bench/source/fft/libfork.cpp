@@ -0,0 +1,90 @@
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include <libfork.hpp>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+using namespace lf;
+
+constexpr auto butterfly = [](auto butterfly,
+                              complex *out,
+                              std::size_t n,
+                              std::size_t lo,
+                              std::size_t hi,
+                              twiddles const &tw) LF_STATIC_CALL -> task<> {
+  //
+  if (hi - lo <= fft_cutoff) {
+    co_return fft_butterfly(out, n, lo, hi, tw);
+  }
+
+  std::size_t mid = lo + (hi - lo) / 2;
+
+  co_await lf::fork(butterfly)(out, n, lo, mid, tw);
+  co_await lf::call(butterfly)(out, n, mid, hi, tw);
+
+  co_await lf::join;
+};
+
+constexpr auto fft = [](auto fft,
+                        complex const *in,
+                        complex *out,
+                        std::size_t n,
+                        std::size_t s,
+                        twiddles const &tw) LF_STATIC_CALL -> task<> {
+  //
+  if (n <= fft_cutoff) {
+    co_return fft_seq(in, out, n, s, tw);
+  }
+
+  co_await lf::fork(fft)(in, out, n / 2, 2 * s, tw);
+  co_await lf::call(fft)(in + s, out + n / 2, n / 2, 2 * s, tw);
+
+  co_await lf::join;
+
+  co_await lf::call(butterfly)(out, n, 0, n / 2, tw);
+  co_await lf::join;
+};
+
+template <lf::scheduler Sch, lf::numa_strategy Strategy>
+void fft_libfork(benchmark::State &state) {
+
+  state.counters["green_threads"] = state.range(0);
+  state.counters["fft(n)"] = fft_work;
+
+  Sch sch = [&] {
+    if constexpr (std::constructible_from<Sch, int>) {
+      return Sch(state.range(0));
+    } else {
+      return Sch{};
+    }
+  }();
+
+  peak_memory mem{state, sch};
+
+  auto args = lf::sync_wait(sch, lf::lift, fft_init, fft_work);
+
+  for (auto _ : state) {
+    lf::sync_wait(sch, fft, args.in.data(), args.out.data(), args.in.size(), 1, args.tw);
+  }
+
+#ifndef LF_NO_CHECK
+  if (!fft_check(args)) {
+    std::cerr << "lf wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+using namespace lf;
+
+BENCHMARK(fft_libfork<lazy_pool, numa_strategy::seq>)->Apply(targs)->UseRealTime();
+BENCHMARK(fft_libfork<lazy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
+
+BENCHMARK(fft_libfork<busy_pool, numa_strategy::seq>)->Apply(targs)->UseRealTime();
+BENCHMARK(fft_libfork<busy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
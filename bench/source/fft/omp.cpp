@@ -0,0 +1,68 @@
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+void butterfly(complex *out, std::size_t n, std::size_t lo, std::size_t hi, twiddles const &tw) {
+
+  if (hi - lo <= fft_cutoff) {
+    return fft_butterfly(out, n, lo, hi, tw);
+  }
+
+  std::size_t mid = lo + (hi - lo) / 2;
+
+#pragma omp task untied firstprivate(out, n, lo, mid) shared(tw) default(none)
+  butterfly(out, n, lo, mid, tw);
+
+  butterfly(out, n, mid, hi, tw);
+
+#pragma omp taskwait
+}
+
+void fft(complex const *in, complex *out, std::size_t n, std::size_t s, twiddles const &tw) {
+
+  if (n <= fft_cutoff) {
+    return fft_seq(in, out, n, s, tw);
+  }
+
+#pragma omp task untied firstprivate(in, out, n, s) shared(tw) default(none)
+  fft(in, out, n / 2, 2 * s, tw);
+
+  fft(in + s, out + n / 2, n / 2, 2 * s, tw);
+
+#pragma omp taskwait
+
+  butterfly(out, n, 0, n / 2, tw);
+}
+
+void fft_omp(benchmark::State &state) {
+
+  state.counters["green_threads"] = state.range(0);
+  state.counters["fft(n)"] = fft_work;
+
+  peak_memory mem{state};
+
+  std::size_t n = state.range(0);
+
+  auto args = fft_init();
+
+#pragma omp parallel num_threads(n)
+#pragma omp single
+  for (auto _ : state) {
+    fft(args.in.data(), args.out.data(), args.in.size(), 1, args.tw);
+  }
+
+#ifndef LF_NO_CHECK
+  if (!fft_check(args)) {
+    std::cerr << "omp wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(fft_omp)->Apply(targs)->UseRealTime();
@@ -0,0 +1,32 @@
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+void fft_serial(benchmark::State &state) {
+
+  state.counters["green_threads"] = 1;
+  state.counters["fft(n)"] = fft_work;
+
+  peak_memory mem{state};
+
+  auto args = fft_init();
+
+  for (auto _ : state) {
+    fft_seq(args.in.data(), args.out.data(), args.in.size(), 1, args.tw);
+  }
+
+#ifndef LF_NO_CHECK
+  if (!fft_check(args)) {
+    std::cerr << "serial wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(fft_serial)->UseRealTime();
@@ -0,0 +1,78 @@
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+void butterfly(complex *out, std::size_t n, std::size_t lo, std::size_t hi, twiddles const &tw) {
+
+  if (hi - lo <= fft_cutoff) {
+    return fft_butterfly(out, n, lo, hi, tw);
+  }
+
+  std::size_t mid = lo + (hi - lo) / 2;
+
+  tbb::task_group g;
+
+  g.run([=, &tw] {
+    butterfly(out, n, lo, mid, tw);
+  });
+
+  butterfly(out, n, mid, hi, tw);
+
+  g.wait();
+}
+
+void fft(complex const *in, complex *out, std::size_t n, std::size_t s, twiddles const &tw) {
+
+  if (n <= fft_cutoff) {
+    return fft_seq(in, out, n, s, tw);
+  }
+
+  tbb::task_group g;
+
+  g.run([=, &tw] {
+    fft(in, out, n / 2, 2 * s, tw);
+  });
+
+  fft(in + s, out + n / 2, n / 2, 2 * s, tw);
+
+  g.wait();
+
+  butterfly(out, n, 0, n / 2, tw);
+}
+
+void fft_tbb(benchmark::State &state) {
+
+  state.counters["green_threads"] = state.range(0);
+  state.counters["fft(n)"] = fft_work;
+
+  peak_memory mem{state};
+
+  std::size_t n = state.range(0);
+  tbb::task_arena arena(n);
+
+  auto args = fft_init();
+
+  for (auto _ : state) {
+    arena.execute([&] {
+      fft(args.in.data(), args.out.data(), args.in.size(), 1, args.tw);
+    });
+  }
+
+#ifndef LF_NO_CHECK
+  if (!fft_check(args)) {
+    std::cerr << "tbb wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(fft_tbb)->Apply(targs)->UseRealTime();
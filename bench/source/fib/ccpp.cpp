@@ -25,6 +25,8 @@ void fib_ccpp(benchmark::State &state) {
   state.counters["green_threads"] = state.range(0);
   state.counters["fib(n)"] = work;
 
+  peak_memory mem{state};
+
   concurrencpp::runtime_options opt;
   opt.max_cpu_threads = state.range(0);
   concurrencpp::runtime runtime(opt);
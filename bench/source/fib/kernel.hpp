@@ -0,0 +1,24 @@
+#ifndef B4E8D2A6_3C1F_4A7B_9E5D_6F0C2B8A1D37
+#define B4E8D2A6_3C1F_4A7B_9E5D_6F0C2B8A1D37
+
+#include <libfork.hpp>
+
+/**
+ * @brief The libfork fib kernel, shared by the fib and cotenancy benchmarks.
+ */
+inline constexpr auto fib = [](auto fib, int n) LF_STATIC_CALL -> lf::task<int> {
+  if (n < 2) {
+    co_return n;
+  }
+
+  int a, b;
+
+  co_await lf::fork(&a, fib)(n - 1);
+  co_await lf::call(&b, fib)(n - 2);
+
+  co_await lf::join;
+
+  co_return a + b;
+};
+
+#endif /* B4E8D2A6_3C1F_4A7B_9E5D_6F0C2B8A1D37 */
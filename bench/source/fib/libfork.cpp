@@ -2,40 +2,31 @@
 
 #include <libfork.hpp>
 
+#include "../pool.hpp"
 #include "../util.hpp"
 #include "config.hpp"
+#include "kernel.hpp"
 
 namespace {
 
-constexpr auto fib = [](auto fib, int n) LF_STATIC_CALL -> lf::task<int> {
-  if (n < 2) {
-    co_return n;
-  }
-
-  int a, b;
-
-  co_await lf::fork(&a, fib)(n - 1);
-  co_await lf::call(&b, fib)(n - 2);
-
-  co_await lf::join;
-
-  co_return a + b;
-};
-
-template <lf::scheduler Sch, lf::numa_strategy Strategy>
+template <lf::scheduler Sch, lf::numa_strategy Strategy, bool Private = false>
 void fib_libfork(benchmark::State &state) {
 
   state.counters["green_threads"] = state.range(0);
   state.counters["fib(n)"] = work;
 
   Sch sch = [&] {
-    if constexpr (std::constructible_from<Sch, int>) {
+    if constexpr (Private) {
+      return private_deque_pool<Sch>(static_cast<std::size_t>(state.range(0)), Strategy);
+    } else if constexpr (std::constructible_from<Sch, int>) {
       return Sch(state.range(0));
     } else {
       return Sch{};
     }
   }();
 
+  peak_memory mem{state, sch};
+
   volatile int secret = work;
   volatile int output;
 
@@ -61,4 +52,9 @@ BENCHMARK(fib_libfork<lazy_pool, numa_strategy::seq>)->Apply(targs)->UseRealTime
 BENCHMARK(fib_libfork<lazy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
 
 BENCHMARK(fib_libfork<busy_pool, numa_strategy::seq>)->Apply(targs)->UseRealTime();
-BENCHMARK(fib_libfork<busy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
\ No newline at end of file
+BENCHMARK(fib_libfork<busy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
+
+// Receiver-initiated stealing from private deques.
+
+BENCHMARK(fib_libfork<lazy_pool, numa_strategy::fan, true>)->Apply(targs)->UseRealTime();
+BENCHMARK(fib_libfork<busy_pool, numa_strategy::fan, true>)->Apply(targs)->UseRealTime();
\ No newline at end of file
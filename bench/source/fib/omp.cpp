@@ -31,6 +31,8 @@ void fib_omp(benchmark::State &state) {
   state.counters["green_threads"] = state.range(0);
   state.counters["fib(n)"] = work;
 
+  peak_memory mem{state};
+
   std::size_t n = state.range(0);
 
   volatile int secret = work;
@@ -26,6 +26,8 @@ void fib_serial(benchmark::State &state) {
   state.counters["green_threads"] = 1;
   state.counters["fib(n)"] = work;
 
+  peak_memory mem{state};
+
   volatile int secret = work;
   volatile int output = 0;
 
@@ -35,6 +35,8 @@ void fib_ztaskflow(benchmark::State &state) {
   state.counters["green_threads"] = state.range(0);
   state.counters["fib(n)"] = work;
 
+  peak_memory mem{state};
+
   std::size_t n = state.range(0);
   tf::Executor executor(n);
 
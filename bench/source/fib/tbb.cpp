@@ -31,6 +31,8 @@ auto fib(int n) -> int {
 
 void fib_tbb(benchmark::State &state) {
 
+  peak_memory mem{state};
+
   // TBB uses (2MB) stacks by default
   tbb::global_control global_limit(tbb::global_control::thread_stack_size, 8 * 1024 * 1024);
 
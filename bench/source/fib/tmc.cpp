@@ -26,6 +26,8 @@ void fib_tmc(benchmark::State &state) {
   state.counters["green_threads"] = state.range(0);
   state.counters["fib(n)"] = work;
 
+  peak_memory mem{state};
+
   volatile int secret = work;
   volatile int output;
 
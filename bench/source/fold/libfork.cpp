@@ -38,6 +38,8 @@ void fold_libfork(benchmark::State &state) {
     }
   }();
 
+  peak_memory mem{state, sch};
+
   std::vector<unsigned> in = lf::sync_wait(sch, lf::lift, make_vec_fold);
   volatile unsigned sink = 0;
 
@@ -14,6 +14,8 @@ void fold_serial(benchmark::State &state) {
 
   state.counters["fold(n)"] = fold_n;
 
+  peak_memory mem{state};
+
   std::vector<unsigned> in = make_vec_fold();
   volatile unsigned sink = 0;
 
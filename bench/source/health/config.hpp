@@ -0,0 +1,205 @@
+#ifndef B5C9E3A7_2F6D_4A18_9E47_C8D1F0B6A293
+#define B5C9E3A7_2F6D_4A18_9E47_C8D1F0B6A293
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <random>
+#include <vector>
+
+/**
+ * Port of the health kernel from the Barcelona OpenMP Tasks Suite (BOTS).
+ *
+ * Simulates the Colombian health care system: a tree of villages, each with a hospital. Every time step
+ * the sub-trees are simulated in parallel then, each village walks the linked lists of its hospital
+ * moving patients between them and reallocating some to the parent village. The work per task is small
+ * and dominated by pointer chasing.
+ */
+
+inline constexpr int health_levels = 6;
+inline constexpr int health_cities = 4;
+inline constexpr int health_population = 40;
+inline constexpr int health_steps = 500;
+
+inline constexpr int health_assess_time = 2;
+inline constexpr int health_convalescence_time = 10;
+
+inline constexpr double health_get_sick_p = 0.02;
+inline constexpr double health_realloc_p = 0.1;
+
+struct patient {
+  int id;
+  int time = 0;      // Time spent in the system.
+  int time_left = 0; // Time until the current stage completes.
+  int hosps_visited = 0;
+};
+
+using patient_list = std::list<patient *>;
+
+struct hospital {
+  int personnel = 0;
+  int free_personnel = 0;
+  patient_list waiting;
+  patient_list assess;
+  patient_list inside;
+};
+
+struct village {
+  int id = 0;
+  int level = 0;
+  village *back = nullptr;
+  std::vector<std::unique_ptr<village>> children;
+  std::vector<std::unique_ptr<patient>> residents; // Owns the patients born here.
+  patient_list population;
+  patient_list up; // Patients reallocated to the parent this step.
+  hospital hosp;
+  std::minstd_rand rng;
+};
+
+inline auto health_build(int level, village *back, int &ids) -> std::unique_ptr<village> {
+
+  auto v = std::make_unique<village>();
+
+  v->id = ids++;
+  v->level = level;
+  v->back = back;
+  v->hosp.personnel = 1 << (level - 1);
+  v->hosp.free_personnel = v->hosp.personnel;
+  v->rng.seed(static_cast<std::uint_fast32_t>(v->id + 1));
+
+  for (int i = 0; i < health_population; i++) {
+    v->residents.push_back(std::make_unique<patient>(patient{.id = v->id * health_population + i}));
+    v->population.push_back(v->residents.back().get());
+  }
+
+  if (level > 1) {
+    for (int i = 0; i < health_cities; i++) {
+      v->children.push_back(health_build(level - 1, v.get(), ids));
+    }
+  }
+
+  return v;
+}
+
+inline auto health_init() -> std::unique_ptr<village> {
+  int ids = 0;
+  return health_build(health_levels, nullptr, ids);
+}
+
+/**
+ * @brief Simulate one step of the hospital in `v`, the children must have been simulated first.
+ */
+inline void health_local(village &v) {
+
+  auto chance = [&v](double p) {
+    return std::uniform_real_distribution<double>{0, 1}(v.rng) < p;
+  };
+
+  hospital &h = v.hosp;
+
+  // Patients reallocated by the children join the waiting list.
+  for (auto &child : v.children) {
+    h.waiting.splice(h.waiting.end(), child->up);
+  }
+
+  // Discharge.
+  for (auto it = h.inside.begin(); it != h.inside.end();) {
+    if (--(*it)->time_left == 0) {
+      h.free_personnel++;
+      v.population.splice(v.population.end(), h.inside, it++);
+    } else {
+      ++it;
+    }
+  }
+
+  // Assessment, either treat here or send up the tree.
+  for (auto it = h.assess.begin(); it != h.assess.end();) {
+
+    patient *p = *it;
+
+    if (--p->time_left > 0) {
+      ++it;
+      continue;
+    }
+
+    if (v.back != nullptr && chance(health_realloc_p)) {
+      h.free_personnel++;
+      v.up.splice(v.up.end(), h.assess, it++);
+    } else {
+      p->time_left = health_convalescence_time;
+      p->hosps_visited++;
+      h.inside.splice(h.inside.end(), h.assess, it++);
+    }
+  }
+
+  // Admit while staff are free.
+  while (h.free_personnel > 0 && !h.waiting.empty()) {
+    h.free_personnel--;
+    h.waiting.front()->time_left = health_assess_time;
+    h.assess.splice(h.assess.end(), h.waiting, h.waiting.begin());
+  }
+
+  for (patient *p : h.waiting) {
+    p->time++;
+  }
+
+  // Some of the healthy fall ill.
+  for (auto it = v.population.begin(); it != v.population.end();) {
+    if (chance(health_get_sick_p)) {
+      h.waiting.splice(h.waiting.end(), v.population, it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+inline void health_seq(village &v) {
+  for (auto &child : v.children) {
+    health_seq(*child);
+  }
+  health_local(v);
+}
+
+/**
+ * @brief A digest of the state of the simulation.
+ */
+struct health_stats {
+
+  long patients = 0;
+  long hosps_visited = 0;
+  long time = 0;
+  long waiting = 0;
+
+  explicit health_stats(village const &v) { add(v); }
+
+  friend auto operator==(health_stats const &, health_stats const &) -> bool = default;
+
+ private:
+  void add(village const &v) {
+    for (auto const &p : v.residents) {
+      patients++;
+      hosps_visited += p->hosps_visited;
+      time += p->time;
+    }
+    waiting += static_cast<long>(v.hosp.waiting.size());
+    for (auto const &child : v.children) {
+      add(*child);
+    }
+  }
+};
+
+/**
+ * @brief Compare against a sequential simulation.
+ */
+inline auto health_check(village const &v) -> bool {
+
+  auto expect = health_init();
+
+  for (int i = 0; i < health_steps; i++) {
+    health_seq(*expect);
+  }
+
+  return health_stats{v} == health_stats{*expect};
+}
+
+#endif /* B5C9E3A7_2F6D_4A18_9E47_C8D1F0B6A293 */
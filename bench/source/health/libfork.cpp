@@ -0,0 +1,73 @@
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include <libfork.hpp>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+using namespace lf;
+
+constexpr auto sim_village = [](auto sim_village, village *v) LF_STATIC_CALL -> task<> {
+  //
+  for (auto &child : v->children) {
+    co_await lf::fork(sim_village)(child.get());
+  }
+
+  co_await lf::join;
+
+  health_local(*v);
+};
+
+constexpr auto simulate = [](auto, village *world, int steps) LF_STATIC_CALL -> task<> {
+  for (int i = 0; i < steps; i++) {
+    co_await lf::call(sim_village)(world);
+    co_await lf::join;
+  }
+};
+
+template <lf::scheduler Sch, lf::numa_strategy Strategy>
+void health_libfork(benchmark::State &state) {
+
+  state.counters["green_threads"] = state.range(0);
+  state.counters["health(levels)"] = health_levels;
+
+  Sch sch = [&] {
+    if constexpr (std::constructible_from<Sch, int>) {
+      return Sch(state.range(0));
+    } else {
+      return Sch{};
+    }
+  }();
+
+  peak_memory mem{state, sch};
+
+  std::unique_ptr<village> world;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    world = health_init();
+    state.ResumeTiming();
+
+    lf::sync_wait(sch, simulate, world.get(), health_steps);
+  }
+
+#ifndef LF_NO_CHECK
+  if (!health_check(*world)) {
+    std::cerr << "lf wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+using namespace lf;
+
+BENCHMARK(health_libfork<lazy_pool, numa_strategy::seq>)->Apply(targs)->UseRealTime();
+BENCHMARK(health_libfork<lazy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
+
+BENCHMARK(health_libfork<busy_pool, numa_strategy::seq>)->Apply(targs)->UseRealTime();
+BENCHMARK(health_libfork<busy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
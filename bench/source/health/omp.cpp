@@ -0,0 +1,55 @@
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+void sim_village(village *v) {
+
+  for (auto &child : v->children) {
+    village *c = child.get();
+#pragma omp task untied firstprivate(c) default(none)
+    sim_village(c);
+  }
+
+#pragma omp taskwait
+
+  health_local(*v);
+}
+
+void health_omp(benchmark::State &state) {
+
+  state.counters["green_threads"] = state.range(0);
+  state.counters["health(levels)"] = health_levels;
+
+  peak_memory mem{state};
+
+  std::size_t n = state.range(0);
+
+  std::unique_ptr<village> world;
+
+#pragma omp parallel num_threads(n)
+#pragma omp single
+  for (auto _ : state) {
+    state.PauseTiming();
+    world = health_init();
+    state.ResumeTiming();
+
+    for (int i = 0; i < health_steps; i++) {
+      sim_village(world.get());
+    }
+  }
+
+#ifndef LF_NO_CHECK
+  if (!health_check(*world)) {
+    std::cerr << "omp wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(health_omp)->Apply(targs)->UseRealTime();
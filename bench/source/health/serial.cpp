@@ -0,0 +1,38 @@
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+void health_serial(benchmark::State &state) {
+
+  state.counters["green_threads"] = 1;
+  state.counters["health(levels)"] = health_levels;
+
+  peak_memory mem{state};
+
+  std::unique_ptr<village> world;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    world = health_init();
+    state.ResumeTiming();
+
+    for (int i = 0; i < health_steps; i++) {
+      health_seq(*world);
+    }
+  }
+
+#ifndef LF_NO_CHECK
+  if (!health_check(*world)) {
+    std::cerr << "serial wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(health_serial)->UseRealTime();
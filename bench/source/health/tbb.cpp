@@ -0,0 +1,61 @@
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+void sim_village(village *v) {
+
+  tbb::task_group g;
+
+  for (auto &child : v->children) {
+    g.run([c = child.get()] {
+      sim_village(c);
+    });
+  }
+
+  g.wait();
+
+  health_local(*v);
+}
+
+void health_tbb(benchmark::State &state) {
+
+  state.counters["green_threads"] = state.range(0);
+  state.counters["health(levels)"] = health_levels;
+
+  peak_memory mem{state};
+
+  std::size_t n = state.range(0);
+  tbb::task_arena arena(n);
+
+  std::unique_ptr<village> world;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    world = health_init();
+    state.ResumeTiming();
+
+    arena.execute([&] {
+      for (int i = 0; i < health_steps; i++) {
+        sim_village(world.get());
+      }
+    });
+  }
+
+#ifndef LF_NO_CHECK
+  if (!health_check(*world)) {
+    std::cerr << "tbb wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(health_tbb)->Apply(targs)->UseRealTime();
@@ -47,6 +47,8 @@ void integrate_libfork(benchmark::State &state) {
     }
   }();
 
+  peak_memory mem{state, sch};
+
   volatile double out;
 
   for (auto _ : state) {
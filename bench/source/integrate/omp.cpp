@@ -36,6 +36,8 @@ void integrate_omp(benchmark::State &state) {
   state.counters["integrate_n"] = n;
   state.counters["integrate_epsilon"] = epsilon;
 
+  peak_memory mem{state};
+
   volatile double out;
 
 #pragma omp parallel num_threads(state.range(0))
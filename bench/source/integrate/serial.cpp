@@ -32,6 +32,8 @@ void integrate_serial(benchmark::State &state) {
   state.counters["integrate_n"] = n;
   state.counters["integrate_epsilon"] = epsilon;
 
+  peak_memory mem{state};
+
   volatile int confuse = n;
   volatile double out;
 
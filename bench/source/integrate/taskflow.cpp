@@ -40,6 +40,8 @@ void integrate_ztaskflow(benchmark::State &state) {
   state.counters["integrate_n"] = n;
   state.counters["integrate_epsilon"] = epsilon;
 
+  peak_memory mem{state};
+
   volatile double out;
 
   tf::Executor executor(state.range(0));
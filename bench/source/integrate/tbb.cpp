@@ -38,6 +38,8 @@ auto integrate(double x1, double y1, double x2, double y2, double area) -> doubl
 
 void integrate_tbb(benchmark::State &state) {
 
+  peak_memory mem{state};
+
   // TBB uses (2MB) stacks by default
   tbb::global_control global_limit(tbb::global_control::thread_stack_size, 8 * 1024 * 1024);
 
@@ -36,6 +36,8 @@ void integrate_tmc(benchmark::State &state) {
   state.counters["integrate_n"] = n;
   state.counters["integrate_epsilon"] = epsilon;
 
+  peak_memory mem{state};
+
   volatile double out;
 
   tmc::cpu_executor().set_thread_count(state.range(0)).init();
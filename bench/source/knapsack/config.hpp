@@ -0,0 +1,88 @@
+#ifndef F7B4D2E6_9A31_4C58_B8E2_0D6A3C9F5E17
+#define F7B4D2E6_9A31_4C58_B8E2_0D6A3C9F5E17
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <random>
+#include <vector>
+
+/**
+ * Port of the knapsack kernel from the Barcelona OpenMP Tasks Suite (BOTS).
+ *
+ * A 0/1 knapsack solved by branch-and-bound. Subtrees are pruned against a shared best-so-far hence, the
+ * shape of the task tree depends on the order in which tasks complete.
+ */
+
+inline constexpr int knapsack_items = 56;
+
+struct item {
+  int value;
+  int weight;
+};
+
+struct knapsack_args {
+  std::vector<item> items;
+  int capacity;
+};
+
+/**
+ * @brief A strongly correlated (hence hard) instance, sorted by decreasing value density as BOTS expects.
+ */
+inline auto knapsack_init(int n = knapsack_items) -> knapsack_args {
+
+  std::mt19937 rng{42};
+  std::uniform_int_distribution<int> weight{1000, 10000};
+  std::uniform_int_distribution<int> noise{-100, 100};
+
+  knapsack_args args{{}, 0};
+
+  for (int i = 0; i < n; i++) {
+    int w = weight(rng);
+    args.items.push_back({w + 1000 + noise(rng), w});
+    args.capacity += w;
+  }
+
+  args.capacity /= 2;
+
+  std::ranges::sort(args.items, [](item const &a, item const &b) {
+    return a.value * b.weight > b.value * a.weight;
+  });
+
+  return args;
+}
+
+/**
+ * @brief The upper bound BOTS uses to prune, fill the remaining capacity at the current value density.
+ */
+inline auto knapsack_prune(item const *e, int c, int v, std::atomic<int> const &best) -> bool {
+  double ub = static_cast<double>(v) + c * e->value / e->weight;
+  return ub < best.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Publish a solution.
+ */
+inline void knapsack_update(std::atomic<int> &best, int value) {
+  int prev = best.load(std::memory_order_relaxed);
+  while (value > prev && !best.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {
+  }
+}
+
+/**
+ * @brief The exact optimum via dynamic programming, used to verify the search.
+ */
+inline auto knapsack_dp(knapsack_args const &args) -> int {
+
+  std::vector<int> best(static_cast<std::size_t>(args.capacity) + 1, 0);
+
+  for (item const &e : args.items) {
+    for (int c = args.capacity; c >= e.weight; c--) {
+      best[c] = std::max(best[c], best[c - e.weight] + e.value);
+    }
+  }
+
+  return best.back();
+}
+
+#endif /* F7B4D2E6_9A31_4C58_B8E2_0D6A3C9F5E17 */
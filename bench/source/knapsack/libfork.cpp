@@ -0,0 +1,88 @@
+#include <atomic>
+#include <climits>
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include <libfork.hpp>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+using namespace lf;
+
+constexpr auto knapsack = [](auto knapsack, item const *e, int c, int n, int v, std::atomic<int> *best)
+                              LF_STATIC_CALL -> task<int> {
+  //
+  if (c < 0) {
+    co_return INT_MIN;
+  }
+
+  if (n == 0 || c == 0) {
+    co_return v;
+  }
+
+  if (knapsack_prune(e, c, v, *best)) {
+    co_return INT_MIN;
+  }
+
+  int with = 0;
+  int without = 0;
+
+  co_await lf::fork(&with, knapsack)(e + 1, c - e->weight, n - 1, v + e->value, best);
+  co_await lf::call(&without, knapsack)(e + 1, c, n - 1, v, best);
+
+  co_await lf::join;
+
+  int res = std::max(with, without);
+
+  knapsack_update(*best, res);
+
+  co_return res;
+};
+
+template <lf::scheduler Sch, lf::numa_strategy Strategy>
+void knapsack_libfork(benchmark::State &state) {
+
+  state.counters["green_threads"] = state.range(0);
+  state.counters["knapsack(n)"] = knapsack_items;
+
+  Sch sch = [&] {
+    if constexpr (std::constructible_from<Sch, int>) {
+      return Sch(state.range(0));
+    } else {
+      return Sch{};
+    }
+  }();
+
+  peak_memory mem{state, sch};
+
+  auto args = knapsack_init();
+
+  std::atomic<int> best;
+
+  volatile int output;
+
+  for (auto _ : state) {
+    best = 0;
+    output = lf::sync_wait(sch, knapsack, args.items.data(), args.capacity, knapsack_items, 0, &best);
+  }
+
+#ifndef LF_NO_CHECK
+  if (int expect = knapsack_dp(args); output != expect) {
+    std::cerr << "lf wrong answer: " << output << " != " << expect << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+using namespace lf;
+
+BENCHMARK(knapsack_libfork<lazy_pool, numa_strategy::seq>)->Apply(targs)->UseRealTime();
+BENCHMARK(knapsack_libfork<lazy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
+
+BENCHMARK(knapsack_libfork<busy_pool, numa_strategy::seq>)->Apply(targs)->UseRealTime();
+BENCHMARK(knapsack_libfork<busy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
@@ -0,0 +1,63 @@
+#include <atomic>
+#include <climits>
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+auto knapsack(item const *e, int c, int n, int v, std::atomic<int> &best) -> int {
+
+  if (c < 0) {
+    return INT_MIN;
+  }
+
+  if (n == 0 || c == 0) {
+    return v;
+  }
+
+  if (knapsack_prune(e, c, v, best)) {
+    return INT_MIN;
+  }
+
+  int with = knapsack(e + 1, c - e->weight, n - 1, v + e->value, best);
+  int without = knapsack(e + 1, c, n - 1, v, best);
+
+  int res = std::max(with, without);
+
+  knapsack_update(best, res);
+
+  return res;
+}
+
+void knapsack_serial(benchmark::State &state) {
+
+  state.counters["green_threads"] = 1;
+  state.counters["knapsack(n)"] = knapsack_items;
+
+  peak_memory mem{state};
+
+  auto args = knapsack_init();
+
+  std::atomic<int> best;
+
+  volatile int output;
+
+  for (auto _ : state) {
+    best = 0;
+    output = knapsack(args.items.data(), args.capacity, knapsack_items, 0, best);
+  }
+
+#ifndef LF_NO_CHECK
+  if (int expect = knapsack_dp(args); output != expect) {
+    std::cerr << "serial wrong answer: " << output << " != " << expect << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(knapsack_serial)->UseRealTime();
@@ -0,0 +1,80 @@
+#include <atomic>
+#include <climits>
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+auto knapsack(item const *e, int c, int n, int v, std::atomic<int> &best) -> int {
+
+  if (c < 0) {
+    return INT_MIN;
+  }
+
+  if (n == 0 || c == 0) {
+    return v;
+  }
+
+  if (knapsack_prune(e, c, v, best)) {
+    return INT_MIN;
+  }
+
+  int with, without;
+
+  tbb::task_group g;
+
+  g.run([&] {
+    without = knapsack(e + 1, c, n - 1, v, best);
+  });
+
+  with = knapsack(e + 1, c - e->weight, n - 1, v + e->value, best);
+
+  g.wait();
+
+  int res = std::max(with, without);
+
+  knapsack_update(best, res);
+
+  return res;
+}
+
+void knapsack_tbb(benchmark::State &state) {
+
+  state.counters["green_threads"] = state.range(0);
+  state.counters["knapsack(n)"] = knapsack_items;
+
+  peak_memory mem{state};
+
+  std::size_t n = state.range(0);
+  tbb::task_arena arena(n);
+
+  auto args = knapsack_init();
+
+  std::atomic<int> best;
+
+  volatile int output;
+
+  for (auto _ : state) {
+    best = 0;
+    output = arena.execute([&] {
+      return knapsack(args.items.data(), args.capacity, knapsack_items, 0, best);
+    });
+  }
+
+#ifndef LF_NO_CHECK
+  if (int expect = knapsack_dp(args); output != expect) {
+    std::cerr << "tbb wrong answer: " << output << " != " << expect << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(knapsack_tbb)->Apply(targs)->UseRealTime();
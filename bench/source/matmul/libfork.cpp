@@ -2,6 +2,7 @@
 
 #include <libfork.hpp>
 
+#include "../pool.hpp"
 #include "../util.hpp"
 #include "config.hpp"
 
@@ -51,20 +52,24 @@ inline constexpr auto matmul = [](auto matmul, mat A, mat B, mat R, unsigned n,
   co_await join;
 };
 
-template <lf::scheduler Sch, lf::numa_strategy Strategy>
+template <lf::scheduler Sch, lf::numa_strategy Strategy, bool Private = false>
 void matmul_libfork(benchmark::State &state) {
 
   state.counters["green_threads"] = state.range(0);
   state.counters["mat NxN"] = matmul_work;
 
   Sch sch = [&] {
-    if constexpr (std::constructible_from<Sch, int>) {
+    if constexpr (Private) {
+      return private_deque_pool<Sch>(static_cast<std::size_t>(state.range(0)), Strategy);
+    } else if constexpr (std::constructible_from<Sch, int>) {
       return Sch(state.range(0));
     } else {
       return Sch{};
     }
   }();
 
+  peak_memory mem{state, sch};
+
   auto [A, B, C1, C2, n] = lf::sync_wait(sch, lf::lift, matmul_init, matmul_work);
 
   for (auto _ : state) {
@@ -91,4 +96,9 @@ BENCHMARK(matmul_libfork<lazy_pool, numa_strategy::seq>)->Apply(targs)->UseRealT
 BENCHMARK(matmul_libfork<lazy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
 
 BENCHMARK(matmul_libfork<busy_pool, numa_strategy::seq>)->Apply(targs)->UseRealTime();
-BENCHMARK(matmul_libfork<busy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
\ No newline at end of file
+BENCHMARK(matmul_libfork<busy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
+
+// Receiver-initiated stealing from private deques.
+
+BENCHMARK(matmul_libfork<lazy_pool, numa_strategy::fan, true>)->Apply(targs)->UseRealTime();
+BENCHMARK(matmul_libfork<busy_pool, numa_strategy::fan, true>)->Apply(targs)->UseRealTime();
\ No newline at end of file
@@ -58,6 +58,8 @@ void matmul_omp(benchmark::State &state) {
   state.counters["green_threads"] = state.range(0);
   state.counters["mat NxN"] = matmul_work;
 
+  peak_memory mem{state};
+
   std::size_t n_thr = state.range(0);
 
   matmul_args args;
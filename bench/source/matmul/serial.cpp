@@ -53,6 +53,8 @@ void matmul_serial(benchmark::State &state) {
   state.counters["green_threads"] = 1;
   state.counters["mat NxN"] = matmul_work;
 
+  peak_memory mem{state};
+
   auto [A, B, C1, C2, n] = matmul_init(matmul_work);
 
   volatile int m = n;
@@ -70,6 +70,8 @@ void matmul_ztaskflow(benchmark::State &state) {
   state.counters["green_threads"] = state.range(0);
   state.counters["mat NxN"] = matmul_work;
 
+  peak_memory mem{state};
+
   tf::Executor executor(state.range(0));
 
   matmul_args args = matmul_init(matmul_work);
@@ -65,6 +65,8 @@ void matmul(float *A, float *B, float *R, unsigned n, unsigned s, Add add = {})
 
 void matmul_tbb(benchmark::State &state) {
 
+  peak_memory mem{state};
+
   // TBB uses (2MB) stacks by default
   tbb::global_control global_limit(tbb::global_control::thread_stack_size, 8 * 1024 * 1024);
 
@@ -62,6 +62,8 @@ void matmul_tmc(benchmark::State &state) {
   state.counters["green_threads"] = state.range(0);
   state.counters["mat NxN"] = matmul_work;
 
+  peak_memory mem{state};
+
   tmc::cpu_executor().set_thread_count(state.range(0)).init();
 
   auto [A, B, C1, C2, n] = matmul_init(matmul_work);
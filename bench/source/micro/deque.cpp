@@ -0,0 +1,150 @@
+#include <atomic>
+#include <cstddef>
+
+#include <benchmark/benchmark.h>
+
+#include <libfork.hpp>
+
+#include "../util.hpp"
+#include "team.hpp"
+
+namespace {
+
+/**
+ * @brief Owner-only push/pop of a batch of items, this is the fork/continuation fast path.
+ */
+void deque_push_pop(benchmark::State &state) {
+
+  auto batch = static_cast<int>(state.range(0));
+
+  state.counters["batch"] = batch;
+
+  lf::deque<int> deque;
+
+  for (auto _ : state) {
+    for (int i = 0; i < batch; ++i) {
+      deque.push(i);
+    }
+    for (int i = 0; i < batch; ++i) {
+      benchmark::DoNotOptimize(deque.pop());
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * batch);
+}
+
+/**
+ * @brief As `deque_push_pop` but with the fixed-capacity deque.
+ */
+void bounded_deque_push_pop(benchmark::State &state) {
+
+  auto batch = static_cast<int>(state.range(0));
+
+  state.counters["batch"] = batch;
+
+  lf::bounded_deque<int, 4096> deque;
+
+  for (auto _ : state) {
+    for (int i = 0; i < batch; ++i) {
+      benchmark::DoNotOptimize(deque.push(i));
+    }
+    for (int i = 0; i < batch; ++i) {
+      benchmark::DoNotOptimize(deque.pop());
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * batch);
+}
+
+constexpr int k_steal_items = 1 << 16;
+
+/**
+ * @brief Throughput of `n` thieves emptying a deque.
+ */
+void deque_steal(benchmark::State &state) {
+
+  auto thieves = static_cast<std::size_t>(state.range(0));
+
+  state.counters["green_threads"] = static_cast<double>(thieves);
+
+  lf::deque<int> deque;
+  team crew{thieves};
+
+  std::atomic<int> stolen = 0;
+  std::atomic<std::size_t> lost = 0;
+
+  for (auto _ : state) {
+
+    state.PauseTiming();
+    for (int i = 0; i < k_steal_items; ++i) {
+      deque.push(i);
+    }
+    stolen = 0;
+    state.ResumeTiming();
+
+    crew.run(
+        [&](std::size_t) {
+          while (stolen.load(std::memory_order_relaxed) < k_steal_items) {
+            switch (deque.steal().code) {
+              case lf::err::none:
+                stolen.fetch_add(1, std::memory_order_relaxed);
+                break;
+              case lf::err::lost:
+                lost.fetch_add(1, std::memory_order_relaxed);
+                break;
+              case lf::err::empty:
+                break;
+            }
+          }
+        },
+        [] {});
+  }
+
+  state.counters["lost_per_item"] =
+      static_cast<double>(lost.load()) / static_cast<double>(state.iterations() * k_steal_items);
+
+  state.SetItemsProcessed(state.iterations() * k_steal_items);
+}
+
+/**
+ * @brief A stealer racing the owner, the owner pushes and pops while `n` thieves attempt to steal.
+ */
+void deque_contended(benchmark::State &state) {
+
+  auto thieves = static_cast<std::size_t>(state.range(0));
+
+  state.counters["green_threads"] = static_cast<double>(thieves);
+
+  lf::deque<int> deque;
+  team crew{thieves};
+
+  constexpr int k_ops = 1 << 16;
+
+  for (auto _ : state) {
+
+    std::atomic_bool done = false;
+
+    crew.run(
+        [&](std::size_t) {
+          while (!done.load(std::memory_order_relaxed)) {
+            benchmark::DoNotOptimize(deque.steal());
+          }
+        },
+        [&] {
+          for (int i = 0; i < k_ops; ++i) {
+            deque.push(i);
+            benchmark::DoNotOptimize(deque.pop());
+          }
+          done = true;
+        });
+  }
+
+  state.SetItemsProcessed(state.iterations() * k_ops);
+}
+
+} // namespace
+
+BENCHMARK(deque_push_pop)->RangeMultiplier(8)->Range(1, 4096);
+BENCHMARK(bounded_deque_push_pop)->RangeMultiplier(8)->Range(1, 4096);
+BENCHMARK(deque_steal)->Apply(targs)->UseRealTime();
+BENCHMARK(deque_contended)->Apply(targs)->UseRealTime();
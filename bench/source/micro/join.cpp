@@ -0,0 +1,69 @@
+#include <concepts>
+
+#include <benchmark/benchmark.h>
+
+#include <libfork.hpp>
+
+#include "../util.hpp"
+
+namespace {
+
+constexpr int k_width = 64;
+constexpr int k_rounds = 256;
+
+constexpr auto leaf = [](auto) LF_STATIC_CALL -> lf::task<int> {
+  co_return 1;
+};
+
+/**
+ * @brief Repeatedly fork trivial children and join, with thieves the parent is stolen and the join raced.
+ */
+constexpr auto fan = [](auto) LF_STATIC_CALL -> lf::task<int> {
+  int total = 0;
+
+  for (int r = 0; r < k_rounds; ++r) {
+
+    int out[k_width];
+
+    for (int i = 0; i < k_width; ++i) {
+      co_await lf::fork(&out[i], leaf)();
+    }
+
+    co_await lf::join;
+
+    for (int i = 0; i < k_width; ++i) {
+      total += out[i];
+    }
+  }
+
+  co_return total;
+};
+
+template <lf::scheduler Sch>
+void join_race(benchmark::State &state) {
+
+  state.counters["green_threads"] = static_cast<double>(state.range(0));
+
+  Sch sch(static_cast<std::size_t>(state.range(0)));
+
+  volatile int output = 0;
+
+  for (auto _ : state) {
+    output = lf::sync_wait(sch, fan);
+  }
+
+#ifndef LF_NO_CHECK
+  if (output != k_width * k_rounds) {
+    state.SkipWithError("incorrect result");
+  }
+#endif
+
+  state.SetItemsProcessed(state.iterations() * k_width * k_rounds);
+}
+
+} // namespace
+
+using namespace lf;
+
+BENCHMARK(join_race<lazy_pool>)->Apply(targs)->UseRealTime();
+BENCHMARK(join_race<busy_pool>)->Apply(targs)->UseRealTime();
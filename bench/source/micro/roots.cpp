@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <libfork.hpp>
+
+#include "../util.hpp"
+#include "team.hpp"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+/**
+ * @brief A tiny root that does nothing.
+ */
+constexpr auto noop = [](auto) LF_STATIC_CALL -> lf::task<> {
+  co_return;
+};
+
+/**
+ * @brief A tiny root that reports when it finished.
+ */
+constexpr auto stamp = [](auto) LF_STATIC_CALL -> lf::task<clock_type::time_point> {
+  co_return clock_type::now();
+};
+
+/**
+ * @brief Number of roots each iteration submits, split between the producers.
+ */
+constexpr std::size_t k_roots = 1024;
+
+/**
+ * @brief Build a pool with every hardware thread as a worker (the unit_pool has exactly one).
+ */
+template <typename Pool>
+auto make_pool() -> Pool {
+  if constexpr (std::constructible_from<Pool, std::size_t>) {
+    return Pool(static_cast<std::size_t>(num_threads()));
+  } else {
+    return Pool{};
+  }
+}
+
+/**
+ * @brief Get the `q` quantile of the sorted `data`.
+ */
+auto quantile(std::vector<std::int64_t> const &data, double q) -> double {
+  if (data.empty()) {
+    return 0;
+  }
+  auto idx = static_cast<std::size_t>(q * static_cast<double>(data.size() - 1));
+  return static_cast<double>(data[idx]);
+}
+
+/**
+ * @brief `M = range(0)` external threads submit tiny roots at a total offered load of `range(1)` roots/s.
+ *
+ * An offered load of zero means closed-loop, each producer `sync_wait`s back-to-back and latency is the
+ * round trip seen by the producer. Otherwise producers run open-loop: they submit on a fixed schedule
+ * without waiting and latency is measured from the intended submission time to the root finishing, such
+ * that a stalled submission path is not hidden (coordinated omission).
+ */
+template <typename Pool>
+void root_latency(benchmark::State &state) {
+
+  auto producers = static_cast<std::size_t>(state.range(0));
+  auto offered = static_cast<double>(state.range(1));
+
+  state.counters["producers"] = static_cast<double>(producers);
+  state.counters["offered_per_second"] = offered;
+
+  Pool sch = make_pool<Pool>();
+
+  team crew(producers);
+
+  std::size_t per_producer = k_roots / producers;
+
+  auto period = offered > 0 ? std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(
+                                  static_cast<double>(producers) / offered))
+                            : clock_type::duration::zero();
+
+  std::vector<std::vector<std::int64_t>> latency(producers);
+
+  for (auto &&vec : latency) {
+    vec.reserve(per_producer * 64);
+  }
+
+  for (auto _ : state) {
+    crew.run(
+        [&](std::size_t id) {
+          //
+          auto &out = latency[id];
+
+          if (period == clock_type::duration::zero()) {
+            for (std::size_t i = 0; i < per_producer; ++i) {
+              auto start = clock_type::now();
+              lf::sync_wait(sch, noop);
+              // Include the wake-up of the submitting thread in the round trip.
+              auto stop = clock_type::now();
+              out.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+            }
+            return;
+          }
+
+          std::vector<lf::future<clock_type::time_point>> futures;
+          std::vector<clock_type::time_point> intended;
+
+          futures.reserve(per_producer);
+          intended.reserve(per_producer);
+
+          // Stagger the producers across one period.
+          auto next = clock_type::now() + period * static_cast<std::int64_t>(id) / producers;
+
+          for (std::size_t i = 0; i < per_producer; ++i, next += period) {
+            while (clock_type::now() < next) {
+              // Sleeping is too coarse for high loads, yield in case the machine is oversubscribed.
+              std::this_thread::yield();
+            }
+            intended.push_back(next);
+            futures.push_back(lf::schedule(sch, stamp));
+          }
+
+          for (std::size_t i = 0; i < per_producer; ++i) {
+            auto stop = futures[i].get();
+            out.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - intended[i]).count());
+          }
+        },
+        [] {});
+  }
+
+  std::vector<std::int64_t> all;
+
+  for (auto const &vec : latency) {
+    all.insert(all.end(), vec.begin(), vec.end());
+  }
+
+  std::sort(all.begin(), all.end());
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * per_producer * producers));
+
+  state.counters["p50_ns"] = quantile(all, 0.50);
+  state.counters["p99_ns"] = quantile(all, 0.99);
+  state.counters["p999_ns"] = quantile(all, 0.999);
+  state.counters["max_ns"] = all.empty() ? 0 : static_cast<double>(all.back());
+}
+
+/**
+ * @brief Producers in {1, 2, 4, ...} up to the hardware concurrency, crossed with the offered loads.
+ */
+void load_args(benchmark::internal::Benchmark *bench) {
+  for (int prod = 1; prod <= std::max(1, num_threads()); prod *= 2) {
+    for (int load : {0, 10'000, 100'000, 1'000'000}) {
+      bench->Args({prod, load});
+    }
+  }
+}
+
+} // namespace
+
+BENCHMARK(root_latency<lf::lazy_pool>)->Apply(load_args)->UseRealTime();
+BENCHMARK(root_latency<lf::busy_pool>)->Apply(load_args)->UseRealTime();
+BENCHMARK(root_latency<lf::unit_pool>)->Apply(load_args)->UseRealTime();
@@ -0,0 +1,64 @@
+#include <cstddef>
+#include <ranges>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <libfork.hpp>
+
+#include "../util.hpp"
+
+namespace {
+
+constexpr std::size_t k_frame = 256;
+
+/**
+ * @brief Allocate/deallocate a frame-sized block that fits in the current stacklet.
+ */
+void stacklet_within(benchmark::State &state) {
+
+  lf::impl::stack stack;
+
+  for (auto _ : state) {
+    void *ptr = stack.allocate(k_frame);
+    benchmark::DoNotOptimize(ptr);
+    stack.deallocate(ptr);
+  }
+}
+
+/**
+ * @brief Allocate/deallocate a frame-sized block that does not fit in the current stacklet.
+ *
+ * After the first iteration the next stacklet is cached, this measures the cost of hopping between them.
+ */
+void stacklet_crossing(benchmark::State &state) {
+
+  lf::impl::stack stack;
+
+  // Fill the first stacklet such that the next allocation does not fit.
+  std::vector<void *> fill;
+
+  for (auto *first = stack.top();;) {
+    void *ptr = stack.allocate(k_frame);
+    if (stack.top() != first) {
+      stack.deallocate(ptr);
+      break;
+    }
+    fill.push_back(ptr);
+  }
+
+  for (auto _ : state) {
+    void *ptr = stack.allocate(k_frame);
+    benchmark::DoNotOptimize(ptr);
+    stack.deallocate(ptr);
+  }
+
+  for (void *ptr : fill | std::views::reverse) {
+    stack.deallocate(ptr);
+  }
+}
+
+} // namespace
+
+BENCHMARK(stacklet_within);
+BENCHMARK(stacklet_crossing);
@@ -0,0 +1,58 @@
+#include <cstddef>
+
+#include <benchmark/benchmark.h>
+
+#include <libfork.hpp>
+
+#include "../util.hpp"
+
+namespace {
+
+constexpr auto noop = [](auto) LF_STATIC_CALL -> lf::task<int> {
+  co_return 1;
+};
+
+/**
+ * @brief Time to construct a pool of `range(0)` workers, run one root and destroy the pool.
+ *
+ * If `range(1)` the workers warm up, if `range(2)` the pool uses the cached topology (otherwise it loads a
+ * fresh topology, as every pool used to).
+ */
+template <typename Pool>
+void pool_startup(benchmark::State &state) {
+
+  auto n = static_cast<std::size_t>(state.range(0));
+
+  state.counters["green_threads"] = static_cast<double>(n);
+  state.counters["warm_up"] = static_cast<double>(state.range(1));
+  state.counters["cached"] = static_cast<double>(state.range(2));
+
+  for (auto _ : state) {
+
+    lf::pool_options opt{
+        .topology = state.range(2) != 0 ? lf::numa_topology::cached() : lf::numa_topology{},
+        .warm_up = state.range(1) != 0,
+    };
+
+    Pool sch{n, lf::numa_strategy::fan, opt};
+    benchmark::DoNotOptimize(lf::sync_wait(sch, noop));
+  }
+}
+
+/**
+ * @brief Thread counts crossed with warm-up and topology caching.
+ */
+void startup_args(benchmark::internal::Benchmark *bench) {
+  for (int n : thread_counts()) {
+    for (int warm : {0, 1}) {
+      for (int cached : {0, 1}) {
+        bench->Args({n, warm, cached});
+      }
+    }
+  }
+}
+
+} // namespace
+
+BENCHMARK(pool_startup<lf::lazy_pool>)->Apply(startup_args)->UseRealTime();
+BENCHMARK(pool_startup<lf::busy_pool>)->Apply(startup_args)->UseRealTime();
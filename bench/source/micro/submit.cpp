@@ -0,0 +1,67 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <libfork.hpp>
+
+#include "../util.hpp"
+#include "team.hpp"
+
+namespace {
+
+constexpr std::size_t k_nodes = 1 << 12;
+
+using list = lf::intrusive_list<int>;
+
+/**
+ * @brief `n` producers push into an `intrusive_list` (a worker's submission queue) while its owner drains it.
+ */
+void submit_contention(benchmark::State &state) {
+
+  auto producers = static_cast<std::size_t>(state.range(0));
+
+  state.counters["green_threads"] = static_cast<double>(producers);
+
+  list queue;
+  team crew{producers};
+
+  std::vector<std::vector<std::unique_ptr<list::node>>> nodes(producers);
+
+  for (auto _ : state) {
+
+    state.PauseTiming();
+    // Popped nodes are still linked, they must be rebuilt.
+    for (auto &&vec : nodes) {
+      vec.clear();
+      for (std::size_t i = 0; i < k_nodes; ++i) {
+        vec.push_back(std::make_unique<list::node>(1));
+      }
+    }
+    state.ResumeTiming();
+
+    crew.run(
+        [&](std::size_t tid) {
+          for (auto &&node : nodes[tid]) {
+            queue.push(node.get());
+          }
+        },
+        [&] {
+          std::size_t count = 0;
+          while (count < producers * k_nodes) {
+            for_each_elem(queue.try_pop_all(), [&](int &) {
+              ++count;
+            });
+          }
+        });
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(producers * k_nodes));
+}
+
+} // namespace
+
+BENCHMARK(submit_contention)->Apply(targs)->UseRealTime();
@@ -0,0 +1,62 @@
+#ifndef F1C3A7E2_4B9D_4E51_8A06_2D7E5C9B1F34
+#define F1C3A7E2_4B9D_4E51_8A06_2D7E5C9B1F34
+
+#include <barrier>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A fixed set of threads that run a job in lock-step, such that thread creation is not timed.
+ */
+class team {
+ public:
+  explicit team(std::size_t n)
+      : m_start(static_cast<std::ptrdiff_t>(n + 1)),
+        m_done(static_cast<std::ptrdiff_t>(n + 1)) {
+    for (std::size_t i = 0; i < n; ++i) {
+      m_threads.emplace_back([this, i] {
+        for (;;) {
+          m_start.arrive_and_wait();
+          if (m_stop) {
+            return;
+          }
+          m_job(i);
+          m_done.arrive_and_wait();
+        }
+      });
+    }
+  }
+
+  team(team const &) = delete;
+  auto operator=(team const &) -> team & = delete;
+
+  /**
+   * @brief Run `job(i)` on every thread, the calling thread runs `main()` concurrently and then waits.
+   */
+  template <typename Main>
+  void run(std::function<void(std::size_t)> job, Main &&main) {
+    m_job = std::move(job);
+    m_start.arrive_and_wait();
+    main();
+    m_done.arrive_and_wait();
+  }
+
+  ~team() {
+    m_stop = true;
+    m_start.arrive_and_wait();
+    for (auto &thread : m_threads) {
+      thread.join();
+    }
+  }
+
+ private:
+  std::barrier<> m_start;
+  std::barrier<> m_done;
+  std::function<void(std::size_t)> m_job;
+  bool m_stop = false;
+  std::vector<std::thread> m_threads;
+};
+
+#endif /* F1C3A7E2_4B9D_4E51_8A06_2D7E5C9B1F34 */
@@ -0,0 +1,55 @@
+#include <chrono>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include <libfork.hpp>
+
+#include "../util.hpp"
+
+namespace {
+
+constexpr auto noop = [](auto) LF_STATIC_CALL -> lf::task<int> {
+  co_return 1;
+};
+
+/**
+ * @brief Time from submitting a root to a pool of sleeping workers until the root completes.
+ */
+void lazy_wakeup(benchmark::State &state) {
+
+  state.counters["green_threads"] = static_cast<double>(state.range(0));
+
+  lf::lazy_pool sch(static_cast<std::size_t>(state.range(0)));
+
+  for (auto _ : state) {
+
+    // Give the workers time to go to sleep.
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+    auto start = std::chrono::steady_clock::now();
+    benchmark::DoNotOptimize(lf::sync_wait(sch, noop));
+    auto stop = std::chrono::steady_clock::now();
+
+    state.SetIterationTime(std::chrono::duration<double>(stop - start).count());
+  }
+}
+
+/**
+ * @brief As above but the workers are kept awake by back-to-back submissions.
+ */
+void lazy_hot_submit(benchmark::State &state) {
+
+  state.counters["green_threads"] = static_cast<double>(state.range(0));
+
+  lf::lazy_pool sch(static_cast<std::size_t>(state.range(0)));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lf::sync_wait(sch, noop));
+  }
+}
+
+} // namespace
+
+BENCHMARK(lazy_wakeup)->Apply(targs)->UseManualTime();
+BENCHMARK(lazy_hot_submit)->Apply(targs)->UseRealTime();
@@ -58,6 +58,8 @@ void nqueens_libfork(benchmark::State &state) {
     }
   }();
 
+  peak_memory mem{state, sch};
+
   volatile int output;
 
   std::array<char, nqueens_work> buf{};
@@ -69,6 +69,8 @@ void nqueens_omp(benchmark::State &state) {
   state.counters["green_threads"] = state.range(0);
   state.counters["nqueens(n)"] = nqueens_work;
 
+  peak_memory mem{state};
+
   std::size_t n = state.range(0);
 
   std::array<char, nqueens_work> buf{};
@@ -43,6 +43,8 @@ void nqueens_serial(benchmark::State &state) {
   state.counters["green_threads"] = 1;
   state.counters["nqueens(n)"] = nqueens_work;
 
+  peak_memory mem{state};
+
   volatile int output;
 
   std::array<char, nqueens_work> buf{};
@@ -52,6 +52,8 @@ void nqueens_ztaskflow(benchmark::State &state) {
   state.counters["green_threads"] = state.range(0);
   state.counters["nqueens(n)"] = nqueens_work;
 
+  peak_memory mem{state};
+
   std::size_t n = state.range(0);
   tf::Executor executor(n);
 
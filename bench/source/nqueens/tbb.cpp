@@ -53,6 +53,8 @@ auto nqueens(int j, std::array<char, N> const &a) -> int {
 
 void nqueens_tbb(benchmark::State &state) {
 
+  peak_memory mem{state};
+
   // TBB uses (2MB) stacks by default
   tbb::global_control global_limit(tbb::global_control::thread_stack_size, 8 * 1024 * 1024);
 
@@ -0,0 +1,19 @@
+#ifndef A7F3C2D1_6B4E_4D8A_9C5F_1E2B3A4D5C6E
+#define A7F3C2D1_6B4E_4D8A_9C5F_1E2B3A4D5C6E
+
+#include <cstddef>
+
+#include <libfork.hpp>
+
+/**
+ * @brief Construct a libfork pool with `n` workers whose tasks live in private deques.
+ *
+ * Compare against the same benchmark on a pool constructed with the default (Chase-Lev deque) options.
+ */
+template <typename Sch>
+auto private_deque_pool(std::size_t n, lf::numa_strategy strategy) -> Sch {
+
+  return Sch(n, strategy, {.private_deques = true});
+}
+
+#endif /* A7F3C2D1_6B4E_4D8A_9C5F_1E2B3A4D5C6E */
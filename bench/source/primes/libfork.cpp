@@ -27,6 +27,8 @@ void primes_libfork(benchmark::State &state) {
     }
   }();
 
+  peak_memory mem{state, sch};
+
   volatile int secret = primes_lim;
   volatile int output = 0;
 
@@ -16,6 +16,8 @@ void primes_omp(benchmark::State &state) {
   state.counters["primes(n)"] = primes_lim;
   state.counters["primes_chunk"] = primes_chunk;
 
+  peak_memory mem{state};
+
   volatile int secret = primes_lim;
   volatile int output = 0;
 
@@ -12,6 +12,8 @@ void primes_serial(benchmark::State &state) {
 
   state.counters["primes(n)"] = primes_lim;
 
+  peak_memory mem{state};
+
   volatile int secret = primes_lim;
   volatile int output = 0;
 
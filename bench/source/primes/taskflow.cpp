@@ -23,6 +23,8 @@ void primes_ztaskflow(benchmark::State &state) {
   state.counters["primes(n)"] = primes_lim;
   state.counters["primes_chunk"] = primes_chunk;
 
+  peak_memory mem{state};
+
   std::size_t n = state.range(0);
   tf::Executor executor(n);
 
@@ -36,6 +36,8 @@ void scan_libfork(benchmark::State &state) {
     }
   }();
 
+  peak_memory mem{state, sch};
+
   std::vector in = lf::sync_wait(sch, lf::lift, make_vec);
 
   std::vector ou = lf::sync_wait(sch, lf::lift, [&] {
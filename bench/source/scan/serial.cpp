@@ -16,6 +16,8 @@ void scan_serial(benchmark::State &state) {
 
   state.counters["scan(n)"] = scan_n;
 
+  peak_memory mem{state};
+
   std::vector<unsigned> in = make_vec();
   std::vector<unsigned> ou(in.size());
 
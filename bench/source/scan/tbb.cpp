@@ -42,6 +42,8 @@ LF_NOINLINE void test(tbb::task_arena& arena, std::vector<unsigned> &in, std::ve
 
 void scan_tbb(benchmark::State &state) {
 
+  peak_memory mem{state};
+
   // TBB uses (2MB) stacks by default
   tbb::global_control global_limit(tbb::global_control::thread_stack_size, 8 * 1024 * 1024);
 
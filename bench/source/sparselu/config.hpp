@@ -0,0 +1,210 @@
+#ifndef D3B7E1A9_6C2F_4E85_9A10_5F8E4C7B2D61
+#define D3B7E1A9_6C2F_4E85_9A10_5F8E4C7B2D61
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * Port of the sparselu kernel from the Barcelona OpenMP Tasks Suite (BOTS).
+ *
+ * An LU factorization of a sparse matrix stored as an NxN grid of dense BxB blocks, null blocks are
+ * absent and may be filled in during the factorization. Each outer step spawns a wave of independent
+ * block updates and waits for them, hence the parallelism is a sequence of fork/join phases.
+ */
+
+inline constexpr int sparselu_blocks = 50; // NB in BOTS.
+inline constexpr int sparselu_size = 64;   // BS in BOTS.
+
+using block = std::unique_ptr<float[]>;
+
+/**
+ * @brief A NB x NB grid of (possibly null) blocks.
+ */
+struct sparse_matrix {
+
+  explicit sparse_matrix(int nb) : n(nb), blocks(static_cast<std::size_t>(nb * nb)) {}
+
+  auto operator()(int i, int j) -> block & { return blocks[static_cast<std::size_t>(i * n + j)]; }
+
+  auto operator()(int i, int j) const -> block const & { return blocks[static_cast<std::size_t>(i * n + j)]; }
+
+  int n;
+  std::vector<block> blocks;
+};
+
+inline auto allocate_clean_block() -> block {
+  return std::make_unique<float[]>(static_cast<std::size_t>(sparselu_size * sparselu_size));
+}
+
+/**
+ * @brief Build the BOTS test matrix, same sparsity pattern and values.
+ */
+inline auto sparselu_init(int nb = sparselu_blocks) -> sparse_matrix {
+
+  sparse_matrix A{nb};
+
+  int init_val = 1325;
+
+  for (int ii = 0; ii < nb; ii++) {
+    for (int jj = 0; jj < nb; jj++) {
+
+      bool null_entry = false;
+
+      if ((ii < jj) && (ii % 3 != 0)) {
+        null_entry = true;
+      }
+      if ((ii > jj) && (jj % 3 != 0)) {
+        null_entry = true;
+      }
+      if (ii % 2 == 1) {
+        null_entry = true;
+      }
+      if (jj % 2 == 1) {
+        null_entry = true;
+      }
+      if (ii == jj || ii == jj - 1 || ii - 1 == jj) {
+        null_entry = false;
+      }
+
+      if (!null_entry) {
+
+        A(ii, jj) = allocate_clean_block();
+
+        for (int i = 0; i < sparselu_size * sparselu_size; i++) {
+          init_val = (3125 * init_val) % 65536;
+          A(ii, jj)[i] = static_cast<float>((init_val - 32768.0) / 16384.0);
+        }
+      }
+    }
+  }
+
+  return A;
+}
+
+// ------------------------------- Block kernels ------------------------------- //
+
+inline void lu0(float *diag) {
+  constexpr int bs = sparselu_size;
+  for (int k = 0; k < bs; k++) {
+    for (int i = k + 1; i < bs; i++) {
+      diag[i * bs + k] = diag[i * bs + k] / diag[k * bs + k];
+      for (int j = k + 1; j < bs; j++) {
+        diag[i * bs + j] = diag[i * bs + j] - diag[i * bs + k] * diag[k * bs + j];
+      }
+    }
+  }
+}
+
+inline void bdiv(float const *diag, float *row) {
+  constexpr int bs = sparselu_size;
+  for (int i = 0; i < bs; i++) {
+    for (int k = 0; k < bs; k++) {
+      row[i * bs + k] = row[i * bs + k] / diag[k * bs + k];
+      for (int j = k + 1; j < bs; j++) {
+        row[i * bs + j] = row[i * bs + j] - row[i * bs + k] * diag[k * bs + j];
+      }
+    }
+  }
+}
+
+inline void bmod(float const *row, float const *col, float *inner) {
+  constexpr int bs = sparselu_size;
+  for (int i = 0; i < bs; i++) {
+    for (int j = 0; j < bs; j++) {
+      for (int k = 0; k < bs; k++) {
+        inner[i * bs + j] = inner[i * bs + j] - row[i * bs + k] * col[k * bs + j];
+      }
+    }
+  }
+}
+
+inline void fwd(float const *diag, float *col) {
+  constexpr int bs = sparselu_size;
+  for (int j = 0; j < bs; j++) {
+    for (int k = 0; k < bs; k++) {
+      for (int i = k + 1; i < bs; i++) {
+        col[i * bs + j] = col[i * bs + j] - diag[i * bs + k] * col[k * bs + j];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Sequential factorization, used to verify the parallel versions.
+ */
+inline void sparselu_seq(sparse_matrix &A) {
+
+  int nb = A.n;
+
+  for (int kk = 0; kk < nb; kk++) {
+
+    lu0(A(kk, kk).get());
+
+    for (int jj = kk + 1; jj < nb; jj++) {
+      if (A(kk, jj)) {
+        fwd(A(kk, kk).get(), A(kk, jj).get());
+      }
+    }
+
+    for (int ii = kk + 1; ii < nb; ii++) {
+      if (A(ii, kk)) {
+        bdiv(A(kk, kk).get(), A(ii, kk).get());
+      }
+    }
+
+    for (int ii = kk + 1; ii < nb; ii++) {
+      if (A(ii, kk)) {
+        for (int jj = kk + 1; jj < nb; jj++) {
+          if (A(kk, jj)) {
+            if (!A(ii, jj)) {
+              A(ii, jj) = allocate_clean_block();
+            }
+            bmod(A(ii, kk).get(), A(kk, jj).get(), A(ii, jj).get());
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Compare against a sequential factorization with the BOTS tolerance.
+ */
+inline auto sparselu_check(sparse_matrix const &A) -> bool {
+
+  sparse_matrix B = sparselu_init(A.n);
+
+  sparselu_seq(B);
+
+  for (int ii = 0; ii < A.n; ii++) {
+    for (int jj = 0; jj < A.n; jj++) {
+
+      if (!A(ii, jj) != !B(ii, jj)) {
+        return false;
+      }
+
+      if (!A(ii, jj)) {
+        continue;
+      }
+
+      for (int i = 0; i < sparselu_size * sparselu_size; i++) {
+
+        float r = A(ii, jj)[i];
+        float s = B(ii, jj)[i];
+
+        float diff = std::abs(r - s);
+        float rel = s == 0.0F ? diff : diff / std::abs(s);
+
+        if (rel > 1e-6F && diff > 1e-6F) {
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+#endif /* D3B7E1A9_6C2F_4E85_9A10_5F8E4C7B2D61 */
@@ -0,0 +1,113 @@
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include <libfork.hpp>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+using namespace lf;
+
+constexpr auto fwd_task = [](auto, float const *diag, float *col) LF_STATIC_CALL -> task<> {
+  fwd(diag, col);
+  co_return;
+};
+
+constexpr auto bdiv_task = [](auto, float const *diag, float *row) LF_STATIC_CALL -> task<> {
+  bdiv(diag, row);
+  co_return;
+};
+
+constexpr auto bmod_task = [](auto, float const *row, float const *col, block *inner)
+                               LF_STATIC_CALL -> task<> {
+  if (!*inner) {
+    *inner = allocate_clean_block();
+  }
+  bmod(row, col, inner->get());
+  co_return;
+};
+
+constexpr auto sparselu = [](auto, sparse_matrix *mat) LF_STATIC_CALL -> task<> {
+  //
+  sparse_matrix &A = *mat;
+
+  int nb = A.n;
+
+  for (int kk = 0; kk < nb; kk++) {
+
+    lu0(A(kk, kk).get());
+
+    for (int jj = kk + 1; jj < nb; jj++) {
+      if (A(kk, jj)) {
+        co_await lf::fork(fwd_task)(A(kk, kk).get(), A(kk, jj).get());
+      }
+    }
+
+    for (int ii = kk + 1; ii < nb; ii++) {
+      if (A(ii, kk)) {
+        co_await lf::fork(bdiv_task)(A(kk, kk).get(), A(ii, kk).get());
+      }
+    }
+
+    co_await lf::join;
+
+    for (int ii = kk + 1; ii < nb; ii++) {
+      if (A(ii, kk)) {
+        for (int jj = kk + 1; jj < nb; jj++) {
+          if (A(kk, jj)) {
+            co_await lf::fork(bmod_task)(A(ii, kk).get(), A(kk, jj).get(), &A(ii, jj));
+          }
+        }
+      }
+    }
+
+    co_await lf::join;
+  }
+};
+
+template <lf::scheduler Sch, lf::numa_strategy Strategy>
+void sparselu_libfork(benchmark::State &state) {
+
+  state.counters["green_threads"] = state.range(0);
+  state.counters["sparselu(NB)"] = sparselu_blocks;
+  state.counters["sparselu(BS)"] = sparselu_size;
+
+  Sch sch = [&] {
+    if constexpr (std::constructible_from<Sch, int>) {
+      return Sch(state.range(0));
+    } else {
+      return Sch{};
+    }
+  }();
+
+  peak_memory mem{state, sch};
+
+  sparse_matrix A{0};
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    A = sparselu_init();
+    state.ResumeTiming();
+
+    lf::sync_wait(sch, sparselu, &A);
+  }
+
+#ifndef LF_NO_CHECK
+  if (!sparselu_check(A)) {
+    std::cerr << "lf wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+using namespace lf;
+
+BENCHMARK(sparselu_libfork<lazy_pool, numa_strategy::seq>)->Apply(targs)->UseRealTime();
+BENCHMARK(sparselu_libfork<lazy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
+
+BENCHMARK(sparselu_libfork<busy_pool, numa_strategy::seq>)->Apply(targs)->UseRealTime();
+BENCHMARK(sparselu_libfork<busy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
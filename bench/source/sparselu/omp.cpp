@@ -0,0 +1,85 @@
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+void sparselu(sparse_matrix &A) {
+
+  int nb = A.n;
+
+  for (int kk = 0; kk < nb; kk++) {
+
+    lu0(A(kk, kk).get());
+
+    for (int jj = kk + 1; jj < nb; jj++) {
+      if (A(kk, jj)) {
+#pragma omp task untied firstprivate(kk, jj) shared(A) default(none)
+        fwd(A(kk, kk).get(), A(kk, jj).get());
+      }
+    }
+
+    for (int ii = kk + 1; ii < nb; ii++) {
+      if (A(ii, kk)) {
+#pragma omp task untied firstprivate(kk, ii) shared(A) default(none)
+        bdiv(A(kk, kk).get(), A(ii, kk).get());
+      }
+    }
+
+#pragma omp taskwait
+
+    for (int ii = kk + 1; ii < nb; ii++) {
+      if (A(ii, kk)) {
+        for (int jj = kk + 1; jj < nb; jj++) {
+          if (A(kk, jj)) {
+#pragma omp task untied firstprivate(kk, jj, ii) shared(A) default(none)
+            {
+              if (!A(ii, jj)) {
+                A(ii, jj) = allocate_clean_block();
+              }
+              bmod(A(ii, kk).get(), A(kk, jj).get(), A(ii, jj).get());
+            }
+          }
+        }
+      }
+    }
+
+#pragma omp taskwait
+  }
+}
+
+void sparselu_omp(benchmark::State &state) {
+
+  state.counters["green_threads"] = state.range(0);
+  state.counters["sparselu(NB)"] = sparselu_blocks;
+  state.counters["sparselu(BS)"] = sparselu_size;
+
+  peak_memory mem{state};
+
+  std::size_t n = state.range(0);
+
+  sparse_matrix A{0};
+
+#pragma omp parallel num_threads(n)
+#pragma omp single
+  for (auto _ : state) {
+    state.PauseTiming();
+    A = sparselu_init();
+    state.ResumeTiming();
+
+    sparselu(A);
+  }
+
+#ifndef LF_NO_CHECK
+  if (!sparselu_check(A)) {
+    std::cerr << "omp wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(sparselu_omp)->Apply(targs)->UseRealTime();
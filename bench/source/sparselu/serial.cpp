@@ -0,0 +1,37 @@
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+void sparselu_serial(benchmark::State &state) {
+
+  state.counters["green_threads"] = 1;
+  state.counters["sparselu(NB)"] = sparselu_blocks;
+  state.counters["sparselu(BS)"] = sparselu_size;
+
+  peak_memory mem{state};
+
+  sparse_matrix A{0};
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    A = sparselu_init();
+    state.ResumeTiming();
+
+    sparselu_seq(A);
+  }
+
+#ifndef LF_NO_CHECK
+  if (!sparselu_check(A)) {
+    std::cerr << "serial wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(sparselu_serial)->UseRealTime();
@@ -0,0 +1,92 @@
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+void sparselu(sparse_matrix &A) {
+
+  int nb = A.n;
+
+  tbb::task_group g;
+
+  for (int kk = 0; kk < nb; kk++) {
+
+    lu0(A(kk, kk).get());
+
+    for (int jj = kk + 1; jj < nb; jj++) {
+      if (A(kk, jj)) {
+        g.run([&A, kk, jj] {
+          fwd(A(kk, kk).get(), A(kk, jj).get());
+        });
+      }
+    }
+
+    for (int ii = kk + 1; ii < nb; ii++) {
+      if (A(ii, kk)) {
+        g.run([&A, kk, ii] {
+          bdiv(A(kk, kk).get(), A(ii, kk).get());
+        });
+      }
+    }
+
+    g.wait();
+
+    for (int ii = kk + 1; ii < nb; ii++) {
+      if (A(ii, kk)) {
+        for (int jj = kk + 1; jj < nb; jj++) {
+          if (A(kk, jj)) {
+            g.run([&A, kk, ii, jj] {
+              if (!A(ii, jj)) {
+                A(ii, jj) = allocate_clean_block();
+              }
+              bmod(A(ii, kk).get(), A(kk, jj).get(), A(ii, jj).get());
+            });
+          }
+        }
+      }
+    }
+
+    g.wait();
+  }
+}
+
+void sparselu_tbb(benchmark::State &state) {
+
+  state.counters["green_threads"] = state.range(0);
+  state.counters["sparselu(NB)"] = sparselu_blocks;
+  state.counters["sparselu(BS)"] = sparselu_size;
+
+  peak_memory mem{state};
+
+  std::size_t n = state.range(0);
+  tbb::task_arena arena(n);
+
+  sparse_matrix A{0};
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    A = sparselu_init();
+    state.ResumeTiming();
+
+    arena.execute([&] {
+      sparselu(A);
+    });
+  }
+
+#ifndef LF_NO_CHECK
+  if (!sparselu_check(A)) {
+    std::cerr << "tbb wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(sparselu_tbb)->Apply(targs)->UseRealTime();
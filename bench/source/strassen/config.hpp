@@ -0,0 +1,199 @@
+#ifndef A6F2C8D4_1B7E_4F39_8C05_E3D9B1A7F624
+#define A6F2C8D4_1B7E_4F39_8C05_E3D9B1A7F624
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <vector>
+
+/**
+ * Strassen's matrix multiplication, after the BOTS strassen kernel.
+ *
+ * Each level allocates temporaries for the seven sub-products hence, this is deep and memory-heavy
+ * compared to the in-place matmul benchmark.
+ */
+
+inline constexpr std::size_t strassen_work = 1024;
+inline constexpr std::size_t strassen_cutoff = 64;
+
+static_assert(std::has_single_bit(strassen_work));
+
+/**
+ * @brief A non-owning, row-major view of a square (sub) matrix.
+ */
+struct mview {
+  double *data;
+  std::size_t stride;
+
+  auto operator()(std::size_t i, std::size_t j) const -> double & { return data[i * stride + j]; }
+
+  /**
+   * @brief The `m x m` sub-matrix at block (i, j).
+   */
+  auto block(std::size_t i, std::size_t j, std::size_t m) const -> mview {
+    return {data + i * m * stride + j * m, stride};
+  }
+};
+
+/**
+ * @brief Number of `m x m` temporaries needed per level of the recursion.
+ */
+inline constexpr std::size_t strassen_temps = 17;
+
+/**
+ * @brief Naive multiply, `C = A * B` for the leaves of the recursion.
+ */
+inline void strassen_leaf(mview A, mview B, mview C, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t j = 0; j < n; j++) {
+      C(i, j) = 0;
+    }
+    for (std::size_t k = 0; k < n; k++) {
+      double a = A(i, k);
+      for (std::size_t j = 0; j < n; j++) {
+        C(i, j) += a * B(k, j);
+      }
+    }
+  }
+}
+
+/**
+ * @brief A single multiplication `dst = lhs * rhs` of the seven sub-products.
+ */
+struct strassen_product {
+  mview lhs;
+  mview rhs;
+  mview dst;
+};
+
+/**
+ * @brief Compute the operand sums of one level, `tmp` must hold `strassen_temps * m * m` doubles.
+ *
+ * Returns the seven products that must be computed before `strassen_combine`.
+ */
+inline auto strassen_split(mview A, mview B, std::size_t n, double *tmp) -> std::array<strassen_product, 7> {
+
+  std::size_t m = n / 2;
+
+  auto next = [&, k = std::size_t{0}]() mutable -> mview {
+    return {tmp + m * m * k++, m};
+  };
+
+  mview A11 = A.block(0, 0, m), A12 = A.block(0, 1, m), A21 = A.block(1, 0, m), A22 = A.block(1, 1, m);
+  mview B11 = B.block(0, 0, m), B12 = B.block(0, 1, m), B21 = B.block(1, 0, m), B22 = B.block(1, 1, m);
+
+  mview S1 = next(), S2 = next(), S5 = next(), S6 = next(), S7 = next();
+  mview T1 = next(), T3 = next(), T4 = next(), T6 = next(), T7 = next();
+
+  for (std::size_t i = 0; i < m; i++) {
+    for (std::size_t j = 0; j < m; j++) {
+      S1(i, j) = A11(i, j) + A22(i, j);
+      S2(i, j) = A21(i, j) + A22(i, j);
+      S5(i, j) = A11(i, j) + A12(i, j);
+      S6(i, j) = A21(i, j) - A11(i, j);
+      S7(i, j) = A12(i, j) - A22(i, j);
+      T1(i, j) = B11(i, j) + B22(i, j);
+      T3(i, j) = B12(i, j) - B22(i, j);
+      T4(i, j) = B21(i, j) - B11(i, j);
+      T6(i, j) = B11(i, j) + B12(i, j);
+      T7(i, j) = B21(i, j) + B22(i, j);
+    }
+  }
+
+  return {{
+      {S1, T1, next()},
+      {S2, B11, next()},
+      {A11, T3, next()},
+      {A22, T4, next()},
+      {S5, B22, next()},
+      {S6, T6, next()},
+      {S7, T7, next()},
+  }};
+}
+
+/**
+ * @brief Combine the seven products into `C`.
+ */
+inline void strassen_combine(std::array<strassen_product, 7> const &p, mview C, std::size_t n) {
+
+  std::size_t m = n / 2;
+
+  mview M1 = p[0].dst, M2 = p[1].dst, M3 = p[2].dst, M4 = p[3].dst, M5 = p[4].dst, M6 = p[5].dst,
+        M7 = p[6].dst;
+
+  mview C11 = C.block(0, 0, m), C12 = C.block(0, 1, m), C21 = C.block(1, 0, m), C22 = C.block(1, 1, m);
+
+  for (std::size_t i = 0; i < m; i++) {
+    for (std::size_t j = 0; j < m; j++) {
+      C11(i, j) = M1(i, j) + M4(i, j) - M5(i, j) + M7(i, j);
+      C12(i, j) = M3(i, j) + M5(i, j);
+      C21(i, j) = M2(i, j) + M4(i, j);
+      C22(i, j) = M1(i, j) - M2(i, j) + M3(i, j) + M6(i, j);
+    }
+  }
+}
+
+struct strassen_args {
+  std::vector<double> A;
+  std::vector<double> B;
+  std::vector<double> C;
+  std::size_t n;
+};
+
+inline auto strassen_init(std::size_t n = strassen_work) -> strassen_args {
+
+  std::mt19937_64 rng{42};
+  std::uniform_real_distribution<double> dist{-1, 1};
+
+  strassen_args args{std::vector<double>(n * n), std::vector<double>(n * n), std::vector<double>(n * n), n};
+
+  for (std::size_t i = 0; i < n * n; i++) {
+    args.A[i] = dist(rng);
+    args.B[i] = dist(rng);
+  }
+
+  return args;
+}
+
+/**
+ * @brief Freivalds' check, compare `C x` with `A (B x)` for a random `x`.
+ */
+inline auto strassen_check(strassen_args const &args) -> bool {
+
+  std::size_t n = args.n;
+
+  std::mt19937_64 rng{7};
+  std::uniform_real_distribution<double> dist{-1, 1};
+
+  std::vector<double> x(n);
+
+  for (auto &elem : x) {
+    elem = dist(rng);
+  }
+
+  auto mul = [n](std::vector<double> const &M, std::vector<double> const &v) {
+    std::vector<double> out(n);
+    for (std::size_t i = 0; i < n; i++) {
+      for (std::size_t j = 0; j < n; j++) {
+        out[i] += M[i * n + j] * v[j];
+      }
+    }
+    return out;
+  };
+
+  std::vector<double> lhs = mul(args.C, x);
+  std::vector<double> rhs = mul(args.A, mul(args.B, x));
+
+  for (std::size_t i = 0; i < n; i++) {
+    if (std::abs(lhs[i] - rhs[i]) > 1e-6 * static_cast<double>(n)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+#endif /* A6F2C8D4_1B7E_4F39_8C05_E3D9B1A7F624 */
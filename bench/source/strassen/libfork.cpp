@@ -0,0 +1,79 @@
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include <libfork.hpp>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+using namespace lf;
+
+constexpr auto strassen = [](auto strassen, mview A, mview B, mview C, std::size_t n)
+                              LF_STATIC_CALL -> task<> {
+  //
+  if (n <= strassen_cutoff) {
+    co_return strassen_leaf(A, B, C, n);
+  }
+
+  std::size_t m = n / 2;
+
+  // Temporaries live on the worker's stack, freed when this task returns.
+  auto [tmp] = co_await lf::co_new<double>(strassen_temps * m * m);
+
+  auto prod = strassen_split(A, B, n, tmp.data());
+
+  for (std::size_t i = 0; i < prod.size() - 1; i++) {
+    co_await lf::fork(strassen)(prod[i].lhs, prod[i].rhs, prod[i].dst, m);
+  }
+
+  co_await lf::call(strassen)(prod.back().lhs, prod.back().rhs, prod.back().dst, m);
+
+  co_await lf::join;
+
+  strassen_combine(prod, C, n);
+};
+
+template <lf::scheduler Sch, lf::numa_strategy Strategy>
+void strassen_libfork(benchmark::State &state) {
+
+  state.counters["green_threads"] = state.range(0);
+  state.counters["mat NxN"] = strassen_work;
+
+  Sch sch = [&] {
+    if constexpr (std::constructible_from<Sch, int>) {
+      return Sch(state.range(0));
+    } else {
+      return Sch{};
+    }
+  }();
+
+  peak_memory mem{state, sch};
+
+  auto args = strassen_init();
+
+  std::size_t n = args.n;
+
+  for (auto _ : state) {
+    lf::sync_wait(sch, strassen, mview{args.A.data(), n}, mview{args.B.data(), n}, mview{args.C.data(), n},
+                  n);
+  }
+
+#ifndef LF_NO_CHECK
+  if (!strassen_check(args)) {
+    std::cerr << "lf wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+using namespace lf;
+
+BENCHMARK(strassen_libfork<lazy_pool, numa_strategy::seq>)->Apply(targs)->UseRealTime();
+BENCHMARK(strassen_libfork<lazy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
+
+BENCHMARK(strassen_libfork<busy_pool, numa_strategy::seq>)->Apply(targs)->UseRealTime();
+BENCHMARK(strassen_libfork<busy_pool, numa_strategy::fan>)->Apply(targs)->UseRealTime();
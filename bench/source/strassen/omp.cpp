@@ -0,0 +1,63 @@
+#include <iostream>
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+void strassen(mview A, mview B, mview C, std::size_t n) {
+
+  if (n <= strassen_cutoff) {
+    return strassen_leaf(A, B, C, n);
+  }
+
+  std::size_t m = n / 2;
+
+  auto tmp = std::make_unique_for_overwrite<double[]>(strassen_temps * m * m);
+
+  auto prod = strassen_split(A, B, n, tmp.get());
+
+  for (std::size_t i = 0; i < prod.size() - 1; i++) {
+#pragma omp task untied firstprivate(i, m) shared(prod) default(none)
+    strassen(prod[i].lhs, prod[i].rhs, prod[i].dst, m);
+  }
+
+  strassen(prod.back().lhs, prod.back().rhs, prod.back().dst, m);
+
+#pragma omp taskwait
+
+  strassen_combine(prod, C, n);
+}
+
+void strassen_omp(benchmark::State &state) {
+
+  state.counters["green_threads"] = state.range(0);
+  state.counters["mat NxN"] = strassen_work;
+
+  peak_memory mem{state};
+
+  std::size_t n_thr = state.range(0);
+
+  auto args = strassen_init();
+
+  std::size_t n = args.n;
+
+#pragma omp parallel num_threads(n_thr)
+#pragma omp single
+  for (auto _ : state) {
+    strassen({args.A.data(), n}, {args.B.data(), n}, {args.C.data(), n}, n);
+  }
+
+#ifndef LF_NO_CHECK
+  if (!strassen_check(args)) {
+    std::cerr << "omp wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(strassen_omp)->Apply(targs)->UseRealTime();
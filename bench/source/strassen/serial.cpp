@@ -0,0 +1,54 @@
+#include <iostream>
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+void strassen(mview A, mview B, mview C, std::size_t n) {
+
+  if (n <= strassen_cutoff) {
+    return strassen_leaf(A, B, C, n);
+  }
+
+  std::size_t m = n / 2;
+
+  auto tmp = std::make_unique_for_overwrite<double[]>(strassen_temps * m * m);
+
+  auto prod = strassen_split(A, B, n, tmp.get());
+
+  for (auto const &[lhs, rhs, dst] : prod) {
+    strassen(lhs, rhs, dst, m);
+  }
+
+  strassen_combine(prod, C, n);
+}
+
+void strassen_serial(benchmark::State &state) {
+
+  state.counters["green_threads"] = 1;
+  state.counters["mat NxN"] = strassen_work;
+
+  peak_memory mem{state};
+
+  auto args = strassen_init();
+
+  std::size_t n = args.n;
+
+  for (auto _ : state) {
+    strassen({args.A.data(), n}, {args.B.data(), n}, {args.C.data(), n}, n);
+  }
+
+#ifndef LF_NO_CHECK
+  if (!strassen_check(args)) {
+    std::cerr << "serial wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(strassen_serial)->UseRealTime();
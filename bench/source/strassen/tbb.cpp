@@ -0,0 +1,70 @@
+#include <iostream>
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+#include "../util.hpp"
+#include "config.hpp"
+
+namespace {
+
+void strassen(mview A, mview B, mview C, std::size_t n) {
+
+  if (n <= strassen_cutoff) {
+    return strassen_leaf(A, B, C, n);
+  }
+
+  std::size_t m = n / 2;
+
+  auto tmp = std::make_unique_for_overwrite<double[]>(strassen_temps * m * m);
+
+  auto prod = strassen_split(A, B, n, tmp.get());
+
+  tbb::task_group g;
+
+  for (std::size_t i = 0; i < prod.size() - 1; i++) {
+    g.run([&prod, i, m] {
+      strassen(prod[i].lhs, prod[i].rhs, prod[i].dst, m);
+    });
+  }
+
+  strassen(prod.back().lhs, prod.back().rhs, prod.back().dst, m);
+
+  g.wait();
+
+  strassen_combine(prod, C, n);
+}
+
+void strassen_tbb(benchmark::State &state) {
+
+  state.counters["green_threads"] = state.range(0);
+  state.counters["mat NxN"] = strassen_work;
+
+  peak_memory mem{state};
+
+  std::size_t n_thr = state.range(0);
+  tbb::task_arena arena(n_thr);
+
+  auto args = strassen_init();
+
+  std::size_t n = args.n;
+
+  for (auto _ : state) {
+    arena.execute([&] {
+      strassen({args.A.data(), n}, {args.B.data(), n}, {args.C.data(), n}, n);
+    });
+  }
+
+#ifndef LF_NO_CHECK
+  if (!strassen_check(args)) {
+    std::cerr << "tbb wrong answer" << std::endl;
+  }
+#endif
+}
+
+} // namespace
+
+BENCHMARK(strassen_tbb)->Apply(targs)->UseRealTime();
@@ -1,29 +1,125 @@
 #ifndef CE977DFD_3A46_4443_81E7_243C91B6B416
 #define CE977DFD_3A46_4443_81E7_243C91B6B416
 
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 
 inline auto num_threads() noexcept -> int { return static_cast<int>(std::thread::hardware_concurrency()); }
 
-inline void targs(benchmark::internal::Benchmark *bench) {
+/**
+ * @brief The thread counts every parallel benchmark is run at.
+ */
+inline auto thread_counts() -> std::vector<int> {
+
+  std::vector<int> out;
 
   for (auto &&elem : {1, 2, 4, 8, 16, 24, 32, 40, 48, 56, 64}) {
     if (elem > num_threads()) {
-      return;
+      return out;
     }
-    bench->Arg(elem);
+    out.push_back(elem);
   }
 
   int count = 64 + 16;
 
   while (count <= num_threads()) {
-    bench->Arg(count);
+    out.push_back(count);
     count += 16;
   }
+
+  return out;
+}
+
+inline void targs(benchmark::internal::Benchmark *bench) {
+  for (int elem : thread_counts()) {
+    bench->Arg(elem);
+  }
+}
+
+/**
+ * @brief Reset the peak resident set size of this process to its current RSS.
+ *
+ * Needs Linux >= 4.0, elsewhere the peak is not reset and peak_rss() is the peak since the process started.
+ */
+inline void reset_peak_rss() noexcept {
+  std::ofstream("/proc/self/clear_refs") << "5";
 }
 
+/**
+ * @brief The peak resident set size (VmHWM) of this process in bytes, zero if unknown.
+ */
+inline auto peak_rss() -> std::size_t {
+
+  std::ifstream status("/proc/self/status");
+
+  for (std::string line; std::getline(status, line);) {
+    if (line.starts_with("VmHWM:")) {
+      return std::stoul(line.substr(6)) * 1024; // Reported in kB.
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Report the memory used by a benchmark next to its time.
+ *
+ * Construct before the setup of a benchmark, the peak RSS since construction is recorded in the
+ * ``peak_rss`` counter on destruction. Given a libfork pool the (summed over workers) bytes in stacklets,
+ * ``stack_bytes``, and their high-water mark, ``stack_peak``, are also recorded.
+ */
+class peak_memory {
+ public:
+  explicit peak_memory(benchmark::State &state) : m_state(state) { reset_peak_rss(); }
+
+  template <typename Sch>
+    requires requires (Sch const &sch) { sch.memory_report(); }
+  peak_memory(benchmark::State &state, Sch const &sch) : peak_memory(state) {
+    m_extra = [&sch](benchmark::State &out) {
+      std::size_t bytes = 0;
+      std::size_t peak = 0;
+
+      for (auto const &worker : sch.memory_report()) {
+        bytes += worker.stack_bytes;
+        peak += worker.stack_high_water;
+      }
+
+      out.counters["stack_bytes"] = bytes_counter(bytes);
+      out.counters["stack_peak"] = bytes_counter(peak);
+    };
+  }
+
+  /**
+   * @brief Schedulers without a memory report only get the peak RSS.
+   */
+  template <typename Sch>
+  peak_memory(benchmark::State &state, Sch const & /* unused */) : peak_memory(state) {}
+
+  peak_memory(peak_memory const &) = delete;
+  auto operator=(peak_memory const &) -> peak_memory & = delete;
+
+  ~peak_memory() {
+    m_state.counters["peak_rss"] = bytes_counter(peak_rss());
+    if (m_extra) {
+      m_extra(m_state);
+    }
+  }
+
+ private:
+  static auto bytes_counter(std::size_t bytes) -> benchmark::Counter {
+    return {static_cast<double>(bytes), benchmark::Counter::kDefaults, benchmark::Counter::kIs1024};
+  }
+
+  benchmark::State &m_state;
+  std::function<void(benchmark::State &)> m_extra;
+};
+
 /**
  * @brief Tidy up warnings.
  */
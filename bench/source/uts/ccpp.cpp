@@ -64,6 +64,8 @@ auto uts(executor_tag, thread_pool_executor *tpe, int depth, Node *parent) -> co
 void uts_ccpp(benchmark::State &state, int tree) {
   state.counters["green_threads"] = state.range(0);
 
+  peak_memory mem{state};
+
   setup_tree(tree);
 
   volatile int depth = 0;
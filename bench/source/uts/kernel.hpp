@@ -0,0 +1,56 @@
+#ifndef C7A1E5F3_8D2B_4F6C_A0E9_3B5D7F1C4A82
+#define C7A1E5F3_8D2B_4F6C_A0E9_3B5D7F1C4A82
+
+#include <libfork.hpp>
+
+#include "config.hpp"
+#include "external/uts.h"
+
+/**
+ * @brief The libfork UTS kernel, shared by the UTS and cotenancy benchmarks.
+ */
+inline constexpr auto uts = [](auto uts, int depth, Node *parent) LF_STATIC_CALL -> lf::task<result> {
+  //
+  result r(depth, 1, 0);
+
+  int num_children = uts_numChildren(parent);
+  int child_type = uts_childType(parent);
+
+  parent->numChildren = num_children;
+
+  if (num_children > 0) {
+
+    auto [cs] = co_await lf::co_new<pair>(num_children);
+
+    for (int i = 0; i < num_children; i++) {
+
+      cs[i].child.type = child_type;
+      cs[i].child.height = parent->height + 1;
+      cs[i].child.numChildren = -1; // not yet determined
+
+      for (int j = 0; j < computeGranularity; j++) {
+        rng_spawn(parent->state.state, cs[i].child.state.state, i);
+      }
+
+      if (i + 1 == num_children) {
+        co_await lf::call(&cs[i].res, uts)(depth + 1, &cs[i].child);
+      } else {
+        co_await lf::fork(&cs[i].res, uts)(depth + 1, &cs[i].child);
+      }
+    }
+
+    co_await lf::join;
+
+    for (auto &&elem : cs) {
+      r.maxdepth = max(r.maxdepth, elem.res.maxdepth);
+      r.size += elem.res.size;
+      r.leaves += elem.res.leaves;
+    }
+
+  } else {
+    r.leaves = 1;
+  }
+  co_return r;
+};
+
+#endif /* C7A1E5F3_8D2B_4F6C_A0E9_3B5D7F1C4A82 */
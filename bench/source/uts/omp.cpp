@@ -62,6 +62,8 @@ void uts_omp(benchmark::State &state, int tree) {
 
   state.counters["green_threads"] = state.range(0);
 
+  peak_memory mem{state};
+
   std::size_t n = state.range(0);
 
   setup_tree(tree);
@@ -74,6 +74,8 @@ void uts_serial(benchmark::State &state, int tree) {
 
   state.counters["green_threads"] = 1;
 
+  peak_memory mem{state};
+
   Node root;
 
   setup_tree(tree);
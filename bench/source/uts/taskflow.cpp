@@ -61,6 +61,8 @@ void uts_ztaskflow(benchmark::State &state, int tree) {
 
   state.counters["green_threads"] = state.range(0);
 
+  peak_memory mem{state};
+
   std::size_t n = state.range(0);
   tf::Executor executor(n);
   tf::Taskflow taskflow;
@@ -67,6 +67,8 @@ auto uts(int depth, Node *parent) -> result {
 
 void uts_tbb(benchmark::State &state, int tree) {
 
+  peak_memory mem{state};
+
   // TBB uses (2MB) stacks by default
   tbb::global_control global_limit(tbb::global_control::thread_stack_size, 128 * 1024 * 1024);
 
@@ -59,6 +59,8 @@ void uts_tmc(benchmark::State &state, int tree) {
 
   state.counters["green_threads"] = state.range(0);
 
+  peak_memory mem{state};
+
   setup_tree(tree);
 
   volatile int depth = 0;
@@ -10,6 +10,7 @@
 // file, You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "libfork/core.hpp"
+#include "libfork/io.hpp"
 #include "libfork/schedule.hpp"
 
 #include "libfork/algorithm/constraints.hpp"
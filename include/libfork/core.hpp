@@ -20,10 +20,13 @@
 #include "libfork/core/just.hpp"
 #include "libfork/core/macro.hpp"
 #include "libfork/core/scheduler.hpp"
+#include "libfork/core/sender.hpp"
 #include "libfork/core/sync_wait.hpp"
 #include "libfork/core/tag.hpp"
 #include "libfork/core/task.hpp"
 
+#include "libfork/core/ext/async_stack.hpp"
+#include "libfork/core/ext/bounded_deque.hpp"
 #include "libfork/core/ext/context.hpp"
 #include "libfork/core/ext/deque.hpp"
 #include "libfork/core/ext/handles.hpp"
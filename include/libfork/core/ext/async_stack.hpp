@@ -0,0 +1,86 @@
+#ifndef B3F1E0C2_7A4D_4E8B_9C61_2D5A8F40E317
+#define B3F1E0C2_7A4D_4E8B_9C61_2D5A8F40E317
+
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <coroutine> // for coroutine_handle
+#include <cstddef>   // for size_t
+#include <span>      // for span
+
+#include "libfork/core/ext/tls.hpp"    // for has_context, context
+#include "libfork/core/impl/frame.hpp" // for frame
+
+/**
+ * @file async_stack.hpp
+ *
+ * @brief Walk the logical (async) stack of the task running on the current worker.
+ */
+
+namespace lf {
+
+inline namespace ext {
+
+/**
+ * @brief Write the async stack of the task currently running on this thread into `buffer`.
+ *
+ * Returns the prefix of `buffer` that was written, innermost (currently executing) task first, ending at
+ * the root task or when `buffer` is full. The walk follows each task's parent pointer hence, it reports the
+ * chain of tasks that will be resumed as the current task completes, irrespective of which worker's
+ * segmented stack each of them was allocated on.
+ *
+ * This function does not allocate or lock and is async-signal-safe, it is intended to be called from a
+ * ``SIGPROF`` handler by a sampling profiler. Each returned handle's ``address()`` points at the coroutine
+ * frame, the first word of which is (on GCC/Clang/MSVC) the address of the coroutine's resume function and
+ * can be symbolized to recover the task's name.
+ *
+ * \rst
+ *
+ * .. note::
+ *    Task tracking is compiled in only if ``LF_ASYNC_STACK`` is defined, otherwise this always returns an
+ *    empty span. The same is true if the calling thread is not a worker or is not executing a task.
+ *
+ * Example, a ``SIGPROF`` sampler that emits folded stacks for flamegraph.pl/pprof:
+ *
+ * .. include:: ../../../test/source/core/async_stack.cpp
+ *    :code:
+ *    :start-after: // !BEGIN-EXAMPLE
+ *    :end-before: // !END-EXAMPLE
+ *
+ * \endrst
+ */
+inline auto current_task_stack(std::span<std::coroutine_handle<>> buffer) noexcept
+    -> std::span<std::coroutine_handle<>> {
+
+  std::size_t count = 0;
+
+#ifdef LF_ASYNC_STACK
+  if (!impl::tls::has_context) {
+    return buffer.first(0);
+  }
+
+  for (impl::frame *task = impl::tls::context()->running(); task != nullptr && count < buffer.size();) {
+
+    buffer[count++] = task->self();
+
+    if (task->is_root()) {
+      break;
+    }
+
+    task = task->parent();
+  }
+#endif
+
+  return buffer.first(count);
+}
+
+} // namespace ext
+
+} // namespace lf
+
+#endif /* B3F1E0C2_7A4D_4E8B_9C61_2D5A8F40E317 */
@@ -0,0 +1,216 @@
+#ifndef E2A4C7B9_5F1D_4C3E_9A86_2B7D0F6E8C51
+#define E2A4C7B9_5F1D_4C3E_9A86_2B7D0F6E8C51
+
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <algorithm>   // for max
+#include <array>       // for array
+#include <atomic>      // for atomic, atomic_thread_fence, memory_order
+#include <bit>         // for has_single_bit
+#include <concepts>    // for convertible_to, invocable
+#include <cstddef>     // for ptrdiff_t, size_t
+#include <functional>  // for invoke
+#include <type_traits> // for invoke_result_t, is_nothrow_invocable_v
+#include <utility>     // for forward
+
+#include "libfork/core/ext/deque.hpp"    // for dequeable, err, steal_t, return_nullopt
+#include "libfork/core/impl/atomics.hpp" // for light_fence, heavy_fence, asymmetric_fences
+#include "libfork/core/impl/utility.hpp" // for k_cache_line, immovable
+#include "libfork/core/macro.hpp"        // for LF_ASSERT, LF_PROBE
+
+/**
+ * @file bounded_deque.hpp
+ *
+ * @brief A fixed-capacity variant of the Chase-Lev deque with inline storage.
+ */
+
+namespace lf {
+
+inline namespace ext {
+
+/**
+ * @brief A bounded lock-free single-producer multiple-consumer work-stealing deque.
+ *
+ * This is the same algorithm as `lf::ext::deque` but the ring buffer is stored inline hence, there is no
+ * resizing, no retired buffers and no atomic indirection to reach the buffer on ``push()`` or ``steal()``.
+ * Instead, ``push()`` fails if the deque is full and the caller must handle the overflow.
+ *
+ * @tparam T The type of the elements in the deque.
+ * @tparam N The capacity of the deque, must be a power of 2.
+ */
+template <dequeable T, std::size_t N>
+  requires (N > 0 && std::has_single_bit(N))
+class bounded_deque : impl::immovable<bounded_deque<T, N>> {
+ public:
+  /**
+   * @brief The type of the elements in the deque.
+   */
+  using value_type = T;
+  /**
+   * @brief Get the number of elements in the deque.
+   */
+  [[nodiscard]] constexpr auto size() const noexcept -> std::size_t {
+    return static_cast<std::size_t>(ssize());
+  }
+  /**
+   * @brief Get the number of elements in the deque as a signed integer.
+   */
+  [[nodiscard]] constexpr auto ssize() const noexcept -> std::ptrdiff_t {
+    std::ptrdiff_t const bottom = m_bottom.load(relaxed);
+    std::ptrdiff_t const top = m_top.load(relaxed);
+    return std::max(bottom - top, std::ptrdiff_t{0});
+  }
+  /**
+   * @brief Get the capacity of the deque.
+   */
+  [[nodiscard]] static constexpr auto capacity() noexcept -> std::ptrdiff_t { return k_cap; }
+  /**
+   * @brief Always zero, for symmetry with `lf::ext::deque`.
+   */
+  [[nodiscard]] static constexpr auto garbage_capacity() noexcept -> std::ptrdiff_t { return 0; }
+  /**
+   * @brief Check if the deque is empty.
+   */
+  [[nodiscard]] constexpr auto empty() const noexcept -> bool {
+    return m_top.load(relaxed) >= m_bottom.load(relaxed);
+  }
+  /**
+   * @brief Push an item into the deque, returns false (and does nothing) if the deque is full.
+   *
+   * Only the owner thread can insert an item into the deque.
+   */
+  [[nodiscard]] constexpr auto push(T const &val) noexcept -> bool;
+  /**
+   * @brief Pop an item from the deque.
+   *
+   * Only the owner thread can pop out an item from the deque. If the buffer is empty calls `when_empty` and
+   * returns the result. By default, `when_empty` is a no-op that returns a null `std::optional<T>`.
+   */
+  template <std::invocable F = return_nullopt<T>>
+    requires std::convertible_to<T, std::invoke_result_t<F>>
+  constexpr auto pop(F &&when_empty = {}) noexcept(std::is_nothrow_invocable_v<F>) -> std::invoke_result_t<F>;
+  /**
+   * @brief Steal an item from the deque.
+   *
+   * Any threads can try to steal an item from the deque. This operation can fail if the deque is
+   * empty or if another thread simultaneously stole an item from the deque.
+   */
+  [[nodiscard]] constexpr auto steal() noexcept -> steal_t<T>;
+  /**
+   * @brief Write to every slot of the buffer such that the first pushes do not page fault.
+   *
+   * This must be called by the owner while the deque is empty.
+   */
+  constexpr void prefault() noexcept {
+    LF_ASSERT(empty());
+    for (std::atomic<T> &slot : m_buf) {
+      slot.store(T{}, relaxed);
+    }
+  }
+
+ private:
+  static constexpr std::ptrdiff_t k_cap = static_cast<std::ptrdiff_t>(N);
+  static constexpr std::ptrdiff_t k_mask = k_cap - 1;
+
+  alignas(impl::k_cache_line) std::atomic<std::ptrdiff_t> m_top = 0;
+  alignas(impl::k_cache_line) std::atomic<std::ptrdiff_t> m_bottom = 0;
+  alignas(impl::k_cache_line) std::array<std::atomic<T>, N> m_buf;
+
+  // Convenience aliases.
+  static constexpr std::memory_order relaxed = std::memory_order_relaxed;
+  static constexpr std::memory_order acquire = std::memory_order_acquire;
+  static constexpr std::memory_order release = std::memory_order_release;
+  static constexpr std::memory_order seq_cst = std::memory_order_seq_cst;
+};
+
+template <dequeable T, std::size_t N>
+  requires (N > 0 && std::has_single_bit(N))
+constexpr auto bounded_deque<T, N>::push(T const &val) noexcept -> bool {
+
+  std::ptrdiff_t const bottom = m_bottom.load(relaxed);
+  std::ptrdiff_t const top = m_top.load(acquire);
+
+  if (bottom - top >= k_cap) {
+    return false;
+  }
+
+  // As in deque::push, no one can steal this slot until we publish the new bottom.
+  m_buf[static_cast<std::size_t>(bottom & k_mask)].store(val, relaxed);
+
+  std::atomic_thread_fence(release);
+  m_bottom.store(bottom + 1, relaxed);
+
+  return true;
+}
+
+template <dequeable T, std::size_t N>
+  requires (N > 0 && std::has_single_bit(N))
+template <std::invocable F>
+  requires std::convertible_to<T, std::invoke_result_t<F>>
+constexpr auto bounded_deque<T, N>::pop(F &&when_empty) noexcept(std::is_nothrow_invocable_v<F>)
+    -> std::invoke_result_t<F> {
+
+  std::ptrdiff_t const bottom = m_bottom.load(relaxed) - 1;
+  m_bottom.store(bottom, relaxed); // Stealers can no longer steal.
+
+  impl::light_fence(); // Pairs with the heavy fence in steal().
+
+  std::ptrdiff_t top = m_top.load(relaxed);
+
+  if (top <= bottom) {
+    // Non-empty deque
+    if (top == bottom) {
+      // The last item could get stolen, by a stealer that loaded bottom before our write above.
+      if (!m_top.compare_exchange_strong(top, top + 1, seq_cst, relaxed)) {
+        // Failed race, thief got the last item.
+        m_bottom.store(bottom + 1, relaxed);
+        return std::invoke(std::forward<F>(when_empty));
+      }
+      m_bottom.store(bottom + 1, relaxed);
+    }
+    return m_buf[static_cast<std::size_t>(bottom & k_mask)].load(relaxed);
+  }
+  m_bottom.store(bottom + 1, relaxed);
+  return std::invoke(std::forward<F>(when_empty));
+}
+
+template <dequeable T, std::size_t N>
+  requires (N > 0 && std::has_single_bit(N))
+constexpr auto bounded_deque<T, N>::steal() noexcept -> steal_t<T> {
+
+  std::ptrdiff_t top = m_top.load(acquire);
+
+  if (impl::asymmetric_fences() && top >= m_bottom.load(relaxed)) {
+    LF_PROBE(steal_failure, this, static_cast<int>(err::empty));
+    return {.code = err::empty, .val = {}};
+  }
+
+  impl::heavy_fence();
+  std::ptrdiff_t const bottom = m_bottom.load(acquire);
+
+  if (top < bottom) {
+    // The owner can only overwrite this slot after top has moved past it, in which case our CAS fails.
+    T tmp = m_buf[static_cast<std::size_t>(top & k_mask)].load(relaxed);
+
+    if (!m_top.compare_exchange_strong(top, top + 1, seq_cst, relaxed)) {
+      LF_PROBE(steal_failure, this, static_cast<int>(err::lost));
+      return {.code = err::lost, .val = {}};
+    }
+    LF_PROBE(steal_success, this, bottom - top);
+    return {.code = err::none, .val = tmp};
+  }
+  LF_PROBE(steal_failure, this, static_cast<int>(err::empty));
+  return {.code = err::empty, .val = {}};
+}
+
+} // namespace ext
+
+} // namespace lf
+
+#endif /* E2A4C7B9_5F1D_4C3E_9A86_2B7D0F6E8C51 */
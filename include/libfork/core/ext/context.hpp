@@ -9,15 +9,23 @@
 // License, v. 2.0. If a copy of the MPL was not distributed with this
 // file, You can obtain one at https://mozilla.org/MPL/2.0/.
 
+#include <algorithm>  // for max
+#include <atomic>     // for atomic, memory_order_relaxed
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t
 #include <functional> // for function
+#include <thread>     // for yield
 #include <utility>    // for move
+#include <vector>     // for vector
 #include <version>    // for __cpp_lib_move_only_function
 
-#include "libfork/core/ext/deque.hpp"    // for deque, steal_t
-#include "libfork/core/ext/handles.hpp"  // for task_handle, submit_handle, submit_t
-#include "libfork/core/ext/list.hpp"     // for intrusive_list
-#include "libfork/core/impl/utility.hpp" // for non_null, immovable
-#include "libfork/core/macro.hpp"        // for LF_ASSERT
+#include "libfork/core/ext/bounded_deque.hpp" // for bounded_deque
+#include "libfork/core/ext/deque.hpp"         // for deque, steal_t, err
+#include "libfork/core/ext/handles.hpp"       // for task_handle, submit_handle, submit_t
+#include "libfork/core/ext/list.hpp"          // for intrusive_list
+#include "libfork/core/impl/stack.hpp"        // for stack_usage
+#include "libfork/core/impl/utility.hpp"      // for non_null, immovable
+#include "libfork/core/macro.hpp"             // for LF_ASSERT, LF_FORCEINLINE
 
 /**
  * @file context.hpp
@@ -40,6 +48,20 @@ namespace impl {
 
 class full_context; // Internal API
 
+class frame; // Forward decl for async stack tracking.
+
+/**
+ * @brief The type of a worker's task deque.
+ *
+ * If ``LF_BOUNDED_DEQUE`` is defined (to a power of 2) this is a `lf::ext::bounded_deque` of that capacity,
+ * forks that would overflow it keep their parent private and run the child inline.
+ */
+#ifdef LF_BOUNDED_DEQUE
+using task_deque = bounded_deque<task_handle, LF_BOUNDED_DEQUE>;
+#else
+using task_deque = deque<task_handle>;
+#endif
+
 } // namespace impl
 
 inline namespace ext {
@@ -53,6 +75,42 @@ using nullary_function_t = std::move_only_function<void()>;
 using nullary_function_t = std::function<void()>;
 #endif
 
+/**
+ * @brief A snapshot of the memory held by a worker, see `lf::ext::worker_context::memory`.
+ */
+struct worker_memory {
+  /**
+   * @brief Bytes in the worker's current stacklet chain, including a cached stacklet.
+   *
+   * This is published when the stack grows, when the worker takes ownership of a stack and after each
+   * resumed submission/steal hence, it may lag behind deallocations within a task.
+   */
+  std::size_t stack_bytes;
+  /**
+   * @brief The maximum value of `stack_bytes` that has been published.
+   */
+  std::size_t stack_high_water;
+  /**
+   * @brief Bytes in the ring buffer of the worker's task deque plus the storage of its private deque.
+   */
+  std::size_t deque_bytes;
+  /**
+   * @brief Bytes in ring buffers retired by resizing the worker's task deque, these are not freed until the
+   * worker is destroyed.
+   */
+  std::size_t deque_garbage_bytes;
+  /**
+   * @brief Number of submitted tasks not yet collected by the worker.
+   */
+  std::size_t submit_backlog;
+  /**
+   * @brief The maximum value of `submit_backlog` that has been observed.
+   *
+   * This is sampled when the worker collects its submissions and at the time of the snapshot.
+   */
+  std::size_t submit_high_water;
+};
+
 /**
  * @brief  Context for (extension) schedulers to interact with.
  *
@@ -69,6 +127,9 @@ class worker_context : impl::immovable<context> {
    */
   void schedule(submit_handle jobs) {
 
+    // Count before pushing such that the backlog never underflows, a push is always a single node.
+    m_backlog.fetch_add(1, std::memory_order_relaxed);
+
     m_submit.push(non_null(jobs));
 
     // Once we have pushed if this throws we cannot uphold the strong exception guarantee.
@@ -82,13 +143,164 @@ class worker_context : impl::immovable<context> {
    *
    * If there are no submitted tasks, then returned pointer will be null.
    */
-  [[nodiscard]] auto try_pop_all() noexcept -> submit_handle { return m_submit.try_pop_all(); }
+  [[nodiscard]] auto try_pop_all() noexcept -> submit_handle {
+
+    std::size_t count = 0;
+
+    submit_handle jobs = m_submit.try_pop_all(count);
+
+    if (count > 0) {
+      // The peak is sampled here (by the owner only) hence, it is a plain load/store.
+      std::size_t backlog = m_backlog.fetch_sub(count, std::memory_order_relaxed);
+
+      if (backlog > m_backlog_peak.load(std::memory_order_relaxed)) {
+        m_backlog_peak.store(backlog, std::memory_order_relaxed);
+      }
+    }
+
+    return jobs;
+  }
 
   /**
    * @brief Attempt a steal operation from this contexts task deque, supports concurrent stealing.
+   *
+   * This always fails if the context uses a private deque, see `try_steal(worker_context *)`.
    */
   [[nodiscard]] auto try_steal() noexcept -> steal_t<task_handle> { return m_tasks.steal(); }
 
+  /**
+   * @brief The number of times a thief polls for an answer before it withdraws a steal request.
+   */
+  static constexpr int k_request_patience = 256;
+
+  /**
+   * @brief Attempt a steal operation on behalf of `thief`, supports concurrent stealing.
+   *
+   * The `thief` must be the calling worker's own context and it must have no tasks of its own. If this
+   * context uses a private deque then the thief posts a request to this context's mailbox and waits for
+   * the owner to answer it, at its next fork or join, with its oldest task. If the owner does not answer
+   * promptly (e.g. it is asleep or in a long serial strand) the request is withdrawn and this reports
+   * `lf::err::empty`. Otherwise, this is the same as `try_steal()`.
+   */
+  [[nodiscard]] auto try_steal(worker_context *thief) noexcept -> steal_t<task_handle> {
+    int patience = k_request_patience;
+    return try_steal(thief, patience);
+  }
+
+  /**
+   * @brief As `try_steal(worker_context *)` but the thief's waits are drawn from a shared budget.
+   *
+   * Each time the thief polls for an answer `patience` is decremented, once it reaches zero requests are
+   * withdrawn (or not posted) without waiting. This lets a caller bound the total time spent waiting on
+   * owners across many steal attempts.
+   */
+  [[nodiscard]] auto try_steal(worker_context *thief, int &patience) noexcept -> steal_t<task_handle> {
+
+    if (!m_private) {
+      return m_tasks.steal();
+    }
+
+    LF_ASSERT(thief && thief != this);
+
+    // Thieves could be waiting on us, we have nothing to give them.
+    thief->serve_request();
+
+    if (m_strand.load(std::memory_order_relaxed) % 2 == 0) {
+      return {.code = err::empty, .val = {}}; // The owner is not executing a task hence, has no tasks.
+    }
+
+    if (patience <= 0) {
+      return {.code = err::empty, .val = {}}; // We cannot afford to wait for an answer.
+    }
+
+    worker_context *expect = nullptr;
+
+    if (m_request.load(std::memory_order_relaxed) != nullptr) {
+      return {.code = err::lost, .val = {}};
+    }
+
+    thief->m_answered.store(false, std::memory_order_relaxed);
+
+    if (!m_request.compare_exchange_strong(expect, thief, std::memory_order_release)) {
+      return {.code = err::lost, .val = {}};
+    }
+
+    for (; patience > 0; --patience) {
+      if (thief->m_answered.load(std::memory_order_acquire)) {
+        return thief->take_answer();
+      }
+      thief->serve_request();
+      std::this_thread::yield();
+    }
+
+    expect = thief;
+
+    if (m_request.compare_exchange_strong(expect, nullptr, std::memory_order_relaxed)) {
+      return {.code = err::empty, .val = {}}; // Withdrawn before the owner saw it.
+    }
+
+    // The owner has claimed the request hence, it is about to answer.
+    while (!thief->m_answered.load(std::memory_order_acquire)) {
+      thief->serve_request();
+      std::this_thread::yield();
+    }
+
+    return thief->take_answer();
+  }
+
+  /**
+   * @brief Test if this context uses a private deque, see `lf::ext::worker_init`.
+   */
+  [[nodiscard]] auto private_deque() const noexcept -> bool { return m_private; }
+
+  /**
+   * @brief Get the worker's strand counter, supports concurrent access.
+   *
+   * This is odd while the worker is executing a task and changes each time the worker starts/stops resuming
+   * a task. If ``LF_STALL_DETECTOR`` is defined it also changes each time the worker crosses a fork/join
+   * boundary, then if it is odd and unchanged for a long time the worker is stuck in a single strand of a
+   * task (e.g. blocking I/O or a long serial loop).
+   */
+  [[nodiscard]] auto strand() const noexcept -> std::uint64_t { return m_strand.load(std::memory_order_relaxed); }
+
+#ifdef LF_ASYNC_STACK
+  /**
+   * @brief Get the frame of the task this worker is executing (may be null).
+   *
+   * Only the worker's own thread (e.g. in a signal handler) may dereference this.
+   */
+  [[nodiscard]] auto running() const noexcept -> impl::frame * { return m_running.load(std::memory_order_relaxed); }
+
+  #ifdef LF_STALL_DETECTOR
+  /**
+   * @brief Get the address of the coroutine this worker is executing (may be null), supports concurrent access.
+   *
+   * This is an identifier, it may dangle by the time it is read.
+   */
+  [[nodiscard]] auto running_task() const noexcept -> void * {
+    return m_running_task.load(std::memory_order_relaxed);
+  }
+  #endif
+#endif
+
+  /**
+   * @brief Get a snapshot of the memory held by this worker, supports concurrent access.
+   */
+  [[nodiscard]] auto memory() const noexcept -> worker_memory {
+
+    std::size_t backlog = m_backlog.load(std::memory_order_relaxed);
+
+    return {
+        .stack_bytes = m_stack_usage.bytes.load(std::memory_order_relaxed),
+        .stack_high_water = m_stack_usage.peak.load(std::memory_order_relaxed),
+        .deque_bytes = static_cast<std::size_t>(m_tasks.capacity()) * sizeof(task_handle) +
+                       m_private_bytes.load(std::memory_order_relaxed),
+        .deque_garbage_bytes = static_cast<std::size_t>(m_tasks.garbage_capacity()) * sizeof(task_handle),
+        .submit_backlog = backlog,
+        .submit_high_water = std::max(m_backlog_peak.load(std::memory_order_relaxed), backlog),
+    };
+  }
+
  private:
   friend class impl::full_context;
 
@@ -98,14 +310,49 @@ class worker_context : impl::immovable<context> {
    * Notify is a function that may be called concurrently by other workers to signal to the
    * worker owning this context that a task has been submitted to a private queue.
    */
-  explicit worker_context(nullary_function_t notify) noexcept : m_notify(std::move(notify)) {
+  explicit worker_context(nullary_function_t notify, bool private_deque) noexcept
+      : m_notify(std::move(notify)),
+        m_private(private_deque) {
     LF_ASSERT(m_notify);
   }
 
+  /**
+   * @brief If there is a pending steal request answer it with our oldest private task (or null).
+   *
+   * Only the owner may call this.
+   */
+  void serve_request() noexcept {
+    if (m_request.load(std::memory_order_relaxed) == nullptr) {
+      return;
+    }
+    // Claim the request before touching the tasks, the thief could be withdrawing it.
+    if (worker_context *thief = m_request.exchange(nullptr, std::memory_order_acquire)) {
+
+      task_handle task = nullptr;
+
+      if (m_head < m_private_tasks.size()) {
+        task = m_private_tasks[m_head++];
+      }
+
+      thief->m_transfer = task;
+      thief->m_answered.store(true, std::memory_order_release);
+    }
+  }
+
+  /**
+   * @brief Convert an answer to one of our steal requests into the result of a steal.
+   */
+  [[nodiscard]] auto take_answer() const noexcept -> steal_t<task_handle> {
+    if (m_transfer != nullptr) {
+      return {.code = err::none, .val = m_transfer};
+    }
+    return {.code = err::empty, .val = {}};
+  }
+
   /**
    * @brief All non-null.
    */
-  deque<task_handle> m_tasks;
+  impl::task_deque m_tasks;
   /**
    * @brief All non-null.
    */
@@ -114,6 +361,62 @@ class worker_context : impl::immovable<context> {
    * @brief The user supplied notification function.
    */
   nullary_function_t m_notify;
+  /**
+   * @brief Where the worker's stack publishes its footprint.
+   */
+  impl::stack_usage m_stack_usage;
+  /**
+   * @brief Number of submitted but uncollected tasks.
+   */
+  std::atomic<std::size_t> m_backlog = 0;
+  /**
+   * @brief The high-water mark of `m_backlog`, only written by the owner.
+   */
+  std::atomic<std::size_t> m_backlog_peak = 0;
+  /**
+   * @brief Incremented by the owner at strand boundaries.
+   */
+  std::atomic<std::uint64_t> m_strand = 0;
+  /**
+   * @brief If set the owner's tasks live in `m_private_tasks` and can only be stolen by request.
+   */
+  bool m_private;
+  /**
+   * @brief The owner's tasks in fork order, those before `m_head` have been given to thieves.
+   */
+  std::vector<task_handle> m_private_tasks;
+  /**
+   * @brief The capacity of `m_private_tasks` in bytes, published by the owner when it grows.
+   */
+  std::atomic<std::size_t> m_private_bytes = 0;
+  /**
+   * @brief The index of the oldest task in `m_private_tasks` that has not been given away.
+   */
+  std::size_t m_head = 0;
+  /**
+   * @brief A thief waiting for one of our tasks, or null.
+   */
+  alignas(impl::k_cache_line) std::atomic<worker_context *> m_request = nullptr;
+  /**
+   * @brief Set (by a victim) when `m_transfer` holds the answer to our steal request.
+   */
+  alignas(impl::k_cache_line) std::atomic<bool> m_answered = false;
+  /**
+   * @brief A victim's answer to our steal request, null if it had nothing to give.
+   */
+  task_handle m_transfer = nullptr;
+#ifdef LF_ASYNC_STACK
+  /**
+   * @brief The frame of the task this worker is currently executing, or null.
+   */
+  std::atomic<impl::frame *> m_running = nullptr;
+  #ifdef LF_STALL_DETECTOR
+  /**
+   * @brief The address of the coroutine of `m_running`, copied by the owner.
+   */
+  std::atomic<void *> m_running_task = nullptr;
+  #endif
+#endif
 };
 
 } // namespace ext
@@ -128,26 +431,137 @@ class full_context : public worker_context {
   /**
    * @brief Construct a new full context object, store a copy of the user provided notification function.
    */
-  explicit full_context(nullary_function_t notify) noexcept : worker_context(std::move(notify)) {}
+  explicit full_context(nullary_function_t notify, bool private_deque = false) noexcept
+      : worker_context(std::move(notify), private_deque) {}
 
   /**
    * @brief Add a task to the work queue.
    */
-  void push(task_handle task) { m_tasks.push(non_null(task)); }
+  void push(task_handle task) {
+    if (m_private) {
+      std::size_t capacity = m_private_tasks.capacity();
+      m_private_tasks.push_back(task);
+      if (m_private_tasks.capacity() != capacity) {
+        m_private_bytes.store(m_private_tasks.capacity() * sizeof(task_handle), std::memory_order_relaxed);
+      }
+      serve_request();
+      cross_boundary();
+      return;
+    }
+#ifdef LF_BOUNDED_DEQUE
+    // Once a task overflows all later tasks must follow it, such that pop() remains LIFO.
+    if (!m_overflow.empty() || !m_tasks.push(non_null(task))) {
+      m_overflow.push_back(task);
+    }
+#else
+    m_tasks.push(non_null(task));
+#endif
+    cross_boundary();
+  }
 
   /**
    * @brief Remove a task from the work queue
    */
   [[nodiscard]] auto pop() noexcept -> task_handle {
+    cross_boundary();
+    if (m_private) {
+      return pop_private();
+    }
+#ifdef LF_BOUNDED_DEQUE
+    if (!m_overflow.empty()) {
+      task_handle task = m_overflow.back();
+      m_overflow.pop_back();
+      return task;
+    }
+#endif
     return m_tasks.pop([]() -> task_handle {
       return nullptr;
     });
   }
 
+  /**
+   * @brief Advance the strand counter, use a `step` of one to toggle between executing and not.
+   */
+  void next_strand(std::uint64_t step = 2) noexcept {
+    m_strand.store(m_strand.load(std::memory_order_relaxed) + step, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Called at fork/join boundaries, advances the strand counter only if ``LF_STALL_DETECTOR`` is defined.
+   */
+  LF_FORCEINLINE void cross_boundary() noexcept {
+#ifdef LF_STALL_DETECTOR
+    next_strand();
+#endif
+  }
+
   /**
    * @brief Test if the work queue is empty.
    */
-  [[nodiscard]] auto empty() const noexcept -> bool { return m_tasks.empty(); }
+  [[nodiscard]] auto empty() const noexcept -> bool {
+    if (m_private) {
+      return m_head == m_private_tasks.size();
+    }
+#ifdef LF_BOUNDED_DEQUE
+    if (!m_overflow.empty()) {
+      return false;
+    }
+#endif
+    return m_tasks.empty();
+  }
+
+  /**
+   * @brief Touch the work queue's buffer, must be called by the owner while the queue is empty.
+   */
+  void prefault() noexcept { m_tasks.prefault(); }
+
+  /**
+   * @brief Get the destination for the owning worker's stack statistics.
+   */
+  [[nodiscard]] auto stack_usage() noexcept -> impl::stack_usage * { return &m_stack_usage; }
+
+#ifdef LF_ASYNC_STACK
+  /**
+   * @brief Record the frame (and the address of its coroutine) of the task this worker is about to execute.
+   */
+  void set_running(frame *task, [[maybe_unused]] void *coro) noexcept {
+    m_running.store(task, std::memory_order_relaxed);
+  #ifdef LF_STALL_DETECTOR
+    m_running_task.store(coro, std::memory_order_relaxed);
+  #endif
+  }
+#endif
+
+ private:
+  /**
+   * @brief Answer any pending steal request then, pop our youngest private task.
+   */
+  [[nodiscard]] auto pop_private() noexcept -> task_handle {
+
+    serve_request();
+
+    task_handle task = nullptr;
+
+    if (m_head < m_private_tasks.size()) {
+      task = m_private_tasks.back();
+      m_private_tasks.pop_back();
+    }
+
+    if (m_head == m_private_tasks.size()) {
+      // Reclaim the slots of the tasks that were given away.
+      m_private_tasks.clear();
+      m_head = 0;
+    }
+
+    return task;
+  }
+
+#ifdef LF_BOUNDED_DEQUE
+  /**
+   * @brief Tasks that did not fit in the bounded deque, these cannot be stolen.
+   */
+  std::vector<task_handle> m_overflow;
+#endif
 };
 
 } // namespace impl
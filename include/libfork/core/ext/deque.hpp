@@ -22,9 +22,9 @@
 #include <vector>      // for vector
 #include <version>     // for ptrdiff_t
 
-#include "libfork/core/impl/atomics.hpp" // for thread_fence_seq_cst
+#include "libfork/core/impl/atomics.hpp" // for light_fence, heavy_fence, asymmetric_fences
 #include "libfork/core/impl/utility.hpp" // for k_cache_line, immovable
-#include "libfork/core/macro.hpp"        // for LF_ASSERT, LF_STATIC_CALL, LF_STATIC_CONST
+#include "libfork/core/macro.hpp"        // for LF_ASSERT, LF_PROBE, LF_STATIC_CALL, LF_STATIC_CONST
 
 /**
  * @file deque.hpp
@@ -248,6 +248,9 @@ struct return_nullopt {
  * like a LIFO stack. Others can (only) ``steal()`` data from the deque, they see a FIFO deque.
  * All threads must have finished using the deque before it is destructed.
  *
+ * If ``LF_ASYMMETRIC_FENCES`` is defined (Linux only) the full fence in ``pop()`` is replaced with a
+ * compiler fence and the matching hardware barrier is issued by thieves via ``membarrier``, this moves the
+ * cost from every pop onto the (rare) successful-looking steal.
  *
  * Example:
  *
@@ -293,6 +296,13 @@ class deque : impl::immovable<deque<T>> {
    * @brief Get the capacity of the deque.
    */
   [[nodiscard]] constexpr auto capacity() const noexcept -> ptrdiff_t;
+  /**
+   * @brief Get the total capacity of the buffers retired by resizing.
+   *
+   * Retired buffers are kept alive until the deque is destructed as a concurrent thief may still be reading
+   * from them. This can be called concurrently with any other operation.
+   */
+  [[nodiscard]] constexpr auto garbage_capacity() const noexcept -> ptrdiff_t;
   /**
    * @brief Check if the deque is empty.
    */
@@ -325,6 +335,13 @@ class deque : impl::immovable<deque<T>> {
    */
   [[nodiscard]] constexpr auto steal() noexcept -> steal_t<T>;
 
+  /**
+   * @brief Write to every slot of the ring buffer such that the first pushes do not page fault.
+   *
+   * This must be called by the owner while the deque is empty.
+   */
+  constexpr void prefault() noexcept;
+
   /**
    * @brief Destroy the deque object.
    *
@@ -336,6 +353,7 @@ class deque : impl::immovable<deque<T>> {
   alignas(impl::k_cache_line) std::atomic<std::ptrdiff_t> m_top;
   alignas(impl::k_cache_line) std::atomic<std::ptrdiff_t> m_bottom;
   alignas(impl::k_cache_line) std::atomic<impl::atomic_ring_buf<T> *> m_buf;
+  std::atomic<std::ptrdiff_t> m_garbage_cap = 0;
   std::vector<std::unique_ptr<impl::atomic_ring_buf<T>>> m_garbage;
 
   // Convenience aliases.
@@ -371,6 +389,11 @@ constexpr auto deque<T>::capacity() const noexcept -> ptrdiff_t {
   return m_buf.load(relaxed)->capacity();
 }
 
+template <dequeable T>
+constexpr auto deque<T>::garbage_capacity() const noexcept -> ptrdiff_t {
+  return m_garbage_cap.load(relaxed);
+}
+
 template <dequeable T>
 constexpr auto deque<T>::empty() const noexcept -> bool {
   ptrdiff_t const bottom = m_bottom.load(relaxed);
@@ -378,6 +401,18 @@ constexpr auto deque<T>::empty() const noexcept -> bool {
   return top >= bottom;
 }
 
+template <dequeable T>
+constexpr void deque<T>::prefault() noexcept {
+
+  LF_ASSERT(empty());
+
+  impl::atomic_ring_buf<T> *buf = m_buf.load(relaxed);
+
+  for (std::ptrdiff_t i = 0; i < buf->capacity(); ++i) {
+    buf->store(i, T{});
+  }
+}
+
 template <dequeable T>
 constexpr auto deque<T>::push(T const &val) -> void {
   std::ptrdiff_t const bottom = m_bottom.load(relaxed);
@@ -392,6 +427,7 @@ constexpr auto deque<T>::push(T const &val) -> void {
       // This should never throw as we reserve 64 slots.
       m_garbage.emplace_back(std::exchange(buf, bigger));
     }();
+    m_garbage_cap.store(m_garbage_cap.load(relaxed) + m_garbage.back()->capacity(), relaxed);
     m_buf.store(buf, relaxed);
   }
 
@@ -413,7 +449,7 @@ deque<T>::pop(F &&when_empty) noexcept(std::is_nothrow_invocable_v<F>) -> std::i
   impl::atomic_ring_buf<T> *buf = m_buf.load(relaxed);      //
   m_bottom.store(bottom, relaxed);                          // Stealers can no longer steal.
 
-  impl::thread_fence_seq_cst();
+  impl::light_fence(); // Pairs with the heavy fence in steal().
 
   std::ptrdiff_t top = m_top.load(relaxed);
 
@@ -439,7 +475,14 @@ deque<T>::pop(F &&when_empty) noexcept(std::is_nothrow_invocable_v<F>) -> std::i
 template <dequeable T>
 constexpr auto deque<T>::steal() noexcept -> steal_t<T> {
   std::ptrdiff_t top = m_top.load(acquire);
-  impl::thread_fence_seq_cst();
+
+  if (impl::asymmetric_fences() && top >= m_bottom.load(relaxed)) {
+    // Looks empty, a false negative is permitted and this skips the system call in the heavy fence.
+    LF_PROBE(steal_failure, this, static_cast<int>(err::empty));
+    return {.code = err::empty, .val = {}};
+  }
+
+  impl::heavy_fence();
   std::ptrdiff_t const bottom = m_bottom.load(acquire);
 
   if (top < bottom) {
@@ -453,10 +496,13 @@ constexpr auto deque<T>::steal() noexcept -> steal_t<T> {
     static_assert(std::is_trivially_destructible_v<T>, "concept 'atomicable' should guarantee this already");
 
     if (!m_top.compare_exchange_strong(top, top + 1, seq_cst, relaxed)) {
+      LF_PROBE(steal_failure, this, static_cast<int>(err::lost));
       return {.code = err::lost, .val = {}};
     }
+    LF_PROBE(steal_success, this, bottom - top);
     return {.code = err::none, .val = tmp};
   }
+  LF_PROBE(steal_failure, this, static_cast<int>(err::empty));
   return {.code = err::empty, .val = {}};
 }
 
@@ -11,6 +11,7 @@
 
 #include <atomic>     // for atomic, memory_order_consume, memory_order_relaxed
 #include <concepts>   // for invocable
+#include <cstddef>    // for size_t
 #include <functional> // for invoke
 
 #include "libfork/core/impl/utility.hpp" // for immovable
@@ -100,15 +101,26 @@ class intrusive_list : impl::immovable<intrusive_list<T>> {
    * such that `for_each_elem` will operate if FIFO order.
    */
   constexpr auto try_pop_all() noexcept -> node * {
+    std::size_t count = 0;
+    return try_pop_all(count);
+  }
+
+  /**
+   * @brief As `try_pop_all()` but also store the number of popped nodes in `count`.
+   */
+  constexpr auto try_pop_all(std::size_t &count) noexcept -> node * {
 
     node *last = m_head.exchange(nullptr, std::memory_order_consume);
     node *first = nullptr;
 
+    count = 0;
+
     while (last) {
       node *tmp = last;
       last = last->m_next;
       tmp->m_next = first;
       first = tmp;
+      ++count;
     }
 
     return first;
@@ -15,7 +15,7 @@
 #include "libfork/core/ext/context.hpp" // for full_context
 #include "libfork/core/ext/handles.hpp" // for submit_t, submit_handle, task_handle
 #include "libfork/core/ext/list.hpp"    // for for_each_elem
-#include "libfork/core/ext/tls.hpp"     // for stack, context
+#include "libfork/core/ext/tls.hpp"     // for stack, context, set_running
 #include "libfork/core/impl/frame.hpp"  // for frame
 #include "libfork/core/impl/stack.hpp"  // for stack
 #include "libfork/core/macro.hpp"       // for LF_ASSERT_NO_ASSUME, LF_LOG, LF_ASSERT, LF_STATI...
@@ -51,7 +51,12 @@ inline void resume(submit_handle ptr) {
     }
 
     LF_ASSERT_NO_ASSUME(impl::tls::context()->empty());
+    impl::tls::context()->next_strand(1);
+    impl::tls::set_running(frame);
     frame->self().resume();
+    impl::tls::set_running(nullptr);
+    impl::tls::context()->next_strand(1);
+    impl::tls::stack()->publish();
     LF_ASSERT_NO_ASSUME(impl::tls::context()->empty());
     LF_ASSERT_NO_ASSUME(impl::tls::stack()->empty());
   });
@@ -72,7 +77,12 @@ inline void resume(task_handle ptr) {
 
   LF_ASSERT_NO_ASSUME(impl::tls::context()->empty());
   LF_ASSERT_NO_ASSUME(impl::tls::stack()->empty());
+  impl::tls::context()->next_strand(1);
+  impl::tls::set_running(frame);
   frame->self().resume();
+  impl::tls::set_running(nullptr);
+  impl::tls::context()->next_strand(1);
+  impl::tls::stack()->publish();
   LF_ASSERT_NO_ASSUME(impl::tls::context()->empty());
   LF_ASSERT_NO_ASSUME(impl::tls::stack()->empty());
 }
@@ -13,9 +13,10 @@
 #include <utility>   // for move
 
 #include "libfork/core/ext/context.hpp"          // for full_context, worker_context, nullary_f...
+#include "libfork/core/impl/frame.hpp"           // for frame
 #include "libfork/core/impl/manual_lifetime.hpp" // for manual_lifetime
 #include "libfork/core/impl/stack.hpp"           // for stack
-#include "libfork/core/macro.hpp"                // for LF_CLANG_TLS_NOINLINE, LF_THROW, LF_ASSERT
+#include "libfork/core/macro.hpp"                // for LF_CLANG_TLS_NOINLINE, LF_THROW, LF_ASSERT, LF_FORCEINLINE
 
 /**
  * @file tls.hpp
@@ -76,6 +77,21 @@ constinit
   return thread_context.data();
 }
 
+/**
+ * @brief Record the frame of the task this worker is about to execute, a no-op unless `LF_ASYNC_STACK`.
+ *
+ * This must be updated __before__ ownership of the previous frame could be lost such that the pointer
+ * published to `lf::ext::current_task_stack()` never dangles.
+ */
+LF_FORCEINLINE inline void set_running([[maybe_unused]] frame *task) noexcept {
+#if defined(LF_ASYNC_STACK) && defined(LF_STALL_DETECTOR)
+  // Copied while we own the frame such that the stall detector never dereferences it.
+  context()->set_running(task, task != nullptr ? task->self().address() : nullptr);
+#elif defined(LF_ASYNC_STACK)
+  context()->set_running(task, nullptr);
+#endif
+}
+
 } // namespace impl::tls
 
 inline namespace ext {
@@ -87,6 +103,8 @@ inline namespace ext {
  * the thread that called this function.
  *
  * @param notify Called when a task is submitted to a worker, this may be called concurrently.
+ * @param private_deque If true then the worker keeps its tasks in a private (non-atomic) deque, other
+ * workers can only steal them with `lf::ext::worker_context::try_steal(worker_context *)`.
  *
  * \rst
  *
@@ -95,7 +113,8 @@ inline namespace ext {
  *
  * \endrst
  */
-[[nodiscard]] inline LF_CLANG_TLS_NOINLINE auto worker_init(nullary_function_t notify) -> worker_context * {
+[[nodiscard]] inline LF_CLANG_TLS_NOINLINE auto
+worker_init(nullary_function_t notify, bool private_deque = false) -> worker_context * {
 
   LF_LOG("Initializing worker");
 
@@ -103,12 +122,12 @@ inline namespace ext {
     LF_THROW(std::runtime_error("Worker already initialized"));
   }
 
-  worker_context *context = impl::tls::thread_context.construct(std::move(notify));
+  worker_context *context = impl::tls::thread_context.construct(std::move(notify), private_deque);
 
   // clang-format off
 
   LF_TRY {
-    impl::tls::thread_stack.construct();
+    impl::tls::thread_stack.construct()->track(impl::tls::thread_context->stack_usage());
   } LF_CATCH_ALL {
     impl::tls::thread_context.destroy();
   }
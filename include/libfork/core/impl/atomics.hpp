@@ -34,6 +34,12 @@
 
 #include "libfork/core/macro.hpp"
 
+#if defined(LF_ASYMMETRIC_FENCES) && defined(__linux__)
+  #include <linux/membarrier.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
 /**
  * @file atomics.hpp
  *
@@ -76,6 +82,54 @@ LF_FORCEINLINE inline void thread_fence_seq_cst() {
 #endif
 }
 
+/**
+ * @brief Test if asymmetric fences are in use, the first call registers the process with the kernel.
+ *
+ * This is always false unless ``LF_ASYMMETRIC_FENCES`` is defined and the kernel supports expedited private
+ * ``membarrier`` commands (Linux 4.14+).
+ */
+LF_FORCEINLINE inline auto asymmetric_fences() noexcept -> bool {
+#if defined(LF_ASYMMETRIC_FENCES) && defined(__linux__)
+  static bool const registered = [] {
+    return ::syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+  }();
+  return registered;
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief The fast half of a seq_cst fence, it must only race with code that uses a `heavy_fence`.
+ *
+ * With asymmetric fences this only prevents compiler reordering, the hardware barrier is supplied by the
+ * other side's `heavy_fence` hence, this is for the frequent side of a rare interaction.
+ */
+LF_FORCEINLINE inline void light_fence() noexcept {
+  if (asymmetric_fences()) {
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+  } else {
+    thread_fence_seq_cst();
+  }
+}
+
+/**
+ * @brief The slow half of a seq_cst fence, pairs with `light_fence`.
+ *
+ * With asymmetric fences this forces a full barrier on every running thread of the process (a system call
+ * costing microseconds) otherwise, it is a `thread_fence_seq_cst`.
+ */
+inline void heavy_fence() noexcept {
+#if defined(LF_ASYMMETRIC_FENCES) && defined(__linux__)
+  if (asymmetric_fences()) {
+    [[maybe_unused]] long err = ::syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+    LF_ASSERT(err == 0);
+    return;
+  }
+#endif
+  thread_fence_seq_cst();
+}
+
 } // namespace lf::impl
 
 #endif /* F70CC480_E6E6_43C1_A7D6_3EEB74F05088 */
@@ -24,7 +24,7 @@
 #include "libfork/core/ext/context.hpp"       // for full_context
 #include "libfork/core/ext/handles.hpp"       // for submit_handle, submit_node_t, task_handle
 #include "libfork/core/ext/list.hpp"          // for unwrap
-#include "libfork/core/ext/tls.hpp"           // for stack, context
+#include "libfork/core/ext/tls.hpp"           // for stack, context, set_running
 #include "libfork/core/impl/frame.hpp"        // for frame
 #include "libfork/core/impl/stack.hpp"        // for stack
 #include "libfork/core/impl/unique_frame.hpp" // for unique_frame, frame_deleter
@@ -56,6 +56,7 @@ namespace lf::impl {
   //
   if (auto *eff_stolen = std::bit_cast<frame *>(tls::context()->pop())) {
     eff_stolen->fetch_add_steal();
+    tls::set_running(eff_stolen);
     return eff_stolen->self();
   }
 
@@ -121,6 +122,9 @@ struct context_switch_awaitable {
     }
 #endif
 
+    // Once scheduled this frame may be resumed (and completed) by another worker.
+    tls::set_running(nullptr);
+
     // Schedule this coroutine for execution, cannot touch underlying after this.
     external.await_suspend(&self);
 
@@ -244,6 +248,9 @@ struct fork_awaitable : std::suspend_always {
 
     unique_frame stack_child = std::exchange(child, nullptr);
 
+    // Must publish the child before the parent becomes stealable.
+    tls::set_running(stack_child.get());
+
     // If await_suspend throws an exception then:
     //  - The exception is caught,
     //  - The coroutine is resumed,
@@ -344,6 +351,7 @@ struct call_awaitable : std::suspend_always {
    */
   auto await_suspend(std::coroutine_handle<> /*unused*/) noexcept -> std::coroutine_handle<> {
     LF_LOG("Calling");
+    tls::set_running(child.get());
     // Take ownership of the child's lifetime.
     return child.release()->self();
   }
@@ -460,6 +468,10 @@ struct join_awaitable {
     //         k_u16_max - joined = num_joined
 
     auto steals = self->load_steals();
+
+    // If we loose the race below then self may be resumed/freed by another worker.
+    tls::set_running(nullptr);
+
     auto joined = self->fetch_sub_joins(k_u16_max - steals, std::memory_order_release);
 
     if (steals == k_u16_max - joined) {
@@ -468,6 +480,7 @@ struct join_awaitable {
       std::atomic_thread_fence(std::memory_order_acquire);
       LF_LOG("Wins join race");
       take_stack_reset_frame();
+      tls::set_running(self);
       return task;
     }
     LF_LOG("Looses join race");
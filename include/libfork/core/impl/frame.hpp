@@ -14,7 +14,6 @@
 #include <cstdint>     // for uint16_t
 #include <exception>   // for exception_ptr, operator==, current_exce...
 #include <memory>      // for construct_at
-#include <semaphore>   // for binary_semaphore
 #include <type_traits> // for is_standard_layout_v, is_trivially_dest...
 #include <utility>     // for exchange
 #include <version>     // for __cpp_lib_atomic_ref
@@ -33,6 +32,33 @@
 
 namespace lf::impl {
 
+/**
+ * @brief Notified by a root task when it completes, after its result has been stored.
+ *
+ * This is type-erased via a function pointer so the caller chooses how it is woken, i.e. by a semaphore
+ * in `lf::core::sync_wait` or by completing a receiver in `lf::core::as_sender`.
+ */
+class root_notifier {
+ public:
+  /**
+   * @brief The type of the notification function.
+   */
+  using notify_fn = void (*)(root_notifier *) noexcept;
+
+  /**
+   * @brief Construct a notifier that calls `fn` when notified.
+   */
+  explicit constexpr root_notifier(notify_fn fn) noexcept : m_fn(fn) {}
+
+  /**
+   * @brief Notify the caller, this may destroy the notifier.
+   */
+  void notify() noexcept { m_fn(this); }
+
+ private:
+  notify_fn m_fn;
+};
+
 /**
  * @brief A small bookkeeping struct which is a member of each task's promise.
  */
@@ -62,9 +88,9 @@ class frame {
      */
     frame *m_parent;
     /**
-     * @brief Root tasks store a pointer to a semaphore to notify the caller.
+     * @brief Root tasks store a pointer to a notifier to wake the caller.
      */
-    std::binary_semaphore *m_sem;
+    root_notifier *m_notifier;
   };
 
   /**
@@ -87,6 +113,13 @@ class frame {
   #endif
 #endif
 
+#ifdef LF_ASYNC_STACK
+  /**
+   * @brief Set if this is a root frame, used to terminate async stack walks.
+   */
+  bool m_root = false;
+#endif
+
   /**
    * @brief Cold path in `unsafe_rethrow_if_exception` in its own non-inline function.
    */
@@ -135,7 +168,23 @@ class frame {
   /**
    * @brief Set a root tasks parent.
    */
-  void set_root_sem(std::binary_semaphore *sem) noexcept { m_sem = non_null(sem); }
+  void set_root_notifier(root_notifier *notifier) noexcept {
+    m_notifier = non_null(notifier);
+#ifdef LF_ASYNC_STACK
+    m_root = true;
+#endif
+  }
+
+  /**
+   * @brief Test if this is a root frame, always `false` unless `LF_ASYNC_STACK` is defined.
+   */
+  [[nodiscard]] auto is_root() const noexcept -> bool {
+#ifdef LF_ASYNC_STACK
+    return m_root;
+#else
+    return false;
+#endif
+  }
 
   /**
    * @brief Set the stacklet object to point at a new stacklet.
@@ -154,11 +203,11 @@ class frame {
   [[nodiscard]] auto parent() const noexcept -> frame * { return m_parent; }
 
   /**
-   * @brief Get a pointer to the semaphore for this root frame.
+   * @brief Get a pointer to the notifier for this root frame.
    *
-   * Only valid if this is not a root frame.
+   * Only valid if this is a root frame.
    */
-  [[nodiscard]] auto semaphore() const noexcept -> std::binary_semaphore * { return m_sem; }
+  [[nodiscard]] auto notifier() const noexcept -> root_notifier * { return m_notifier; }
 
   /**
    * @brief Get a pointer to the top of the top of the stack-stack this frame was allocated on.
@@ -21,7 +21,7 @@
 #include "libfork/core/exceptions.hpp"      // for stash_exception_in_return
 #include "libfork/core/ext/context.hpp"     // for full_context
 #include "libfork/core/ext/handles.hpp"     // for submit_t, task_handle
-#include "libfork/core/ext/tls.hpp"         // for stack, context
+#include "libfork/core/ext/tls.hpp"         // for stack, context, set_running
 #include "libfork/core/first_arg.hpp"       // for first_arg_t, async_function_object, first_arg
 #include "libfork/core/impl/awaitables.hpp" // for alloc_awaitable, call_awaitable, context_swi...
 #include "libfork/core/impl/combinate.hpp"  // for quasi_awaitable
@@ -31,7 +31,7 @@
 #include "libfork/core/impl/utility.hpp"    // for byte_cast, k_u16_max
 #include "libfork/core/invocable.hpp"       // for return_address_for, ignore_t
 #include "libfork/core/just.hpp"            // for just_awaitable, just_wrapped
-#include "libfork/core/macro.hpp"           // for LF_LOG, LF_ASSERT, LF_FORCEINLINE, LF_ASSERT...
+#include "libfork/core/macro.hpp"           // for LF_LOG, LF_ASSERT, LF_FORCEINLINE, LF_PROBE
 #include "libfork/core/scheduler.hpp"       // for context_switcher
 #include "libfork/core/tag.hpp"             // for tag
 #include "libfork/core/task.hpp"            // for returnable, task
@@ -56,6 +56,7 @@ inline auto final_await_suspend(frame *parent) noexcept -> std::coroutine_handle
     LF_ASSERT(byte_cast(parent_task) == byte_cast(parent));
     // This must be the same thread that created the parent so it already owns the stack.
     // No steals have occurred so we do not need to call reset().;
+    tls::set_running(parent);
     return parent->self();
   }
 
@@ -111,6 +112,8 @@ inline auto final_await_suspend(frame *parent) noexcept -> std::coroutine_handle
     // Must reset parents control block before resuming parent.
     parent->reset();
 
+    tls::set_running(parent);
+
     return parent->self();
   }
 
@@ -334,9 +337,13 @@ struct promise : promise_base, return_result<R, I> {
 
       if constexpr (Tag == tag::root) {
 
-        LF_LOG("Root task at final suspend, releases semaphore and yields");
+        LF_LOG("Root task at final suspend, notifies the caller and yields");
+
+        LF_PROBE(root_complete, static_cast<frame *>(&child.promise()));
+
+        tls::set_running(nullptr);
 
-        child.promise().semaphore()->release();
+        child.promise().notifier()->notify();
         child.destroy();
 
         // A root task is always the first on a stack, now it has been completed the stack is empty.
@@ -348,6 +355,10 @@ struct promise : promise_base, return_result<R, I> {
       LF_LOG("Task reaches final suspend, destroying child");
 
       frame *parent = child.promise().parent();
+
+      // A call's parent cannot have been stolen, a fork's parent will be published if resumed.
+      tls::set_running(Tag == tag::call ? parent : nullptr);
+
       child.destroy();
 
       if constexpr (Tag == tag::call) {
@@ -10,15 +10,17 @@
 // file, You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <algorithm>   // for max
+#include <atomic>      // for atomic, memory_order_relaxed
 #include <bit>         // for has_single_bit
 #include <cstddef>     // for size_t, byte, nullptr_t
 #include <cstdlib>     // for free, malloc
+#include <cstring>     // for memset
 #include <new>         // for bad_alloc
 #include <type_traits> // for is_trivially_default_constructible_v, is_trivia...
 #include <utility>     // for exchange, swap
 
 #include "libfork/core/impl/utility.hpp" // for byte_cast, k_new_align, non_null, immovable
-#include "libfork/core/macro.hpp"        // for LF_ASSERT, LF_LOG, LF_FORCEINLINE, LF_NOINLINE
+#include "libfork/core/macro.hpp"        // for LF_ASSERT, LF_LOG, LF_FORCEINLINE, LF_NOINLINE, LF_PROBE
 
 /**
  * @file stack.hpp
@@ -65,6 +67,30 @@ namespace lf::impl {
   return request;
 }
 
+/**
+ * @brief Statistics about the memory held by a worker's stack, written by the owner and readable by anyone.
+ */
+struct stack_usage {
+  /**
+   * @brief Bytes in the stacklet chain (including a cached stacklet) when last published.
+   */
+  std::atomic<std::size_t> bytes = 0;
+  /**
+   * @brief The largest value `bytes` has been published with.
+   */
+  std::atomic<std::size_t> peak = 0;
+
+  /**
+   * @brief Publish a new value of `bytes`, must only be called by the owning thread.
+   */
+  void record(std::size_t now) noexcept {
+    bytes.store(now, std::memory_order_relaxed);
+    if (now > peak.load(std::memory_order_relaxed)) {
+      peak.store(now, std::memory_order_relaxed);
+    }
+  }
+};
+
 /**
  * @brief A stack is a user-space (geometric) segmented program stack.
  *
@@ -105,6 +131,12 @@ class stack {
       LF_ASSERT(m_hi - m_sp >= 0);
       return static_cast<std::size_t>(m_hi - m_sp);
     }
+    /**
+     * @brief The size of the allocation holding this stacklet (including the stacklet object).
+     */
+    [[nodiscard]] auto footprint() const noexcept -> std::size_t {
+      return static_cast<std::size_t>(m_hi - impl::byte_cast(this));
+    }
     /**
      * @brief Check if stacklet's stack is empty.
      */
@@ -151,6 +183,8 @@ class stack {
         LF_THROW(std::bad_alloc());
       }
 
+      LF_PROBE(stacklet_alloc, next, request);
+
       if (prev != nullptr) {
         // Set next tidies up other next.
         prev->set_next(next);
@@ -163,6 +197,8 @@ class stack {
       next->m_prev = prev;
       next->m_next = nullptr;
 
+      next->m_chain = request + (prev != nullptr ? prev->m_chain : 0);
+
       return next;
     }
 
@@ -193,6 +229,10 @@ class stack {
      * @brief Doubly linked list (future).
      */
     stacklet *m_next;
+    /**
+     * @brief The sum of the footprints of this stacklet and all of those before it.
+     */
+    std::size_t m_chain;
   };
 
   // Keep stack aligned.
@@ -228,9 +268,12 @@ class stack {
 
   /**
    * @brief Swap this and `other`.
+   *
+   * This does not swap the tracking destinations as they belong to the stack object not the stacklets.
    */
   auto operator=(stack &&other) noexcept -> stack & {
     swap(*this, other);
+    publish();
     return *this;
   }
 
@@ -242,6 +285,38 @@ class stack {
     swap(lhs.m_fib, rhs.m_fib);
   }
 
+  /**
+   * @brief Publish this stack's memory footprint to `usage` whenever it may have grown.
+   *
+   * The lifetime of `usage` must exceed the lifetime of this object or the next call to `track`.
+   */
+  void track(stack_usage *usage) noexcept {
+    m_usage = usage;
+    publish();
+  }
+
+  /**
+   * @brief Total bytes held by the stacklet chain including any cached stacklet.
+   */
+  [[nodiscard]] auto bytes() const noexcept -> std::size_t {
+
+    LF_ASSERT(m_fib && m_fib->is_top());
+
+    // A stacklet's predecessors never change hence, the chain total is fixed when it is allocated.
+    return m_fib->m_chain + (m_fib->m_next != nullptr ? m_fib->m_next->footprint() : 0);
+  }
+
+  /**
+   * @brief Publish the current value of `bytes()` if this stack is being tracked.
+   *
+   * This is only called on cold paths (growth and changes of ownership) hence, it is kept out of line.
+   */
+  LF_NOINLINE void publish() const noexcept {
+    if (m_usage != nullptr) {
+      m_usage->record(bytes());
+    }
+  }
+
   /**
    * @brief Destroy the stack object.
    */
@@ -252,6 +327,27 @@ class stack {
     std::free(m_fib);          // NOLINT
   }
 
+  /**
+   * @brief Touch the free space of the top stacklet and cache a touched successor.
+   *
+   * This moves the page faults of the first allocations (and the first growth) to the caller.
+   */
+  void prefault() {
+
+    LF_ASSERT(m_fib && m_fib->is_top());
+
+    if (m_fib->m_next == nullptr) {
+      // Same size as `allocate` would request, this attaches it as the cached stacklet.
+      [[maybe_unused]] stacklet *next = stacklet::next_stacklet(2 * m_fib->capacity(), m_fib);
+      LF_ASSERT(m_fib->m_next == next);
+    }
+
+    std::memset(m_fib->m_sp, 0, m_fib->unused());
+    std::memset(m_fib->m_next->m_sp, 0, m_fib->m_next->unused());
+
+    publish();
+  }
+
   /**
    * @brief Test if the stack is empty (has no allocations).
    */
@@ -268,7 +364,9 @@ class stack {
   [[nodiscard]] auto release() -> stacklet * {
     LF_LOG("Releasing stack");
     LF_ASSERT(m_fib);
-    return std::exchange(m_fib, stacklet::next_stacklet());
+    stacklet *old = std::exchange(m_fib, stacklet::next_stacklet());
+    publish();
+    return old;
   }
 
   /**
@@ -290,6 +388,7 @@ class stack {
         m_fib = m_fib->m_next;
       } else {
         m_fib = stacklet::next_stacklet(std::max(2 * m_fib->capacity(), ext_size), m_fib);
+        publish();
       }
     }
 
@@ -349,6 +448,10 @@ class stack {
    * @brief The allocation stacklet.
    */
   stacklet *m_fib;
+  /**
+   * @brief Where to publish memory statistics, may be null.
+   */
+  stack_usage *m_usage = nullptr;
 };
 
 } // namespace lf::impl
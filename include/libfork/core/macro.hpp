@@ -334,6 +334,39 @@ using std::unreachable;
   #endif
 #endif
 
+#ifdef __has_include
+  #if defined(LF_USDT_PROBES) && not __has_include(<sys/sdt.h>)
+    #error "LF_USDT_PROBES is defined but <sys/sdt.h> is not available"
+  #endif
+#endif
+
+/**
+ * @brief __[public]__ A static tracepoint in the ``libfork`` provider.
+ *
+ * By default this is a no-op. Defining ``LF_USDT_PROBES`` will expand ``LF_PROBE(name, args...)``
+ * to a SystemTap/USDT probe (via ``<sys/sdt.h>``), these cost a single ``nop`` when no tracer is
+ * attached and can be enabled at runtime by tools like ``bpftrace``, for example:
+ *
+ * ``bpftrace -e 'usdt:./a.out:libfork:steal_success { @[tid] = count(); }'``
+ *
+ * The arguments must be integers or pointers.
+ */
+#ifdef LF_USDT_PROBES
+  #include <sys/sdt.h>
+  #include <type_traits>
+
+  #define LF_PROBE(name, ...)                                                                                \
+    do {                                                                                                     \
+      if (!std::is_constant_evaluated()) {                                                                   \
+        STAP_PROBEV(libfork, name __VA_OPT__(, ) __VA_ARGS__);                                               \
+      }                                                                                                      \
+    } while (false)
+#else
+  #define LF_PROBE(name, ...)                                                                                \
+    do {                                                                                                     \
+    } while (false)
+#endif
+
 /**
  * @brief Concatenation macro
  */
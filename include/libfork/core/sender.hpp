@@ -0,0 +1,412 @@
+#ifndef C3A7E1F4_8B2D_4E95_9F06_5D1B7A4C2E83
+#define C3A7E1F4_8B2D_4E95_9F06_5D1B7A4C2E83
+
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <bit>         // for bit_cast
+#include <concepts>    // for copy_constructible
+#include <exception>   // for exception_ptr, current_exception
+#include <tuple>       // for tuple, apply
+#include <type_traits> // for decay_t, is_void_v, is_trivially_destructible_v
+#include <utility>     // for move, forward
+#include <version>     // for __cpp_lib_senders
+
+#if defined(__cpp_lib_senders)
+  #include <execution> // for sender_t, receiver_t, set_value, ...
+  #define LF_EXECUTION_NAMESPACE std::execution
+#elif __has_include(<stdexec/execution.hpp>)
+  #include <stdexec/execution.hpp> // for sender_t, receiver_t, set_value, ...
+  #define LF_EXECUTION_NAMESPACE stdexec
+#endif
+
+#include "libfork/core/defer.hpp"                // for LF_DEFER
+#include "libfork/core/eventually.hpp"           // for try_eventually
+#include "libfork/core/ext/handles.hpp"          // for submit_node_t, submit_t
+#include "libfork/core/ext/tls.hpp"              // for has_stack, thread_stack, stack
+#include "libfork/core/first_arg.hpp"            // for async_function_object
+#include "libfork/core/impl/combinate.hpp"       // for quasi_awaitable, y_combinate, combinate
+#include "libfork/core/impl/frame.hpp"           // for root_notifier
+#include "libfork/core/impl/manual_lifetime.hpp" // for manual_lifetime
+#include "libfork/core/impl/stack.hpp"           // for stack
+#include "libfork/core/impl/utility.hpp"         // for immovable
+#include "libfork/core/invocable.hpp"            // for async_result_t, rootable, ignore_t
+#include "libfork/core/macro.hpp"                // for LF_TRY, LF_CATCH_ALL, LF_PROBE, LF_STATIC_CALL
+#include "libfork/core/scheduler.hpp"            // for scheduler
+#include "libfork/core/tag.hpp"                  // for tag, none
+#include "libfork/core/task.hpp"                 // for task
+
+/**
+ * @file sender.hpp
+ *
+ * @brief Adapt libfork's schedulers and async functions to the P2300 sender/receiver model.
+ *
+ * If the standard library provides ``std::execution`` or stdexec is available then its tags and
+ * customization points are used, otherwise a minimal set of equivalent tags are defined here. The
+ * senders use the member customizations of P2300R10.
+ */
+
+namespace lf {
+
+namespace impl::exec {
+
+#ifdef LF_EXECUTION_NAMESPACE
+
+using LF_EXECUTION_NAMESPACE::completion_signatures;
+using LF_EXECUTION_NAMESPACE::get_completion_scheduler_t;
+using LF_EXECUTION_NAMESPACE::operation_state_t;
+using LF_EXECUTION_NAMESPACE::receiver_t;
+using LF_EXECUTION_NAMESPACE::scheduler_t;
+using LF_EXECUTION_NAMESPACE::sender_t;
+using LF_EXECUTION_NAMESPACE::set_error;
+using LF_EXECUTION_NAMESPACE::set_error_t;
+using LF_EXECUTION_NAMESPACE::set_value;
+using LF_EXECUTION_NAMESPACE::set_value_t;
+
+#else
+
+/**
+ * @brief Tag for the ``sender_concept`` of a sender.
+ */
+struct sender_t {};
+
+/**
+ * @brief Tag for the ``receiver_concept`` of a receiver.
+ */
+struct receiver_t {};
+
+/**
+ * @brief Tag for the ``operation_state_concept`` of an operation state.
+ */
+struct operation_state_t {};
+
+/**
+ * @brief Tag for the ``scheduler_concept`` of a scheduler.
+ */
+struct scheduler_t {};
+
+/**
+ * @brief A list of completion signatures.
+ */
+template <typename... Sigs>
+struct completion_signatures {};
+
+/**
+ * @brief Query a sender's environment for the scheduler it completes on.
+ */
+template <typename Tag>
+struct get_completion_scheduler_t {};
+
+/**
+ * @brief Complete a receiver with values.
+ */
+struct set_value_t {
+  template <typename Rcvr, typename... Vs>
+  void operator()(Rcvr &&rcvr, Vs &&...vals) const noexcept {
+    std::forward<Rcvr>(rcvr).set_value(std::forward<Vs>(vals)...);
+  }
+};
+
+/**
+ * @brief Complete a receiver with an error.
+ */
+struct set_error_t {
+  template <typename Rcvr, typename E>
+  void operator()(Rcvr &&rcvr, E &&err) const noexcept {
+    std::forward<Rcvr>(rcvr).set_error(std::forward<E>(err));
+  }
+};
+
+inline constexpr set_value_t set_value = {};
+
+inline constexpr set_error_t set_error = {};
+
+#endif
+
+/**
+ * @brief The value completion signature of a root returning `R`.
+ */
+template <typename R>
+struct value_signature : std::type_identity<set_value_t(R)> {};
+
+template <>
+struct value_signature<void> : std::type_identity<set_value_t()> {};
+
+} // namespace impl::exec
+
+inline namespace core {
+
+template <scheduler Sch>
+class execution_scheduler;
+
+/**
+ * @brief The environment of a sender that completes on a worker of `Sch`.
+ */
+template <scheduler Sch>
+class execution_env {
+ public:
+  /**
+   * @brief Construct an environment referring to `sch`.
+   */
+  explicit execution_env(Sch &sch) noexcept : m_sch(&sch) {}
+
+  /**
+   * @brief Get the scheduler a sender completes on, values and errors are both delivered on a worker.
+   */
+  template <typename Tag>
+  [[nodiscard]] auto query(impl::exec::get_completion_scheduler_t<Tag>) const noexcept
+      -> execution_scheduler<Sch> {
+    return execution_scheduler<Sch>{*m_sch};
+  }
+
+ private:
+  Sch *m_sch;
+};
+
+} // namespace core
+
+namespace impl {
+
+/**
+ * @brief The operation state of a root task that completes a receiver.
+ *
+ * The root's result is stored in the operation state and the receiver is completed (on the worker that
+ * finished the root) directly from the root's final suspend, nothing blocks.
+ */
+template <typename Rcvr, scheduler Sch, async_function_object F, typename... Args>
+  requires rootable<F, Args...>
+class root_operation : root_notifier, immovable<root_operation<Rcvr, Sch, F, Args...>> {
+
+  using result_t = async_result_t<F, Args...>;
+
+ public:
+  /**
+   * @brief Tag this as an operation state.
+   */
+  using operation_state_concept = exec::operation_state_t;
+
+  /**
+   * @brief Construct an operation that will run `fun(args...)` on `sch` and complete `rcvr`.
+   */
+  root_operation(Sch &sch, F fun, std::tuple<Args...> args, Rcvr rcvr)
+      : root_notifier{complete},
+        m_sch{&sch},
+        m_fun{std::move(fun)},
+        m_args{std::move(args)},
+        m_rcvr{std::move(rcvr)} {}
+
+  /**
+   * @brief Submit the root to the scheduler, if this fails the receiver is completed with the error.
+   *
+   * This may be called from a worker, i.e. by a receiver that a completing root started.
+   */
+  void start() & noexcept {
+    LF_TRY {
+      if (tls::has_stack) {
+        // A worker's stack holds its current task, allocate the root on a new stack and restore it after.
+        stack fresh;
+        swap(fresh, *tls::stack());
+        LF_DEFER { *tls::stack() = std::move(fresh); };
+        submit();
+      } else {
+        tls::thread_stack.construct();
+        tls::has_stack = true;
+        LF_DEFER {
+          tls::thread_stack.destroy();
+          tls::has_stack = false;
+        };
+        submit();
+      }
+    }
+    LF_CATCH_ALL { exec::set_error(std::move(m_rcvr), std::current_exception()); }
+  }
+
+ private:
+  /**
+   * @brief Allocate the root on this thread's stack and hand it to the scheduler.
+   */
+  void submit() {
+
+    y_combinate combinator = combinate<tag::root, modifier::none>(&m_result, std::move(m_fun));
+
+    // This allocates a coroutine on this threads stack.
+    quasi_awaitable await = std::apply(
+        [&](Args &...args) {
+          return std::move(combinator)(std::move(args)...);
+        },
+        m_args);
+
+    await->set_root_notifier(this);
+
+    // If this throws then `await` will clean up the coroutine.
+    ignore_t{} = tls::stack()->release();
+
+    m_node.construct(std::bit_cast<submit_t *>(await.get()));
+
+    LF_PROBE(root_submit, await.get());
+
+    // Schedule upholds the strong exception guarantee hence, if it throws `await` cleans up.
+    m_sch->schedule(m_node.data());
+    // If -^ didn't throw then the worker owns the coroutine, `this` may already have been destroyed.
+    ignore_t{} = await.release();
+  }
+
+  /**
+   * @brief Called by the root at its final suspend, forwards the result to the receiver.
+   */
+  static void complete(root_notifier *self) noexcept {
+
+    auto *op = static_cast<root_operation *>(self);
+
+    if (op->m_result.has_exception()) {
+      exec::set_error(std::move(op->m_rcvr), std::move(op->m_result).exception());
+    } else if constexpr (std::is_void_v<result_t>) {
+      exec::set_value(std::move(op->m_rcvr));
+    } else {
+      exec::set_value(std::move(op->m_rcvr), *std::move(op->m_result));
+    }
+  }
+
+  static_assert(std::is_trivially_destructible_v<submit_node_t>);
+
+  Sch *m_sch;
+  F m_fun;
+  std::tuple<Args...> m_args;
+  Rcvr m_rcvr;
+  try_eventually<result_t> m_result;
+  manual_lifetime<submit_node_t> m_node;
+};
+
+/**
+ * @brief An async function that does nothing, running it as a root moves the caller onto a worker.
+ */
+struct hop_t {
+  /**
+   * @brief Complete immediately.
+   */
+  LF_STATIC_CALL auto operator()(auto /* unused */) LF_STATIC_CONST->task<void> { co_return; }
+};
+
+} // namespace impl
+
+inline namespace core {
+
+/**
+ * @brief A sender that runs an async function as a root task on a libfork scheduler.
+ *
+ * The sender completes with the result of the async function, or with an ``std::exception_ptr`` if it
+ * exits with an exception, on the worker that finished the root. Receivers are completed inline on the
+ * worker, hence they must not block.
+ */
+template <scheduler Sch, async_function_object F, typename... Args>
+  requires rootable<F, Args...>
+class root_sender {
+
+  using result_t = async_result_t<F, Args...>;
+
+ public:
+  /**
+   * @brief Tag this as a sender.
+   */
+  using sender_concept = impl::exec::sender_t;
+
+  /**
+   * @brief The ways this sender can complete.
+   */
+  using completion_signatures =
+      impl::exec::completion_signatures<typename impl::exec::value_signature<result_t>::type,
+                                        impl::exec::set_error_t(std::exception_ptr)>;
+
+  /**
+   * @brief Construct a sender that will run `fun(args...)` on `sch`.
+   */
+  root_sender(Sch &sch, F fun, Args... args)
+      : m_sch{&sch},
+        m_fun{std::move(fun)},
+        m_args{std::move(args)...} {}
+
+  /**
+   * @brief Connect this sender to `rcvr`, consumes the sender.
+   */
+  template <typename Rcvr>
+  [[nodiscard]] auto connect(Rcvr rcvr) && -> impl::root_operation<Rcvr, Sch, F, Args...> {
+    return {*m_sch, std::move(m_fun), std::move(m_args), std::move(rcvr)};
+  }
+
+  /**
+   * @brief Connect a copy of this sender to `rcvr`.
+   */
+  template <typename Rcvr>
+    requires std::copy_constructible<F> && (std::copy_constructible<Args> && ...)
+  [[nodiscard]] auto connect(Rcvr rcvr) const & -> impl::root_operation<Rcvr, Sch, F, Args...> {
+    return {*m_sch, m_fun, m_args, std::move(rcvr)};
+  }
+
+  /**
+   * @brief Get the environment of this sender.
+   */
+  [[nodiscard]] auto get_env() const noexcept -> execution_env<Sch> { return execution_env<Sch>{*m_sch}; }
+
+ private:
+  Sch *m_sch;
+  F m_fun;
+  std::tuple<Args...> m_args;
+};
+
+/**
+ * @brief A P2300 scheduler that refers to a libfork scheduler.
+ *
+ * The sender returned by ``schedule()`` completes on a worker of the underlying scheduler. This is a
+ * lightweight handle, the underlying scheduler must outlive it and any operation started from it.
+ */
+template <scheduler Sch>
+class execution_scheduler {
+ public:
+  /**
+   * @brief Tag this as a scheduler.
+   */
+  using scheduler_concept = impl::exec::scheduler_t;
+
+  /**
+   * @brief Construct a handle to `sch`.
+   */
+  explicit execution_scheduler(Sch &sch) noexcept : m_sch(&sch) {}
+
+  /**
+   * @brief Get a sender that completes, with no values, on a worker.
+   */
+  [[nodiscard]] auto schedule() const -> root_sender<Sch, impl::hop_t> { return {*m_sch, impl::hop_t{}}; }
+
+  /**
+   * @brief Two handles are equal if they refer to the same scheduler.
+   */
+  [[nodiscard]] auto operator==(execution_scheduler const &) const noexcept -> bool = default;
+
+ private:
+  Sch *m_sch;
+};
+
+/**
+ * @brief Get a sender that runs `fun(args...)` as a root task on `sch`.
+ *
+ * This is the non-blocking counterpart of `lf::core::schedule`, the arguments are decay-copied into the
+ * sender and the result is delivered to the connected receiver. Unlike `lf::core::schedule` the returned
+ * sender may be started from a worker thread.
+ */
+template <scheduler Sch, async_function_object F, class... Args>
+  requires rootable<std::decay_t<F>, std::decay_t<Args>...>
+auto as_sender(Sch &sch, F &&fun, Args &&...args)
+    -> root_sender<Sch, std::decay_t<F>, std::decay_t<Args>...> {
+  return {sch, std::forward<F>(fun), std::forward<Args>(args)...};
+}
+
+} // namespace core
+
+} // namespace lf
+
+#endif /* C3A7E1F4_8B2D_4E95_9F06_5D1B7A4C2E83 */
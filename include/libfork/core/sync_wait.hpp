@@ -24,11 +24,12 @@
 #include "libfork/core/ext/tls.hpp"              // for has_stack, thread_stack, has_context
 #include "libfork/core/first_arg.hpp"            // for async_function_object
 #include "libfork/core/impl/combinate.hpp"       // for quasi_awaitable, y_combinate
+#include "libfork/core/impl/frame.hpp"           // for root_notifier
 #include "libfork/core/impl/manual_lifetime.hpp" // for manual_lifetime
 #include "libfork/core/impl/stack.hpp"           // for stack
 #include "libfork/core/impl/utility.hpp"
 #include "libfork/core/invocable.hpp" // for async_result_t, rootable, ignore_t
-#include "libfork/core/macro.hpp"     // for LF_THROW, LF_CLANG_TLS_NOINLINE
+#include "libfork/core/macro.hpp"     // for LF_THROW, LF_CLANG_TLS_NOINLINE, LF_PROBE
 #include "libfork/core/scheduler.hpp" // for scheduler
 #include "libfork/core/tag.hpp"       // for tag, none
 #include "libfork/core/task.hpp"      // for returnable
@@ -61,6 +62,28 @@ enum class future_state {
   retrievd,
 };
 
+/**
+ * @brief A root notifier that releases a semaphore.
+ */
+class root_semaphore : public root_notifier {
+ public:
+  /**
+   * @brief Construct an unsignalled semaphore.
+   */
+  root_semaphore() noexcept
+      : root_notifier{[](root_notifier *self) noexcept {
+          static_cast<root_semaphore *>(self)->m_sem.release();
+        }} {}
+
+  /**
+   * @brief Wait (__block__) until the root has been notified.
+   */
+  void acquire() { m_sem.acquire(); }
+
+ private:
+  std::binary_semaphore m_sem{0};
+};
+
 /**
  * @brief The shared state of a future.
  */
@@ -81,7 +104,7 @@ struct future_shared_state : try_eventually<R> {
   /**
    * @brief The root task's notification semaphore.
    */
-  std::binary_semaphore sem{0};
+  root_semaphore sem;
   /**
    * @brief The state of the future.
    */
@@ -269,8 +292,8 @@ schedule(Sch &&sch, F &&fun, Args &&...args) -> future<async_result_t<F, Args...
   impl::y_combinate combinator = combinate<tag::root, modifier::none>(share_state, std::forward<F>(fun));
   // This allocates a coroutine on this threads stack.
   impl::quasi_awaitable await = std::move(combinator)(std::forward<Args>(args)...);
-  // Set the root semaphore.
-  await->set_root_sem(&share_state->sem);
+  // Set the root notifier.
+  await->set_root_notifier(&share_state->sem);
 
   // If this throws then `await` will clean up the coroutine.
   impl::ignore_t{} = impl::tls::thread_stack->release();
@@ -278,6 +301,8 @@ schedule(Sch &&sch, F &&fun, Args &&...args) -> future<async_result_t<F, Args...
   // We will pass a pointer to this to .schedule()
   share_state->node.construct(std::bit_cast<impl::submit_t *>(await.get()));
 
+  LF_PROBE(root_submit, await.get());
+
   // Schedule upholds the strong exception guarantee hence, if it throws `await` cleans up.
   std::forward<Sch>(sch).schedule(share_state->node.data());
   // If -^ didn't throw then we release ownership of the coroutine, it will be cleaned up by the worker.
@@ -0,0 +1,22 @@
+#ifndef F2A94D6B_37C1_4E8A_B5D2_9E0C6A41F7B3
+#define F2A94D6B_37C1_4E8A_B5D2_9E0C6A41F7B3
+
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "libfork/io/uring.hpp"
+
+/**
+ * @file io.hpp
+ *
+ * @brief Meta header which includes all the asynchronous I/O in ``libfork/io``.
+ *
+ * The I/O is platform specific, on platforms without support the headers are empty.
+ */
+
+#endif /* F2A94D6B_37C1_4E8A_B5D2_9E0C6A41F7B3 */
@@ -0,0 +1,532 @@
+#ifndef E8B3C51A_6F2D_4A7E_9C14_3D5F8A2B6E07
+#define E8B3C51A_6F2D_4A7E_9C14_3D5F8A2B6E07
+
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#if __has_include(<linux/io_uring.h>)
+
+  #include <algorithm>    // for max, min
+  #include <array>        // for array
+  #include <atomic>       // for atomic, atomic_ref, memory_order_acquire, memory_order_release
+  #include <bit>          // for bit_cast
+  #include <cerrno>       // for errno, EINTR, EAGAIN, EBUSY, ETIME
+  #include <chrono>       // for nanoseconds, seconds, duration_cast
+  #include <cstddef>      // for size_t, byte
+  #include <cstdint>      // for uint8_t, uint32_t, uint64_t, uintptr_t
+  #include <cstring>      // for memset
+  #include <limits>       // for numeric_limits
+  #include <mutex>        // for mutex, lock_guard
+  #include <span>         // for span
+  #include <system_error> // for system_error, system_category
+  #include <thread>       // for yield
+
+  #include <linux/io_uring.h> // for io_uring_params, io_uring_sqe, io_uring_cqe, IORING_FEAT_EXT_ARG, ...
+  #include <sys/mman.h>       // for mmap, munmap, MAP_FAILED
+  #include <sys/syscall.h>    // for __NR_io_uring_setup, __NR_io_uring_enter
+  #include <unistd.h>         // for syscall, close
+
+  #include "libfork/core/ext/context.hpp"     // for worker_context
+  #include "libfork/core/ext/handles.hpp"     // for submit_handle
+  #include "libfork/core/ext/tls.hpp"         // for context
+  #include "libfork/core/impl/utility.hpp"    // for immovable, non_null
+  #include "libfork/core/macro.hpp"           // for LF_ASSERT, LF_THROW, LF_TRY, LF_CATCH_ALL, LF_RETHROW
+  #include "libfork/core/scheduler.hpp"       // for context_switcher
+  #include "libfork/schedule/ext/reactor.hpp" // for reactor
+
+/**
+ * @file uring.hpp
+ *
+ * @brief Asynchronous file I/O for tasks backed by Linux's io_uring.
+ *
+ * The ring is driven through the raw system calls, liburing is not required.
+ */
+
+namespace lf {
+
+namespace impl {
+
+/**
+ * @brief The state of an in-flight io_uring operation, lives in the awaiting task's frame.
+ */
+struct uring_op {
+  /**
+   * @brief The suspended task.
+   */
+  submit_handle handle = nullptr;
+  /**
+   * @brief The worker the task was suspended on and will be resumed on.
+   */
+  worker_context *home = nullptr;
+  /**
+   * @brief The result of the operation as reported by the kernel, negative values are errors.
+   */
+  int result = 0;
+};
+
+} // namespace impl
+
+namespace io {
+
+/**
+ * @brief An io_uring instance, driven by a pool's workers, that completes operations by rescheduling the
+ * awaiting task.
+ *
+ * The ring is an `lf::ext::reactor`, it must be attached to the pool whose tasks await it, e.g.
+ * ``lazy_pool pool{n, numa_strategy::fan, {.events = &ring}}``. Operations are submitted by the worker
+ * that awaits them, when several workers submit at once one ``io_uring_enter`` submits all their entries.
+ * The pool's idle workers reap completions in `poll()` and reschedule each task (with
+ * `lf::ext::worker_context::schedule`) on the worker it was suspended on. Hence, no worker ever blocks on
+ * I/O and there is no dedicated I/O thread. Completions are delayed while every worker is busy.
+ *
+ * \rst
+ *
+ * .. warning::
+ *    A ring must outlive all the operations submitted to it and the pools it is attached to.
+ *
+ * \endrst
+ */
+class uring final : public reactor, impl::immovable<uring> {
+ public:
+  /**
+   * @brief Construct a ring with space for `entries` submissions, throws `std::system_error` on failure.
+   */
+  explicit uring(unsigned entries = k_default_entries) {
+
+    io_uring_params params{};
+
+    m_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+
+    if (m_fd < 0) {
+      LF_THROW(std::system_error(errno, std::system_category(), "io_uring_setup"));
+    }
+
+  #ifdef IORING_FEAT_EXT_ARG
+    m_timeouts = (params.features & IORING_FEAT_EXT_ARG) != 0;
+  #endif
+
+    LF_TRY { map(params); }
+    LF_CATCH_ALL {
+      unmap();
+      LF_RETHROW;
+    }
+  }
+
+  /**
+   * @brief The number of submitted operations that have not completed, supports concurrent access.
+   */
+  [[nodiscard]] auto in_flight() const noexcept -> std::size_t {
+    return m_in_flight.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Submit an operation, `op` is rescheduled on its home worker when it completes.
+   */
+  void
+  submit(impl::uring_op *op, std::uint8_t opcode, int fd, void *addr, std::uint32_t len, std::uint64_t off) {
+    m_in_flight.fetch_add(1, std::memory_order_relaxed);
+    flush(push(std::bit_cast<std::uint64_t>(op), opcode, fd, addr, len, off));
+  }
+
+  /**
+   * @brief Reschedule the tasks whose operations have completed, blocking for at most `timeout`.
+   *
+   * Finite, non-zero timeouts need Linux 5.11 (and its headers), otherwise they are treated as zero.
+   */
+  auto poll(std::chrono::nanoseconds timeout) noexcept -> std::size_t override {
+
+    std::size_t completed = 0;
+
+    if (reap(completed) || timeout == std::chrono::nanoseconds::zero()) {
+      return completed;
+    }
+
+    int ret = 0;
+
+    if (timeout < std::chrono::nanoseconds::zero()) {
+      ret = enter(0, 1, IORING_ENTER_GETEVENTS);
+    } else if (m_timeouts) {
+      ret = wait_for(timeout);
+    }
+
+    if (ret < 0 && !transient(-ret) && ret != -ETIME) {
+      LF_ASSERT(false && "io_uring_enter failed");
+    }
+
+    reap(completed);
+
+    return completed;
+  }
+
+  /**
+   * @brief Make a current or subsequent call to `poll()` return promptly, supports concurrent access.
+   */
+  void wake() noexcept override {
+    // Wake-ups are coalesced, at most one no-op is queued at a time.
+    if (!m_woken.exchange(true, std::memory_order_acq_rel)) {
+      flush(push(0, IORING_OP_NOP, -1, nullptr, 0, 0));
+    }
+  }
+
+  /**
+   * @brief Close the ring, all submitted operations must have completed.
+   */
+  ~uring() noexcept {
+    LF_ASSERT(in_flight() == 0);
+    unmap();
+  }
+
+ private:
+  static constexpr unsigned k_default_entries = 256;
+
+  /**
+   * @brief The number of completions copied out of the ring at a time.
+   */
+  static constexpr std::size_t k_reap_batch = 64;
+
+  /**
+   * @brief Test if a failed `io_uring_enter` should be retried.
+   */
+  static auto transient(int err) noexcept -> bool { return err == EINTR || err == EAGAIN || err == EBUSY; }
+
+  /**
+   * @brief Map the submission/completion rings and the submission entries.
+   */
+  void map(io_uring_params const &params) {
+
+    m_sq_bytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cq_bytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+    if (single) {
+      m_sq_bytes = m_cq_bytes = std::max(m_sq_bytes, m_cq_bytes);
+    }
+
+    m_sq_ring = mmap_or_throw(m_sq_bytes, IORING_OFF_SQ_RING);
+    m_cq_ring = single ? m_sq_ring : mmap_or_throw(m_cq_bytes, IORING_OFF_CQ_RING);
+
+    m_sqe_bytes = params.sq_entries * sizeof(io_uring_sqe);
+    m_sqes = static_cast<io_uring_sqe *>(mmap_or_throw(m_sqe_bytes, IORING_OFF_SQES));
+
+    auto *sq = static_cast<std::byte *>(m_sq_ring);
+    auto *cq = static_cast<std::byte *>(m_cq_ring);
+
+    m_sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    m_sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    m_sq_mask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    m_sq_entries = params.sq_entries;
+    m_sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+
+    m_cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    m_cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    m_cq_mask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+  }
+
+  /**
+   * @brief Map a region of the ring.
+   */
+  auto mmap_or_throw(std::size_t bytes, off_t offset) const -> void * {
+
+    void *ptr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, offset);
+
+    if (ptr == MAP_FAILED) {
+      LF_THROW(std::system_error(errno, std::system_category(), "io_uring mmap"));
+    }
+
+    return ptr;
+  }
+
+  /**
+   * @brief Release whatever has been mapped and close the ring.
+   */
+  void unmap() noexcept {
+    if (m_sqes != MAP_FAILED) {
+      ::munmap(m_sqes, m_sqe_bytes);
+    }
+    if (m_cq_ring != MAP_FAILED && m_cq_ring != m_sq_ring) {
+      ::munmap(m_cq_ring, m_cq_bytes);
+    }
+    if (m_sq_ring != MAP_FAILED) {
+      ::munmap(m_sq_ring, m_sq_bytes);
+    }
+    ::close(m_fd);
+  }
+
+  /**
+   * @brief Call `io_uring_enter`, returns the result or `-errno`.
+   */
+  auto enter(unsigned to_submit, unsigned min_complete, unsigned flags, void const *arg = nullptr,
+             std::size_t arg_size = 0) noexcept -> int {
+    long ret = ::syscall(__NR_io_uring_enter, m_fd, to_submit, min_complete, flags, arg, arg_size);
+    return ret < 0 ? -errno : static_cast<int>(ret);
+  }
+
+  /**
+   * @brief Wait for at least one completion or until `timeout` has elapsed, returns the result or `-errno`.
+   *
+   * Only called if the kernel supports timed waits.
+   */
+  auto wait_for([[maybe_unused]] std::chrono::nanoseconds timeout) noexcept -> int {
+  #ifdef IORING_ENTER_EXT_ARG
+
+    auto secs = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+
+    __kernel_timespec spec{.tv_sec = secs.count(), .tv_nsec = (timeout - secs).count()};
+
+    io_uring_getevents_arg arg{};
+    arg.ts = std::bit_cast<std::uintptr_t>(&spec);
+
+    return enter(0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+  #else
+    LF_ASSERT(false && "Timed waits need Linux 5.11 headers");
+    return 0;
+  #endif
+  }
+
+  /**
+   * @brief Test if the kernel has consumed the submission entries before `tail`.
+   */
+  auto consumed(unsigned tail) const noexcept -> bool {
+    unsigned head = std::atomic_ref{*m_sq_head}.load(std::memory_order_acquire);
+    return static_cast<int>(tail - head) <= 0;
+  }
+
+  /**
+   * @brief Write a submission entry, returns the tail of the submission ring after it.
+   *
+   * The lock is only held while the entry is written, it is not held across the system call.
+   */
+  auto push(std::uint64_t user_data, std::uint8_t opcode, int fd, void *addr, std::uint32_t len,
+            std::uint64_t off) noexcept -> unsigned {
+    for (;;) {
+
+      unsigned tail = 0;
+
+      {
+        std::lock_guard lock{m_sq_mutex};
+
+        tail = *m_sq_tail;
+
+        if (consumed(tail + 1 - m_sq_entries)) {
+
+          unsigned index = tail & m_sq_mask;
+
+          io_uring_sqe *sqe = m_sqes + index;
+
+          std::memset(sqe, 0, sizeof(io_uring_sqe));
+
+          sqe->opcode = opcode;
+          sqe->fd = fd;
+          sqe->addr = std::bit_cast<std::uintptr_t>(addr);
+          sqe->len = len;
+          sqe->off = off;
+          sqe->user_data = user_data;
+
+          m_sq_array[index] = index;
+
+          std::atomic_ref{*m_sq_tail}.store(tail + 1, std::memory_order_release);
+
+          return tail + 1;
+        }
+      }
+
+      // The submission ring is full, make the kernel consume it.
+      flush(tail);
+    }
+  }
+
+  /**
+   * @brief Make sure the kernel has consumed the submission entries before `tail`.
+   *
+   * If a concurrent `io_uring_enter` has already submitted them then we skip the system call.
+   */
+  void flush(unsigned tail) noexcept {
+    while (!consumed(tail)) {
+      if (int ret = enter(m_sq_entries, 0, 0); ret < 0) {
+        if (ret == -EBUSY) {
+          // The completion queue is full, make room.
+          std::size_t completed = 0;
+          reap(completed);
+        } else if (!transient(-ret)) {
+          LF_ASSERT(false && "io_uring_enter failed");
+          return;
+        }
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  /**
+   * @brief Reschedule the tasks whose operations have completed, supports concurrent access.
+   *
+   * Adds the number of completed operations to `completed`, returns true if any completion (including a
+   * wake-up) was consumed.
+   */
+  auto reap(std::size_t &completed) noexcept -> bool {
+
+    bool any = false;
+
+    for (;;) {
+
+      std::array<impl::uring_op *, k_reap_batch> done; // NOLINT
+      std::size_t count = 0;
+
+      {
+        std::lock_guard lock{m_cq_mutex};
+
+        unsigned head = *m_cq_head;
+        unsigned tail = std::atomic_ref{*m_cq_tail}.load(std::memory_order_acquire);
+
+        for (; head != tail && count < k_reap_batch; ++head) {
+
+          io_uring_cqe const &cqe = m_cqes[head & m_cq_mask];
+
+          any = true;
+
+          if (cqe.user_data == 0) {
+            // Pairs with the exchange in `wake()`, a waker that sees true will find our caller awake.
+            m_woken.store(false, std::memory_order_release);
+            continue;
+          }
+
+          auto *op = std::bit_cast<impl::uring_op *>(cqe.user_data);
+          op->result = cqe.res;
+          done[count++] = op;
+        }
+
+        std::atomic_ref{*m_cq_head}.store(head, std::memory_order_release);
+      }
+
+      if (count == 0) {
+        return any;
+      }
+
+      for (impl::uring_op *op : std::span{done}.first(count)) {
+        // Read everything before scheduling, the op is in the task's frame which may then be destroyed.
+        worker_context *home = op->home;
+        submit_handle handle = op->handle;
+        m_in_flight.fetch_sub(1, std::memory_order_relaxed);
+        home->schedule(handle);
+      }
+
+      completed += count;
+    }
+  }
+
+  int m_fd = -1;
+  bool m_timeouts = false;
+
+  void *m_sq_ring = MAP_FAILED;
+  void *m_cq_ring = MAP_FAILED;
+
+  std::size_t m_sq_bytes = 0;
+  std::size_t m_cq_bytes = 0;
+  std::size_t m_sqe_bytes = 0;
+
+  io_uring_sqe *m_sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+  unsigned *m_sq_head = nullptr;
+  unsigned *m_sq_tail = nullptr;
+  unsigned *m_sq_array = nullptr;
+  unsigned m_sq_mask = 0;
+  unsigned m_sq_entries = 0;
+
+  unsigned *m_cq_head = nullptr;
+  unsigned *m_cq_tail = nullptr;
+  io_uring_cqe *m_cqes = nullptr;
+  unsigned m_cq_mask = 0;
+
+  std::mutex m_sq_mutex;
+  std::mutex m_cq_mutex;
+  std::atomic<bool> m_woken = false;
+  std::atomic<std::size_t> m_in_flight = 0;
+};
+
+/**
+ * @brief An `lf::core::context_switcher` that suspends a task until a read or write completes.
+ */
+template <std::uint8_t Opcode>
+class [[nodiscard("This should be immediately co_awaited")]] uring_awaitable : impl::uring_op {
+ public:
+  /**
+   * @brief Prepare an operation of `len` bytes at `addr` on `fd` at offset `off`.
+   *
+   * Operations of more than 4GiB are truncated, they complete with a short read/write.
+   */
+  uring_awaitable(uring &ring, int fd, void *addr, std::size_t len, std::uint64_t off) noexcept
+      : m_ring{&ring},
+        m_fd{fd},
+        m_addr{addr},
+        m_len{static_cast<std::uint32_t>(std::min<std::size_t>(len, k_max_len))},
+        m_off{off} {}
+
+  /**
+   * @brief Always suspend.
+   */
+  static auto await_ready() noexcept -> bool { return false; }
+
+  /**
+   * @brief Submit the operation, this task will be resumed on this worker when it completes.
+   */
+  void await_suspend(submit_handle task) {
+    this->handle = task;
+    this->home = impl::non_null(impl::tls::context());
+    // After this the operation may complete (and this task resume) at any time.
+    m_ring->submit(this, Opcode, m_fd, m_addr, m_len, m_off);
+  }
+
+  /**
+   * @brief Get the number of bytes transferred, throws `std::system_error` if the operation failed.
+   */
+  auto await_resume() const -> std::size_t {
+    if (this->result < 0) {
+      LF_THROW(std::system_error(-this->result, std::system_category(), "io_uring operation"));
+    }
+    return static_cast<std::size_t>(this->result);
+  }
+
+ private:
+  /**
+   * @brief The largest length an io_uring submission can express.
+   */
+  static constexpr std::size_t k_max_len = std::numeric_limits<std::uint32_t>::max();
+
+  uring *m_ring;
+  int m_fd;
+  void *m_addr;
+  std::uint32_t m_len;
+  std::uint64_t m_off;
+};
+
+static_assert(context_switcher<uring_awaitable<IORING_OP_READ>>);
+
+/**
+ * @brief Read from `fd` at offset `off` into `buf`, ``co_await`` the result to get the bytes read.
+ */
+inline auto read(uring &ring, int fd, std::span<std::byte> buf, std::uint64_t off) noexcept
+    -> uring_awaitable<IORING_OP_READ> {
+  return {ring, fd, buf.data(), buf.size(), off};
+}
+
+/**
+ * @brief Write `buf` to `fd` at offset `off`, ``co_await`` the result to get the bytes written.
+ */
+inline auto write(uring &ring, int fd, std::span<std::byte const> buf, std::uint64_t off) noexcept
+    -> uring_awaitable<IORING_OP_WRITE> {
+  // The kernel does not write through the pointer.
+  return {ring, fd, const_cast<std::byte *>(buf.data()), buf.size(), off}; // NOLINT
+}
+
+} // namespace io
+
+} // namespace lf
+
+#endif
+
+#endif /* E8B3C51A_6F2D_4A7E_9C14_3D5F8A2B6E07 */
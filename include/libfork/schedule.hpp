@@ -13,9 +13,15 @@
 #include "libfork/schedule/lazy_pool.hpp"
 #include "libfork/schedule/unit_pool.hpp"
 
+#include "libfork/schedule/ext/arbiter.hpp"
 #include "libfork/schedule/ext/event_count.hpp"
 #include "libfork/schedule/ext/numa.hpp"
+#include "libfork/schedule/ext/options.hpp"
 #include "libfork/schedule/ext/random.hpp"
+#include "libfork/schedule/ext/reactor.hpp"
+#include "libfork/schedule/ext/stall_detector.hpp"
+#include "libfork/schedule/ext/timer.hpp"
+#include "libfork/schedule/ext/utilization.hpp"
 
 #include "libfork/schedule/impl/numa_context.hpp"
 
@@ -9,26 +9,29 @@
 // License, v. 2.0. If a copy of the MPL was not distributed with this
 // file, You can obtain one at https://mozilla.org/MPL/2.0/.
 
-#include <atomic>  // for atomic_flag, memory_order_acquire, mem...
-#include <cstddef> // for size_t, ptrdiff_t
-#include <latch>   // for latch
-#include <memory>  // for shared_ptr, __shared_ptr_access, make_...
-#include <random>  // for random_device, uniform_int_distribution
-#include <span>    // for span
-#include <thread>  // for thread
-#include <utility> // for move
-#include <vector>  // for vector
+#include <atomic>    // for atomic_flag, memory_order_acquire, mem...
+#include <cstddef>   // for size_t, ptrdiff_t
+#include <latch>     // for latch
+#include <memory>    // for shared_ptr, __shared_ptr_access, make_...
+#include <random>    // for random_device, uniform_int_distribution
+#include <span>      // for span
+#include <stdexcept> // for invalid_argument
+#include <thread>    // for thread
+#include <utility>   // for move
+#include <vector>    // for vector
 
 #include "libfork/core/defer.hpp"                 // for LF_DEFER
-#include "libfork/core/ext/context.hpp"           // for worker_context, nullary_function_t
+#include "libfork/core/ext/context.hpp"           // for worker_context, nullary_function_t, worker_memory
 #include "libfork/core/ext/handles.hpp"           // for submit_handle, task_handle
-#include "libfork/core/ext/resume.hpp"            // for resume
-#include "libfork/core/impl/utility.hpp"          // for checked_cast, k_cache_line
-#include "libfork/core/macro.hpp"                 // for LF_ASSERT, LF_ASSERT_NO_ASSUME, LF_LOG
+#include "libfork/core/impl/utility.hpp"          // for checked_cast, k_cache_line, map
+#include "libfork/core/macro.hpp"                 // for LF_ASSERT, LF_ASSERT_NO_ASSUME, LF_LOG, LF_THROW
 #include "libfork/core/scheduler.hpp"             // for scheduler
+#include "libfork/core/sender.hpp"                // for execution_scheduler
 #include "libfork/schedule/ext/numa.hpp"          // for numa_strategy, numa_topology
+#include "libfork/schedule/ext/options.hpp"       // for pool_options
 #include "libfork/schedule/ext/random.hpp"        // for xoshiro, seed
-#include "libfork/schedule/impl/numa_context.hpp" // for numa_context
+#include "libfork/schedule/ext/utilization.hpp"   // for worker_utilization
+#include "libfork/schedule/impl/numa_context.hpp" // for numa_context, root_workers
 
 /**
  * @file busy_pool.hpp
@@ -63,8 +66,45 @@ struct busy_vars {
    * @brief Signal shutdown.
    */
   alignas(k_cache_line) std::atomic_flag stop;
+  /**
+   * @brief If set (before the workers start) workers pre-fault their stack and deque.
+   */
+  bool warm_up = false;
+  /**
+   * @brief If set (before the workers start) workers use private deques.
+   */
+  bool private_deques = false;
 };
 
+/**
+ * @brief Start a thread running `work(std::move(nodes[i]))` for each node.
+ *
+ * The threads are started as a binary tree: each new thread starts (up to) two more before it runs its own
+ * node, hence the latency of starting `n` threads is logarithmic in `n`. This is noexcept as a worker that
+ * is never started would hang the others on the start latch. The `nodes` and `threads` must not be touched
+ * by the caller until every worker has arrived at the start latch.
+ */
+template <typename Node, typename Work>
+void start_workers(std::vector<std::thread> &threads, std::vector<Node> &nodes, Work work) noexcept {
+
+  threads.resize(nodes.size());
+
+  auto start = [&threads, &nodes, work](auto self, std::size_t i) noexcept -> void {
+    threads[i] = std::thread{[self, i, &nodes, work]() noexcept {
+      for (std::size_t child : {2 * i + 1, 2 * i + 2}) {
+        if (child < nodes.size()) {
+          self(self, child);
+        }
+      }
+      work(std::move(nodes[i]));
+    }};
+  };
+
+  if (!nodes.empty()) {
+    start(start, 0);
+  }
+}
+
 /**
  * @brief Workers event-loop.
  */
@@ -77,7 +117,9 @@ inline void busy_work(numa_topology::numa_node<impl::numa_context<busy_vars>> no
 
   std::shared_ptr my_context = node.neighbors.front().front();
 
-  my_context->init_worker_and_bind(nullary_function_t{[]() {}}, node); // Notification is a no-op.
+  // Notification is a no-op.
+  my_context->init_worker_and_bind(
+      nullary_function_t{[]() {}}, node, my_context->shared().warm_up, my_context->shared().private_deques);
 
   // Wait for everyone to have set up their numa_vars. If this throws an exception then
   // program terminates due to the noexcept marker.
@@ -95,18 +137,18 @@ inline void busy_work(numa_topology::numa_node<impl::numa_context<busy_vars>> no
   while (!my_context->shared().stop.test(std::memory_order_acquire)) {
 
     if (submit_handle submissions = my_context->try_pop_all()) {
-      resume(submissions);
+      my_context->resume(submissions);
       continue;
     }
 
     if (task_handle task = my_context->try_steal()) {
-      resume(task);
+      my_context->resume(task);
     }
   }
 
   // Finish up any remaining work.
   while (submit_handle submissions = my_context->try_pop_all()) {
-    resume(submissions);
+    my_context->resume(submissions);
   }
 }
 
@@ -132,6 +174,7 @@ class busy_pool {
   std::vector<std::shared_ptr<impl::numa_context<impl::busy_vars>>> m_worker = {};
   std::vector<std::thread> m_threads = {};
   std::vector<worker_context *> m_contexts = {};
+  std::vector<std::size_t> m_roots = {};
 
  public:
   /**
@@ -156,11 +199,18 @@ class busy_pool {
    *
    * @param n The number of worker threads to create, defaults to the number of hardware threads.
    * @param strategy The numa strategy for distributing workers.
+   * @param options Less common settings, see `lf::ext::pool_options`, a busy pool cannot use an arbiter or
+   * a reactor (this throws `std::invalid_argument` if either is set).
    */
   explicit busy_pool(std::size_t n = std::thread::hardware_concurrency(),
-                     numa_strategy strategy = numa_strategy::fan)
+                     numa_strategy strategy = numa_strategy::fan,
+                     pool_options const &options = {})
       : m_num_threads(n) {
 
+    if (options.arbiter != nullptr || options.events != nullptr) {
+      LF_THROW(std::invalid_argument("A busy_pool cannot use an arbiter or a reactor"));
+    }
+
     for (std::size_t i = 0; i < n; ++i) {
       m_worker.push_back(std::make_shared<impl::numa_context<impl::busy_vars>>(m_rng, m_share));
       m_rng.long_jump();
@@ -168,14 +218,18 @@ class busy_pool {
 
     LF_ASSERT_NO_ASSUME(!m_share->stop.test(std::memory_order_acquire));
 
-    std::vector nodes = numa_topology{}.distribute(m_worker, strategy);
+    std::vector nodes = options.topology.distribute(m_worker, strategy, options.placement);
+
+    m_roots = impl::root_workers(nodes, options.prefer_fast_cores);
+    m_dist = std::uniform_int_distribution<std::size_t>{0, m_roots.size() - 1};
+
+    m_share->warm_up = options.warm_up;
+    m_share->private_deques = options.private_deques;
 
     [&]() noexcept {
       // All workers must be created, if we fail to create them all then we must
       // terminate else the workers will hang on the start latch.
-      for (auto &&node : nodes) {
-        m_threads.emplace_back(impl::busy_work, std::move(node));
-      }
+      impl::start_workers(m_threads, nodes, impl::busy_work);
 
       // Wait for everyone to have set up their numa_vars before submitting. This
       // must be noexcept as if we fail the countdown then the workers will hang.
@@ -191,13 +245,39 @@ class busy_pool {
   /**
    * @brief Schedule a task for execution.
    */
-  void schedule(submit_handle job) { m_worker[m_dist(m_rng)]->schedule(job); }
+  void schedule(submit_handle job) { m_worker[m_roots[m_dist(m_rng)]]->schedule(job); }
+
+  /**
+   * @brief Get a P2300 scheduler handle to this pool, see `lf::core::as_sender`.
+   */
+  [[nodiscard]] auto get_scheduler() noexcept { return execution_scheduler{*this}; }
 
   /**
    * @brief Get a view of the worker's contexts.
    */
   auto contexts() noexcept -> std::span<worker_context *> { return m_contexts; }
 
+  /**
+   * @brief Get a snapshot of the time each worker has spent executing and searching for tasks.
+   *
+   * Busy workers never sleep, time spent spinning in steal loops is reported as searching. This is all
+   * zeros unless ``LF_UTILIZATION`` is defined.
+   */
+  [[nodiscard]] auto utilization() const -> std::vector<worker_utilization> {
+    return impl::map(m_worker, [](auto const &worker) {
+      return worker->utilization();
+    });
+  }
+
+  /**
+   * @brief Get a snapshot of the memory held by each worker's stack, deque and submission queue.
+   */
+  [[nodiscard]] auto memory_report() const -> std::vector<worker_memory> {
+    return impl::map(m_contexts, [](worker_context const *context) {
+      return context->memory();
+    });
+  }
+
   ~busy_pool() noexcept {
     LF_LOG("Requesting a stop");
     // Set conditions for workers to stop
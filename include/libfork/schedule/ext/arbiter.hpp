@@ -0,0 +1,338 @@
+#ifndef D6A4F2C8_1E7B_4B39_A5D0_8C3F9E2B7A14
+#define D6A4F2C8_1E7B_4B39_A5D0_8C3F9E2B7A14
+
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <algorithm> // for max
+#include <array>     // for array
+#include <atomic>    // for atomic, memory_order_relaxed, memory_order_seq_cst
+#include <cstddef>   // for size_t, ptrdiff_t
+#include <cstdint>   // for uint8_t
+#include <stdexcept> // for invalid_argument, length_error
+#include <thread>    // for thread, yield
+#include <utility>   // for move
+
+#include "libfork/core/ext/context.hpp"  // for nullary_function_t
+#include "libfork/core/impl/utility.hpp" // for immovable, k_cache_line, checked_cast
+#include "libfork/core/macro.hpp"        // for LF_ASSERT, LF_THROW
+
+/**
+ * @file arbiter.hpp
+ *
+ * @brief A process-wide budget of running workers shared between pools.
+ */
+
+namespace lf {
+
+inline namespace ext {
+
+/**
+ * @brief Limits the total number of running workers across a set of pools.
+ *
+ * If several pools each have a worker per core then the machine is oversubscribed by the number of
+ * pools. A pool constructed with an arbiter requires each of its workers to hold one of the arbiter's
+ * tokens while it is searching for work or executing a task. Workers that cannot get a token park (on
+ * their pool's `lf::ext::event_count`) until one is released.
+ *
+ * A pool registers demand when it has active workers but some of its workers are parked. While another
+ * pool, holding less than its fair share of the tokens (the capacity divided by the number of pools), has
+ * demand a pool cannot hold more than its fair share and workers holding more than this yield their token
+ * at the next scheduling point. A running task is never preempted, hence fairness is only at task
+ * granularity. Returning a token (and waking a parked pool) is lock-free.
+ *
+ * A worker always takes a token to run a task submitted to it, hence the number of running workers can
+ * temporarily exceed the capacity by the number of concurrent submissions. Borrowed tokens are repaid at
+ * the next scheduling point of any worker over the capacity.
+ *
+ * \rst
+ *
+ * .. warning::
+ *    An arbiter must outlive the pools that use it.
+ *
+ * \endrst
+ */
+class thread_arbiter : impl::immovable<thread_arbiter> {
+ public:
+  /**
+   * @brief Construct an arbiter that allows `tokens` running workers, `tokens` must be positive.
+   */
+  explicit thread_arbiter(std::size_t tokens = std::thread::hardware_concurrency())
+      : m_capacity(impl::checked_cast<std::ptrdiff_t>(tokens)),
+        m_free(m_capacity) {
+    if (tokens == 0) {
+      LF_THROW(std::invalid_argument("An arbiter needs at least one token"));
+    }
+  }
+
+  /**
+   * @brief Get the process-wide arbiter with a token per hardware thread.
+   */
+  [[nodiscard]] static auto global() -> thread_arbiter & {
+    static thread_arbiter arbiter;
+    return arbiter;
+  }
+
+  /**
+   * @brief The number of tokens this arbiter was constructed with.
+   */
+  [[nodiscard]] auto capacity() const noexcept -> std::size_t { return static_cast<std::size_t>(m_capacity); }
+
+  /**
+   * @brief The number of tokens currently held by workers, supports concurrent access.
+   */
+  [[nodiscard]] auto running() const noexcept -> std::size_t {
+    return static_cast<std::size_t>(m_capacity - m_free.load(std::memory_order_relaxed));
+  }
+
+  /**
+   * @brief The number of workers parked waiting for a token, supports concurrent access.
+   */
+  [[nodiscard]] auto parked() const noexcept -> std::size_t {
+    return m_parked.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief The maximum number of pools that can share an arbiter at once.
+   */
+  static constexpr std::size_t k_max_clients = 64;
+
+ private:
+  /**
+   * @brief The state of a registered pool, owned by the arbiter such that it can be read lock-free.
+   */
+  struct slot {
+    /**
+     * @brief The lifecycle of a slot, `wake` may only be called while `ready`.
+     */
+    enum class status : std::uint8_t { free, claimed, ready, closing };
+
+    alignas(impl::k_cache_line) std::atomic<std::size_t> held = 0;
+    std::atomic<std::size_t> parked = 0;
+    std::atomic<status> state = status::free;
+    std::atomic<std::size_t> wakers = 0;
+    nullary_function_t wake;
+  };
+
+ public:
+  /**
+   * @brief A pool's registration with an arbiter, a pool's workers share one client.
+   */
+  class client : impl::immovable<client> {
+   public:
+    /**
+     * @brief Register with `arbiter`, `wake` is called (from any worker of any pool) to unpark workers.
+     *
+     * Throws `std::length_error` if `arbiter` already has `k_max_clients` clients.
+     */
+    client(thread_arbiter &arbiter, nullary_function_t wake) : m_arbiter(&arbiter) {
+
+      for (slot &elem : m_arbiter->m_slots) {
+        if (auto expect = slot::status::free;
+            elem.state.compare_exchange_strong(expect, slot::status::claimed, std::memory_order_acquire)) {
+          m_slot = &elem;
+          break;
+        }
+      }
+
+      if (m_slot == nullptr) {
+        LF_THROW(std::length_error("Too many pools share this arbiter"));
+      }
+
+      m_slot->wake = std::move(wake);
+      m_slot->state.store(slot::status::ready, std::memory_order_seq_cst);
+
+      std::size_t index = static_cast<std::size_t>(m_slot - m_arbiter->m_slots.data()) + 1;
+
+      for (std::size_t size = m_arbiter->m_size.load(std::memory_order_relaxed); size < index;) {
+        if (m_arbiter->m_size.compare_exchange_weak(size, index, std::memory_order_release)) {
+          break;
+        }
+      }
+
+      m_arbiter->m_num_clients.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Unregister from the arbiter, all tokens must have been released.
+     */
+    ~client() noexcept {
+      LF_ASSERT(m_slot->held.load(std::memory_order_relaxed) == 0);
+      LF_ASSERT(m_slot->parked.load(std::memory_order_relaxed) == 0);
+
+      m_arbiter->m_num_clients.fetch_sub(1, std::memory_order_relaxed);
+
+      // Pairs with wake_one(), either it sees the slot closing or we see the waker.
+      m_slot->state.store(slot::status::closing, std::memory_order_seq_cst);
+
+      while (m_slot->wakers.load(std::memory_order_seq_cst) > 0) {
+        std::this_thread::yield();
+      }
+
+      m_slot->state.store(slot::status::free, std::memory_order_release);
+    }
+
+    /**
+     * @brief Try to take a token, fails if none are free or this pool is over its fair share.
+     */
+    [[nodiscard]] auto try_acquire() noexcept -> bool {
+
+      if (over_share(m_slot->held.load(std::memory_order_relaxed))) {
+        return false;
+      }
+
+      for (std::ptrdiff_t free = m_arbiter->m_free.load(std::memory_order_seq_cst); free > 0;) {
+        if (m_arbiter->m_free.compare_exchange_weak(free, free - 1, std::memory_order_seq_cst)) {
+          m_slot->held.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    /**
+     * @brief Take a token even if none are free.
+     */
+    void acquire() noexcept {
+      m_arbiter->m_free.fetch_sub(1, std::memory_order_seq_cst);
+      m_slot->held.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Return a token and wake a parked worker if there is one, this is lock-free.
+     */
+    void release() noexcept {
+
+      m_slot->held.fetch_sub(1, std::memory_order_relaxed);
+
+      // Pairs with park()/try_acquire(), either the parker sees the token or we see the parker.
+      if (m_arbiter->m_free.fetch_add(1, std::memory_order_seq_cst) >= 0) {
+        if (m_arbiter->m_parked.load(std::memory_order_seq_cst) > 0) {
+          m_arbiter->wake_one();
+        }
+      }
+    }
+
+    /**
+     * @brief Test if a worker holding a token should give it up, i.e. to repay a borrowed token or for
+     * another pool.
+     */
+    [[nodiscard]] auto should_yield() const noexcept -> bool {
+      return m_arbiter->m_free.load(std::memory_order_relaxed) < 0 ||
+             over_share(m_slot->held.load(std::memory_order_relaxed) - 1);
+    }
+
+    /**
+     * @brief Register demand for a token, call this before the final `try_acquire` of a parking worker.
+     */
+    void park() noexcept {
+      m_slot->parked.fetch_add(1, std::memory_order_seq_cst);
+      m_arbiter->m_parked.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Withdraw the demand registered by `park`.
+     */
+    void unpark() noexcept {
+      m_slot->parked.fetch_sub(1, std::memory_order_relaxed);
+      m_arbiter->m_parked.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+   private:
+    /**
+     * @brief Test if taking another token while holding `held` would exceed the fair share while another
+     * pool, below its share, waits for a token.
+     *
+     * A pool may exceed its share (the capacity divided by the number of pools) if no such pool exists,
+     * hence tokens are not left idle when the capacity is not a multiple of the number of pools.
+     */
+    [[nodiscard]] auto over_share(std::size_t held) const noexcept -> bool {
+
+      std::size_t all = m_arbiter->m_parked.load(std::memory_order_relaxed);
+
+      // The two counters are not updated atomically together.
+      if (all <= m_slot->parked.load(std::memory_order_relaxed)) {
+        return false;
+      }
+
+      std::size_t pools = std::max<std::size_t>(1, m_arbiter->m_num_clients.load(std::memory_order_relaxed));
+
+      std::size_t share = std::max<std::size_t>(1, m_arbiter->capacity() / pools);
+
+      if (held < share) {
+        return false;
+      }
+
+      std::size_t size = m_arbiter->m_size.load(std::memory_order_acquire);
+
+      for (std::size_t i = 0; i < size; ++i) {
+
+        slot const &other = m_arbiter->m_slots[i];
+
+        if (&other != m_slot && other.parked.load(std::memory_order_relaxed) > 0 &&
+            other.held.load(std::memory_order_relaxed) < share) {
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    thread_arbiter *m_arbiter;
+    slot *m_slot = nullptr;
+  };
+
+ private:
+  /**
+   * @brief Wake a pool with parked workers, round-robin between pools.
+   */
+  void wake_one() noexcept {
+
+    std::size_t size = m_size.load(std::memory_order_acquire);
+    std::size_t start = m_next.fetch_add(1, std::memory_order_relaxed);
+
+    for (std::size_t i = 0; i < size; ++i) {
+
+      slot &next = m_slots[(start + i) % size];
+
+      if (next.parked.load(std::memory_order_seq_cst) == 0) {
+        continue;
+      }
+
+      // Pin the client, pairs with ~client().
+      next.wakers.fetch_add(1, std::memory_order_seq_cst);
+
+      bool ready = next.state.load(std::memory_order_seq_cst) == slot::status::ready;
+
+      if (ready) {
+        next.wake();
+      }
+
+      next.wakers.fetch_sub(1, std::memory_order_release);
+
+      if (ready) {
+        return;
+      }
+    }
+  }
+
+  std::ptrdiff_t m_capacity;
+  alignas(impl::k_cache_line) std::atomic<std::ptrdiff_t> m_free;
+  alignas(impl::k_cache_line) std::atomic<std::size_t> m_parked = 0;
+  std::atomic<std::size_t> m_num_clients = 0;
+  std::atomic<std::size_t> m_size = 0;
+  std::atomic<std::size_t> m_next = 0;
+  std::array<slot, k_max_clients> m_slots;
+};
+
+} // namespace ext
+
+} // namespace lf
+
+#endif /* D6A4F2C8_1E7B_4B39_A5D0_8C3F9E2B7A14 */
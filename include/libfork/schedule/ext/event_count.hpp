@@ -136,6 +136,19 @@ class event_count : impl::immovable<event_count> {
    * @brief Wait for a notification, this blocks the current thread.
    */
   auto wait(key in_key) noexcept -> void;
+  /**
+   * @brief Test if a notification has been posted since ``prepare_wait()`` returned `in_key`.
+   *
+   * This does not consume the wait, you must still call ``wait()`` or ``cancel_wait()``.
+   */
+  [[nodiscard]] auto notified(key in_key) noexcept -> bool;
+  /**
+   * @brief Call `hook(arg)` whenever a notification finds a waiter.
+   *
+   * This lets a waiter block somewhere other than ``wait()`` (e.g. in an event loop), it must be set
+   * before the event count is shared between threads.
+   */
+  auto on_notify(void (*hook)(void *) noexcept, void *arg) noexcept -> void;
 
   /**
    * Wait for ``condition()`` to become true.
@@ -173,17 +186,26 @@ class event_count : impl::immovable<event_count> {
 
   // Stores the epoch in the most significant 32 bits and the waiter count in the least significant 32 bits.
   std::atomic<std::uint64_t> m_val = 0;
+
+  void (*m_hook)(void *) noexcept = nullptr;
+  void *m_hook_arg = nullptr;
 };
 
 inline void event_count::notify_one() noexcept {
   if (m_val.fetch_add(k_add_epoch, std::memory_order_acq_rel) & k_waiter_mask) [[unlikely]] { // NOLINT
     epoch()->notify_one();
+    if (m_hook != nullptr) {
+      m_hook(m_hook_arg);
+    }
   }
 }
 
 inline void event_count::notify_all() noexcept {
   if (m_val.fetch_add(k_add_epoch, std::memory_order_acq_rel) & k_waiter_mask) [[unlikely]] { // NOLINT
     epoch()->notify_all();
+    if (m_hook != nullptr) {
+      m_hook(m_hook_arg);
+    }
   }
 }
 
@@ -214,6 +236,15 @@ inline void event_count::wait(key in_key) noexcept {
   LF_ASSERT((prev & k_waiter_mask) != 0);
 }
 
+[[nodiscard]] inline auto event_count::notified(key in_key) noexcept -> bool {
+  return epoch()->load(std::memory_order_seq_cst) != in_key.m_epoch;
+}
+
+inline void event_count::on_notify(void (*hook)(void *) noexcept, void *arg) noexcept {
+  m_hook = hook;
+  m_hook_arg = arg;
+}
+
 template <class Pred>
   requires std::is_invocable_r_v<bool, Pred const &>
 void event_count::await(Pred const &condition) noexcept(std::is_nothrow_invocable_r_v<bool, Pred const &>) {
@@ -9,25 +9,33 @@
 // License, v. 2.0. If a copy of the MPL was not distributed with this
 // file, You can obtain one at https://mozilla.org/MPL/2.0/.
 
-#include <algorithm> // for max
-#include <cerrno>    // for ENOSYS, EXDEV, errno
+#include <algorithm> // for max, min, sort, find_if, lexicographical_compare
+#include <array>     // for array
+#include <cerrno>    // for ENOSYS, EXDEV, EINVAL, errno
 #include <climits>   // for INT_MAX
 #include <cstddef>   // for size_t
+#include <fstream>   // for ifstream
 #include <iterator>  // for distance
 #include <map>       // for map, operator==
 #include <memory>    // for shared_ptr, operator==, unique_ptr
+#include <new>       // for bad_alloc
 #include <set>       // for set
 #include <stdexcept> // for runtime_error
+#include <string>    // for string, getline, stoi, to_string
 #include <utility>   // for move
 #include <vector>    // for vector
 
 #include "libfork/core/impl/utility.hpp" // for map
-#include "libfork/core/macro.hpp"        // for LF_ASSERT, LF_STATIC_CALL, LF_STATIC_CONST
+#include "libfork/core/macro.hpp"        // for LF_ASSERT, LF_THROW, LF_TRY, LF_CATCH_ALL, LF_LOG, ...
 
 /**
  * @file numa.hpp
  *
  * @brief An abstraction over `hwloc`.
+ *
+ * If `hwloc` is not available then, on Linux, a built-in backend reads the topology from ``sysfs``. Define
+ * ``LF_NO_SYSFS`` to disable this fallback. If the built-in backend cannot read this machine's topology (or
+ * cannot bind a thread) it degrades to an empty topology (or a noop bind) rather than failing.
  */
 
 #ifdef __has_include
@@ -44,6 +52,17 @@
 static_assert(HWLOC_VERSION_MAJOR == 2, "hwloc too old");
 #endif
 
+#if !defined(LF_USE_HWLOC) && !defined(LF_NO_SYSFS) && defined(__linux__)
+  /**
+   * @brief Defined if libfork is using its built-in Linux topology backend.
+   */
+  #define LF_USE_SYSFS
+#endif
+
+#ifdef LF_USE_SYSFS
+  #include <sched.h> // for cpu_set_t, sched_setaffinity, sched_getaffinity, CPU_ALLOC, CPU_SET_S...
+#endif
+
 /**
  * @brief An opaque description of a set of processing units.
  *
@@ -84,10 +103,21 @@ inline auto hwloc_numa_support() -> bool {
 #endif
 }
 
+/**
+ * @brief Returns `true` if libfork can discover the topology, either with `hwloc` or its built-in backend.
+ */
+inline auto numa_support() -> bool {
+#if defined(LF_USE_HWLOC) || defined(LF_USE_SYSFS)
+  return true;
+#else
+  return false;
+#endif
+}
+
 // ------------- hwloc can go wrong in a lot of ways... ------------- //
 
 /**
- * @brief An exception thrown when `hwloc` fails.
+ * @brief An exception thrown when `hwloc` (or the built-in topology backend) fails.
  */
 struct hwloc_error : std::runtime_error {
   using std::runtime_error::runtime_error;
@@ -108,8 +138,395 @@ enum class numa_strategy {
    * @brief Fill up each numa node sequentially (ignoring SMT).
    */
   seq,
+  /**
+   * @brief Bind worker `i` to the `i`-th (modulo) processing unit in `cpu_selection::cpus`.
+   */
+  explicit_cpus,
+  /**
+   * @brief As `fan` but use at most one processing unit per physical core, leaving SMT siblings idle.
+   */
+  physical_cores_only,
+};
+
+/**
+ * @brief Restrict the processing units, by OS index, that a topology is split over.
+ */
+struct cpu_selection {
+  /**
+   * @brief The processing units used by `numa_strategy::explicit_cpus` (e.g. ``isolcpus`` cores), in order.
+   */
+  std::vector<unsigned int> cpus = {};
+  /**
+   * @brief Processing units that are never used (e.g. reserved for I/O threads), honoured by all strategies.
+   *
+   * An empty topology (e.g. without hwloc or sysfs) does not bind workers hence, it cannot honour this.
+   */
+  std::vector<unsigned int> exclude = {};
+};
+
+} // namespace ext
+
+#ifdef LF_USE_SYSFS
+
+/**
+ * @brief The built-in Linux topology backend.
+ */
+namespace impl::sysfs {
+
+/**
+ * @brief Parse a kernel cpu list (e.g. ``"0-3,8,10-11"``) into ascending indices.
+ */
+inline auto parse_list(std::string const &str) -> std::vector<int> {
+
+  std::vector<int> out;
+
+  std::size_t pos = 0;
+
+  while (pos < str.size()) {
+
+    std::size_t end = std::min(str.find(',', pos), str.size());
+    std::string item = str.substr(pos, end - pos);
+    pos = end + 1;
+
+    if (item.empty() || item == "\n") {
+      continue;
+    }
+
+    std::size_t dash = item.find('-');
+
+    int first = std::stoi(item.substr(0, dash));
+    int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+
+    for (int i = first; i <= last; ++i) {
+      out.push_back(i);
+    }
+  }
+
+  std::sort(out.begin(), out.end());
+
+  return out;
+}
+
+/**
+ * @brief Read the first line of a file, empty if it cannot be read.
+ */
+inline auto read_line(std::string const &path) -> std::string {
+
+  std::ifstream file{path};
+  std::string line;
+
+  if (file) {
+    std::getline(file, line);
+  }
+
+  return line;
+}
+
+/**
+ * @brief The smallest cpu in a cpu list file, `fallback` if the file is missing or empty.
+ */
+inline auto first_of(std::string const &path, long fallback) -> long {
+  std::vector list = parse_list(read_line(path));
+  return list.empty() ? fallback : list.front();
+}
+
+/**
+ * @brief Package, numa node, L3, L2, core and PU.
+ */
+inline constexpr std::size_t k_depth = 6;
+
+/**
+ * @brief A logical cpu and the keys of the objects that contain it, outermost first.
+ *
+ * Two cpus share an object at depth `d` if the first `d + 1` keys of their paths are equal.
+ */
+struct cpu {
+  /**
+   * @brief The kernel's index of this cpu.
+   */
+  int id;
+  /**
+   * @brief The numa node this cpu belongs to.
+   */
+  int numa;
+  /**
+   * @brief The keys of the containing objects.
+   */
+  std::array<long, k_depth> path;
+  /**
+   * @brief The rank of this cpu's capacity amongst the distinct capacities of all the cpus, higher is faster.
+   */
+  int efficiency = 0;
 };
 
+/**
+ * @brief A topology read from ``sysfs``, the cpus are sorted such that every object is a contiguous range.
+ */
+struct topology {
+  /**
+   * @brief True if this topology was read from the live machine.
+   */
+  bool this_system;
+  /**
+   * @brief All the cpus we may run on.
+   */
+  std::vector<cpu> cpus;
+
+  /**
+   * @brief Find the cpu with kernel index `id`.
+   */
+  [[nodiscard]] auto find(int id) const -> cpu const & {
+
+    auto it = std::find_if(cpus.begin(), cpus.end(), [id](cpu const &elem) {
+      return elem.id == id;
+    });
+
+    if (it == cpus.end()) {
+      LF_THROW(hwloc_error{"cpu not found in the topology"});
+    }
+
+    return *it;
+  }
+};
+
+/**
+ * @brief Get the key of the data or unified cache at `level` that contains the cpu at `dir`, -1 if none.
+ */
+inline auto cache_key(std::string const &dir, int level) -> long {
+
+  for (int i = 0;; ++i) {
+
+    std::string index = dir + "/cache/index" + std::to_string(i);
+    std::string lvl = read_line(index + "/level");
+
+    if (lvl.empty()) {
+      return -1;
+    }
+
+    if (std::stoi(lvl) == level && read_line(index + "/type") != "Instruction") {
+      return first_of(index + "/shared_cpu_list", -1);
+    }
+  }
+}
+
+/**
+ * @brief Frees a dynamically sized cpu set, stores the size of the set in bytes.
+ */
+struct cpu_set_deleter {
+  std::size_t bytes = 0;
+
+  void operator()(cpu_set_t *set) const noexcept { CPU_FREE(set); }
+};
+
+/**
+ * @brief A dynamically sized cpu set, unlike `cpu_set_t` this is not limited to ``CPU_SETSIZE`` cpus.
+ */
+using unique_cpu_set = std::unique_ptr<cpu_set_t, cpu_set_deleter>;
+
+/**
+ * @brief Allocate an empty cpu set that can hold the cpus `[0, count)`.
+ */
+inline auto alloc_cpu_set(std::size_t count) -> unique_cpu_set {
+
+  cpu_set_t *set = CPU_ALLOC(count);
+
+  if (set == nullptr) {
+    LF_THROW(std::bad_alloc{});
+  }
+
+  std::size_t bytes = CPU_ALLOC_SIZE(count);
+
+  CPU_ZERO_S(bytes, set);
+
+  return unique_cpu_set{set, cpu_set_deleter{bytes}};
+}
+
+/**
+ * @brief Get the calling thread's affinity mask, large enough for any cpu id up to `max_id`.
+ */
+inline auto affinity(int max_id) -> unique_cpu_set {
+
+  // The kernel rejects masks smaller than its own (``nr_cpu_ids``) with EINVAL.
+  for (std::size_t count = static_cast<std::size_t>(max_id) + 1;; count *= 2) {
+
+    unique_cpu_set allowed = alloc_cpu_set(count);
+
+    if (sched_getaffinity(0, allowed.get_deleter().bytes, allowed.get()) == 0) {
+      return allowed;
+    }
+
+    if (errno != EINVAL || count > (std::size_t{1} << 24)) {
+      LF_THROW(hwloc_error{"sched_getaffinity failed"});
+    }
+  }
+}
+
+/**
+ * @brief Get the calling thread's affinity mask (see `affinity`) or, null if it cannot be read.
+ */
+inline auto try_affinity(int max_id) noexcept -> unique_cpu_set {
+  LF_TRY {
+    return affinity(max_id);
+  } LF_CATCH_ALL {
+    return nullptr;
+  }
+}
+
+/**
+ * @brief Read the topology rooted at `root` (usually ``/sys/devices/system``).
+ *
+ * This is not restricted to the loading thread's affinity mask, if `this_system` then `split` restricts
+ * each distribution to the affinity mask of the thread that requests it.
+ */
+inline auto load(std::string const &root, bool this_system) -> std::shared_ptr<topology> {
+
+  std::vector<int> online = parse_list(read_line(root + "/cpu/online"));
+
+  if (online.empty()) {
+    LF_THROW(hwloc_error{"failed to read the online cpus from " + root});
+  }
+
+  // Map cpu -> numa node, if there is no node directory everyone is in node 0.
+
+  std::map<int, int> numa_of;
+
+  for (int node = 0, missing = 0; missing < 64; ++node) {
+
+    std::string list = read_line(root + "/node/node" + std::to_string(node) + "/cpulist");
+
+    if (list.empty()) {
+      ++missing; // Node indices need not be contiguous.
+      continue;
+    }
+
+    for (int id : parse_list(list)) {
+      numa_of[id] = node;
+    }
+  }
+
+  auto topo = std::make_shared<topology>(topology{this_system, {}});
+
+  // Arm exposes a per-cpu capacity while, Intel's hybrid parts list their performance cores in a PMU device.
+  std::vector<int> big = parse_list(read_line(root + "/../cpu_core/cpus"));
+
+  std::set<long> capacities;
+
+  for (int id : online) {
+
+    std::string dir = root + "/cpu/cpu" + std::to_string(id);
+
+    int numa = numa_of.contains(id) ? numa_of[id] : 0;
+
+    long core = first_of(dir + "/topology/core_cpus_list", -1);
+
+    if (core < 0) {
+      core = first_of(dir + "/topology/thread_siblings_list", id);
+    }
+
+    std::string package = read_line(dir + "/topology/physical_package_id");
+
+    topo->cpus.push_back({
+        id,
+        numa,
+        {
+            package.empty() ? -1 : std::stol(package),
+            numa,
+            cache_key(dir, 3),
+            cache_key(dir, 2),
+            core,
+            id,
+        },
+    });
+
+    long capacity = first_of(dir + "/cpu_capacity", std::ranges::find(big, id) == big.end() ? 0 : 1);
+
+    // Temporarily store the raw capacity, ranked below.
+    topo->cpus.back().efficiency = static_cast<int>(capacity);
+    capacities.insert(capacity);
+  }
+
+  for (cpu &elem : topo->cpus) {
+    elem.efficiency = static_cast<int>(std::distance(capacities.begin(), capacities.find(elem.efficiency)));
+  }
+
+  std::sort(topo->cpus.begin(), topo->cpus.end(), [](cpu const &lhs, cpu const &rhs) {
+    return lhs.path < rhs.path;
+  });
+
+  return topo;
+}
+
+/**
+ * @brief Read the topology of this machine, null (an empty topology) if it cannot be read.
+ */
+inline auto load_this_system() noexcept -> std::shared_ptr<topology> {
+  LF_TRY {
+    return load("/sys/devices/system", true);
+  } LF_CATCH_ALL {
+    return nullptr;
+  }
+}
+
+/**
+ * @brief The depth of the deepest object that contains both `a` and `b`, subtracted from `k_depth`.
+ */
+inline auto distance(cpu const &lhs, cpu const &rhs) noexcept -> int {
+
+  std::size_t common = 0;
+
+  while (common < k_depth && lhs.path[common] == rhs.path[common]) {
+    ++common;
+  }
+
+  return static_cast<int>(k_depth - common);
+}
+
+/**
+ * @brief Distribute `n` items over the cpus in `[first, last)` as evenly as possible, like `hwloc_distrib`.
+ *
+ * Each object below depth `depth` receives a number of items proportional to the number of cpus it contains.
+ */
+template <typename Iter>
+void distrib(Iter first, Iter last, std::size_t depth, std::size_t n, std::vector<int> &out) {
+
+  if (n == 0) {
+    return;
+  }
+
+  if (depth == k_depth || std::distance(first, last) == 1) {
+    out.insert(out.end(), n, first->id);
+    return;
+  }
+
+  auto total = static_cast<std::size_t>(std::distance(first, last));
+
+  std::size_t before = 0;
+
+  for (Iter child = first; child != last;) {
+
+    Iter end = std::find_if(child, last, [&](cpu const &elem) {
+      return elem.path[depth] != child->path[depth];
+    });
+
+    auto weight = static_cast<std::size_t>(std::distance(child, end));
+
+    // Round up so that, when there are fewer items than objects, the first objects are used.
+    std::size_t lo = (n * before + total - 1) / total;
+    std::size_t hi = (n * (before + weight) + total - 1) / total;
+
+    distrib(child, end, depth + 1, hi - lo, out);
+
+    before += weight;
+    child = end;
+  }
+}
+
+} // namespace impl::sysfs
+
+#endif
+
+inline namespace ext {
+
 /**
  * @brief A shared description of a computers topology.
  *
@@ -117,6 +534,14 @@ enum class numa_strategy {
  */
 class numa_topology {
 
+#ifdef LF_USE_SYSFS
+
+  using unique_cpup = impl::sysfs::unique_cpu_set;
+
+  using shared_topo = std::shared_ptr<impl::sysfs::topology>;
+
+#else
+
   struct bitmap_deleter {
     LF_STATIC_CALL void operator()(hwloc_bitmap_s *ptr) LF_STATIC_CONST noexcept {
 #ifdef LF_USE_HWLOC
@@ -131,19 +556,64 @@ class numa_topology {
 
   using shared_topo = std::shared_ptr<hwloc_topology>;
 
+#endif
+
  public:
   /**
-   * @brief Construct a topology.
+   * @brief Construct a topology of this machine.
    *
-   * If `hwloc` is not installed this topology is empty.
+   * If `hwloc` is not installed (and the built-in Linux backend is unavailable) this topology is empty.
    */
   numa_topology();
 
+  /**
+   * @brief Get a process-wide topology of this machine, loaded on first use.
+   *
+   * Loading a topology is slow hence, pools use this by default. It is not restricted to the affinity mask of
+   * the thread that loads it, see `split`.
+   */
+  [[nodiscard]] static auto cached() -> numa_topology {
+    static numa_topology const topo;
+    return topo;
+  }
+
+  /**
+   * @brief Load a topology from an XML file, e.g. one exported from another machine by ``lstopo foo.xml``.
+   *
+   * The result need not describe this machine hence, binding to its handles is a noop.
+   */
+  [[nodiscard]] static auto from_xml(std::string const &path) -> numa_topology;
+
+  /**
+   * @brief Build an imaginary topology from an `hwloc` synthetic description, e.g. ``"pack:4 numa:2 pu:8"``.
+   *
+   * Binding to this topology's handles is a noop, this is intended for testing and simulating placement on
+   * machines larger than the one you have. Synthetic descriptions cannot express heterogeneous cores, to
+   * simulate a hybrid machine `kinds[k]` lists the processing units (by OS index) of efficiency class `k`.
+   */
+  [[nodiscard]] static auto from_synthetic(std::string const &description,
+                                           std::vector<std::vector<unsigned int>> const &kinds = {})
+      -> numa_topology;
+
+#ifdef LF_USE_SYSFS
+  /**
+   * @brief Read a topology from a copy of ``/sys/devices/system`` rooted at `root`.
+   *
+   * Only available with the built-in Linux backend, binding to this topology's handles is a noop.
+   */
+  [[nodiscard]] static auto from_sysfs(std::string const &root) -> numa_topology;
+#endif
+
   /**
    * @brief Test if this topology is empty.
    */
   explicit operator bool() const noexcept { return m_topology != nullptr; }
 
+  /**
+   * @brief Test if this topology describes the machine we are running on (false if it is empty).
+   */
+  [[nodiscard]] auto is_this_system() const noexcept -> bool;
+
   /**
    * A handle to a single processing unit in a NUMA computer.
    */
@@ -152,7 +622,8 @@ class numa_topology {
     /**
      * @brief Bind the calling thread to the set of processing units in this `cpuset`.
      *
-     * If `hwloc` is not installed both handles are null and this is a noop.
+     * If `hwloc` is not installed both handles are null and this is a noop. This is also a noop if the
+     * handle's topology is not this system (see `from_xml` and `from_synthetic`).
      */
     void bind() const;
 
@@ -168,6 +639,12 @@ class numa_topology {
      * @brief  The index of the numa node this handle belongs to, on [0, n).
      */
     std::size_t numa = 0;
+    /**
+     * @brief The efficiency class (kind of core) of this handle's processing unit, higher is faster.
+     *
+     * This is zero on homogeneous machines or if the kinds of core are unknown.
+     */
+    int efficiency = 0;
   };
 
   /**
@@ -178,9 +655,17 @@ class numa_topology {
    * to use the minimum number of numa nodes then divided each node such that each PU has as much cache as
    * possible. If `strategy == numa_strategy::fan` we try and maximize the amount of cache each PI gets.
    *
-   * If this topology is empty then this function returns a vector of `n` empty handles.
+   * If `strategy == numa_strategy::physical_cores_only` this is `fan` over one PU per core and, if
+   * `strategy == numa_strategy::explicit_cpus` the handles are `select.cpus` in order. Processing units in
+   * `select.exclude` are never used. With the built-in Linux backend, processing units outside the calling
+   * thread's affinity mask are not used either, this mask is read by each call.
+   *
+   * If this topology is empty then this function returns a vector of `n` empty handles, these do not bind
+   * hence, `select.exclude` is ignored.
    */
-  auto split(std::size_t n, numa_strategy strategy = numa_strategy::fan) const -> std::vector<numa_handle>;
+  auto split(std::size_t n,
+             numa_strategy strategy = numa_strategy::fan,
+             cpu_selection const &select = {}) const -> std::vector<numa_handle>;
 
   /**
    * @brief A single-threads hierarchical view of a set of objects.
@@ -197,19 +682,33 @@ class numa_topology {
      * @brief A list of neighbors-lists.
      */
     std::vector<std::vector<std::shared_ptr<T>>> neighbors;
+    /**
+     * @brief The number of efficiency classes between this node and the fastest node in the distribution.
+     */
+    int handicap = 0;
   };
 
   /**
    * @brief Distribute a vector of objects over this topology.
    *
    * This function returns a vector of `numa_node`s. Each `numa_node` contains a
-   * hierarchical view of the elements in `data`.
+   * hierarchical view of the elements in `data`. The `strategy` and `select` are forwarded to `split`.
    */
   template <typename T>
   auto distribute(std::vector<std::shared_ptr<T>> const &data,
-                  numa_strategy strategy = numa_strategy::fan) -> std::vector<numa_node<T>>;
+                  numa_strategy strategy = numa_strategy::fan,
+                  cpu_selection const &select = {}) const -> std::vector<numa_node<T>>;
 
  private:
+  explicit numa_topology(shared_topo topology) noexcept : m_topology(std::move(topology)) {}
+
+#ifdef LF_USE_HWLOC
+  /**
+   * @brief Initialize a topology, call `configure(topo)` (if non-null) and then load it.
+   */
+  static auto load(int (*configure)(hwloc_topology *, char const *), char const *arg) -> shared_topo;
+#endif
+
   shared_topo m_topology = nullptr;
 };
 
@@ -217,7 +716,8 @@ class numa_topology {
 
 #ifdef LF_USE_HWLOC
 
-inline numa_topology::numa_topology() {
+inline auto numa_topology::load(int (*configure)(hwloc_topology *, char const *), char const *arg)
+    -> shared_topo {
 
   struct topology_deleter {
     LF_STATIC_CALL void operator()(hwloc_topology *ptr) LF_STATIC_CONST noexcept {
@@ -233,11 +733,53 @@ inline numa_topology::numa_topology() {
     LF_THROW(hwloc_error{"failed to initialize a topology"});
   }
 
-  m_topology = {tmp, topology_deleter{}};
+  shared_topo topo = {tmp, topology_deleter{}};
+
+  if (configure != nullptr && configure(topo.get(), arg) != 0) {
+    LF_THROW(hwloc_error{"failed to configure a topology, bad XML/synthetic description?"});
+  }
 
-  if (hwloc_topology_load(m_topology.get()) != 0) {
+  if (hwloc_topology_load(topo.get()) != 0) {
     LF_THROW(hwloc_error{"failed to load a topology"});
   }
+
+  return topo;
+}
+
+inline numa_topology::numa_topology() : m_topology(load(nullptr, nullptr)) {}
+
+inline auto numa_topology::from_xml(std::string const &path) -> numa_topology {
+  return numa_topology{load(hwloc_topology_set_xml, path.c_str())};
+}
+
+inline auto numa_topology::from_synthetic(std::string const &description,
+                                          std::vector<std::vector<unsigned int>> const &kinds)
+    -> numa_topology {
+
+  shared_topo topo = load(hwloc_topology_set_synthetic, description.c_str());
+
+  for (std::size_t k = 0; k < kinds.size(); k++) {
+
+    unique_cpup cpus{hwloc_bitmap_alloc()};
+
+    if (!cpus) {
+      LF_THROW(hwloc_error{"failed to allocate a bitmap"});
+    }
+
+    for (unsigned int cpu : kinds[k]) {
+      hwloc_bitmap_set(cpus.get(), cpu);
+    }
+
+    if (hwloc_cpukinds_register(topo.get(), cpus.get(), static_cast<int>(k), 0, nullptr, 0) != 0) {
+      LF_THROW(hwloc_error{"failed to register a kind of cpu"});
+    }
+  }
+
+  return numa_topology{std::move(topo)};
+}
+
+inline auto numa_topology::is_this_system() const noexcept -> bool {
+  return m_topology && hwloc_topology_is_thissystem(m_topology.get()) != 0;
 }
 
 inline void numa_topology::numa_handle::bind() const {
@@ -245,6 +787,10 @@ inline void numa_topology::numa_handle::bind() const {
   LF_ASSERT(topo);
   LF_ASSERT(cpup);
 
+  if (hwloc_topology_is_thissystem(topo.get()) == 0) {
+    return;
+  }
+
   switch (hwloc_set_cpubind(topo.get(), cpup.get(), HWLOC_CPUBIND_THREAD)) {
     case 0:
       return;
@@ -262,23 +808,92 @@ inline void numa_topology::numa_handle::bind() const {
   }
 }
 
-inline auto count_cores(hwloc_obj_t obj) -> unsigned int {
+/**
+ * @brief Count the cores below `obj` with at least one processing unit in `eligible`.
+ */
+inline auto count_cores(hwloc_obj_t obj, hwloc_const_bitmap_t eligible) -> unsigned int {
 
   LF_ASSERT(obj);
 
   if (obj->type == HWLOC_OBJ_CORE) {
-    return 1;
+    return hwloc_bitmap_intersects(obj->cpuset, eligible) != 0 ? 1 : 0;
   }
 
   unsigned int num_cores = 0;
 
   for (unsigned int i = 0; i < obj->arity; i++) {
-    num_cores += count_cores(obj->children[i]);
+    num_cores += count_cores(obj->children[i], eligible);
   }
 
   return num_cores;
 }
 
+} // namespace ext
+
+namespace impl::detail {
+
+/**
+ * @brief Count the processing units below `obj` that are in `eligible`.
+ */
+inline auto count_eligible(hwloc_obj_t obj, hwloc_const_bitmap_t eligible) -> std::size_t {
+
+  hwloc_bitmap_t tmp = hwloc_bitmap_alloc();
+
+  if (tmp == nullptr) {
+    LF_THROW(hwloc_error{"failed to allocate a bitmap"});
+  }
+
+  hwloc_bitmap_and(tmp, obj->cpuset, eligible);
+  int weight = hwloc_bitmap_weight(tmp);
+  hwloc_bitmap_free(tmp);
+
+  return weight < 0 ? 0 : static_cast<std::size_t>(weight);
+}
+
+/**
+ * @brief Append `n` objects to `out` spread over `roots` in proportion to their eligible processing units.
+ *
+ * This mirrors `hwloc_distrib` but counts only the processing units in `eligible`.
+ */
+inline void distrib(hwloc_obj_t const *roots,
+                    unsigned int n_roots,
+                    hwloc_const_bitmap_t eligible,
+                    std::size_t n,
+                    std::vector<hwloc_obj_t> &out) {
+
+  std::size_t total = 0;
+
+  for (unsigned int i = 0; i < n_roots; i++) {
+    total += count_eligible(roots[i], eligible);
+  }
+
+  std::size_t given = 0;
+
+  for (unsigned int i = 0; i < n_roots; i++) {
+
+    std::size_t weight = count_eligible(roots[i], eligible);
+
+    if (weight == 0) {
+      continue;
+    }
+
+    // Proportional to weight, if previous chunks were rounded up we may get a bit less.
+    std::size_t chunk = ((given + weight) * n + total - 1) / total - (given * n + total - 1) / total;
+
+    if (roots[i]->arity == 0 || chunk <= 1) {
+      out.insert(out.end(), chunk, roots[i]);
+    } else {
+      distrib(roots[i]->children, roots[i]->arity, eligible, chunk, out);
+    }
+
+    given += weight;
+  }
+}
+
+} // namespace impl::detail
+
+inline namespace ext {
+
 inline auto get_numa_index(hwloc_topology *topo, hwloc_bitmap_s *bitmap) -> hwloc_uint64_t {
 
   LF_ASSERT(topo);
@@ -301,58 +916,119 @@ inline auto get_numa_index(hwloc_topology *topo, hwloc_bitmap_s *bitmap) -> hwlo
   return obj->gp_index;
 }
 
-inline auto numa_topology::split(std::size_t n, numa_strategy strategy) const -> std::vector<numa_handle> {
+inline auto numa_topology::split(std::size_t n, numa_strategy strategy, cpu_selection const &select) const
+    -> std::vector<numa_handle> {
 
   if (n < 1) {
     LF_THROW(hwloc_error{"hwloc cannot distribute over less than one singlet"});
   }
 
-  // We are going to build up a list of numa packages until we have enough cores.
+  hwloc_topology *topo = m_topology.get();
 
-  std::vector<hwloc_obj_t> roots;
+  auto alloc = [](hwloc_bitmap_s *bitmap) -> unique_cpup {
+    if (bitmap == nullptr) {
+      LF_THROW(hwloc_error{"failed to allocate a bitmap"});
+    }
+    return unique_cpup{bitmap};
+  };
+
+  // The processing units we are allowed to use.
+
+  unique_cpup eligible = alloc(hwloc_bitmap_dup(hwloc_get_root_obj(topo)->cpuset));
 
-  if (strategy == numa_strategy::seq) {
+  for (unsigned int cpu : select.exclude) {
+    hwloc_bitmap_clr(eligible.get(), cpu);
+  }
 
-    hwloc_obj_t numa = nullptr;
+  if (strategy == numa_strategy::physical_cores_only) {
 
-    for (unsigned int count = 0; count < n; count += count_cores(numa)) {
+    unique_cpup firsts = alloc(hwloc_bitmap_alloc());
+    unique_cpup tmp = alloc(hwloc_bitmap_alloc());
 
-      hwloc_obj_t next_numa = hwloc_get_next_obj_by_type(m_topology.get(), HWLOC_OBJ_PACKAGE, numa);
+    hwloc_obj_t core = nullptr;
 
-      if (next_numa == nullptr) {
-        break;
+    while ((core = hwloc_get_next_obj_by_type(topo, HWLOC_OBJ_CORE, core)) != nullptr) {
+      if (hwloc_bitmap_and(tmp.get(), core->cpuset, eligible.get()) == 0 && !hwloc_bitmap_iszero(tmp.get())) {
+        hwloc_bitmap_set(firsts.get(), static_cast<unsigned int>(hwloc_bitmap_first(tmp.get())));
       }
+    }
 
-      roots.push_back(next_numa);
-      numa = next_numa;
+    // A topology without cores (e.g. some synthetic ones) has no SMT siblings to avoid.
+    if (hwloc_get_nbobjs_by_type(topo, HWLOC_OBJ_CORE) > 0) {
+      eligible = std::move(firsts);
     }
-  } else {
-    roots.push_back(hwloc_get_root_obj(m_topology.get()));
   }
 
-  // Now we distribute over the cores in each numa package, NOTE:  hwloc_distrib
-  // gives us owning pointers (not in the docs, but it does!).
+  std::vector<unique_cpup> singlets;
+
+  if (strategy == numa_strategy::explicit_cpus) {
 
-  std::vector<hwloc_bitmap_s *> sets(n, nullptr);
+    if (select.cpus.empty()) {
+      LF_THROW(hwloc_error{"numa_strategy::explicit_cpus requires a non-empty list of cpus"});
+    }
 
-  auto r_size = static_cast<unsigned int>(roots.size());
-  auto s_size = static_cast<unsigned int>(sets.size());
+    for (std::size_t i = 0; i < n; i++) {
 
-  if (hwloc_distrib(m_topology.get(), roots.data(), r_size, sets.data(), s_size, INT_MAX, 0) != 0) {
-    LF_THROW(hwloc_error{"unknown hwloc error when distributing over a topology"});
-  }
+      unsigned int cpu = select.cpus[i % select.cpus.size()];
+
+      if (hwloc_bitmap_isset(eligible.get(), cpu) == 0) {
+        LF_THROW(hwloc_error{"explicit cpu " + std::to_string(cpu) + " is excluded or not in the topology"});
+      }
+
+      singlets.push_back(alloc(hwloc_bitmap_alloc()));
+      hwloc_bitmap_only(singlets.back().get(), cpu);
+    }
+  } else {
+
+    if (hwloc_bitmap_iszero(eligible.get())) {
+      LF_THROW(hwloc_error{"no eligible processing units to distribute over"});
+    }
+
+    // We are going to build up a list of numa packages until we have enough cores.
+
+    std::vector<hwloc_obj_t> roots;
+
+    if (strategy == numa_strategy::seq) {
+
+      hwloc_obj_t numa = nullptr;
+
+      for (unsigned int count = 0; count < n; count += count_cores(numa, eligible.get())) {
+
+        hwloc_obj_t next_numa = hwloc_get_next_obj_by_type(topo, HWLOC_OBJ_PACKAGE, numa);
+
+        if (next_numa == nullptr) {
+          break;
+        }
+
+        roots.push_back(next_numa);
+        numa = next_numa;
+      }
+    }
+
+    if (roots.empty()) {
+      roots.push_back(hwloc_get_root_obj(topo));
+    }
+
+    // Now we distribute over the eligible PUs in each root.
+
+    std::vector<hwloc_obj_t> objs;
 
-  // Need ownership before map for exception safety.
-  std::vector<unique_cpup> singlets{sets.begin(), sets.end()};
+    impl::detail::distrib(roots.data(), static_cast<unsigned int>(roots.size()), eligible.get(), n, objs);
+
+    if (objs.size() != n) {
+      LF_THROW(hwloc_error{"unknown error when distributing over a topology"});
+    }
+
+    for (hwloc_obj_t obj : objs) {
+      singlets.push_back(alloc(hwloc_bitmap_alloc()));
+      hwloc_bitmap_and(singlets.back().get(), obj->cpuset, eligible.get());
+    }
+  }
 
   std::map<hwloc_uint64_t, std::size_t> numa_map;
 
   return impl::map(std::move(singlets), [&](unique_cpup &&singlet) -> numa_handle {
     //
-    if (!singlet) {
-      LF_THROW(hwloc_error{"hwloc_distrib returned a nullptr"});
-    }
-
     if (hwloc_bitmap_singlify(singlet.get()) != 0) {
       LF_THROW(hwloc_error{"unknown hwloc error when singlify a bitmap"});
     }
@@ -363,10 +1039,19 @@ inline auto numa_topology::split(std::size_t n, numa_strategy strategy) const ->
       numa_map[numa_index] = numa_map.size();
     }
 
+    int efficiency = 0;
+
+    // Kinds are ranked from 0 (the most energy efficient) upwards, or -1 if the ranking is unknown.
+    if (int kind = hwloc_cpukinds_get_by_cpuset(topo, singlet.get(), 0); kind >= 0) {
+      auto index = static_cast<unsigned int>(kind);
+      hwloc_cpukinds_get_info(topo, index, nullptr, &efficiency, nullptr, nullptr, 0);
+    }
+
     return {
         m_topology,
         std::move(singlet),
         numa_map[numa_index],
+        std::max(efficiency, 0),
     };
   });
 }
@@ -400,10 +1085,10 @@ class distance_matrix {
       }
     }
 
-    // Build the matrix.
+    // Build the matrix, it is symmetric with a zero diagonal.
 
     for (std::size_t i = 0; i < obj.size(); i++) {
-      for (std::size_t j = 0; j < obj.size(); j++) {
+      for (std::size_t j = i + 1; j < obj.size(); j++) {
 
         auto *topo_1 = handles[i].topo.get();
         auto *topo_2 = handles[j].topo.get();
@@ -425,6 +1110,7 @@ class distance_matrix {
         LF_ASSERT(dist_2 >= 0);
 
         m_matrix[i * m_size + j] = std::max(dist_1, dist_2);
+        m_matrix[j * m_size + i] = m_matrix[i * m_size + j];
       }
     }
   }
@@ -442,11 +1128,236 @@ class distance_matrix {
 
 inline namespace ext {
 
+#elif defined(LF_USE_SYSFS)
+
+inline numa_topology::numa_topology() : m_topology(impl::sysfs::load_this_system()) {}
+
+inline auto numa_topology::from_sysfs(std::string const &root) -> numa_topology {
+  return numa_topology{impl::sysfs::load(root, false)};
+}
+
+inline auto numa_topology::from_xml(std::string const & /* path */) -> numa_topology {
+  LF_THROW(hwloc_error{"loading a topology from XML requires hwloc"});
+}
+
+inline auto numa_topology::from_synthetic(std::string const & /* description */,
+                                          std::vector<std::vector<unsigned int>> const & /* kinds */)
+    -> numa_topology {
+  LF_THROW(hwloc_error{"building a synthetic topology requires hwloc"});
+}
+
+inline auto numa_topology::is_this_system() const noexcept -> bool {
+  return m_topology && m_topology->this_system;
+}
+
+inline void numa_topology::numa_handle::bind() const {
+
+  if (!topo || !topo->this_system) {
+    return;
+  }
+
+  LF_ASSERT(cpup);
+
+  // Failing to bind (e.g. the cpu has been taken from our cgroup) only costs locality, keep our affinity.
+  if (sched_setaffinity(0, cpup.get_deleter().bytes, cpup.get()) != 0) {
+    LF_LOG("sched_setaffinity failed to bind a thread");
+  }
+}
+
+inline auto numa_topology::split(std::size_t n, numa_strategy strategy, cpu_selection const &select) const
+    -> std::vector<numa_handle> {
+
+  if (n < 1) {
+    LF_THROW(hwloc_error{"cannot distribute over less than one singlet"});
+  }
+
+  if (!m_topology) {
+    // This machine's topology could not be read.
+    if (strategy == numa_strategy::explicit_cpus) {
+      LF_THROW(hwloc_error{"numa_strategy::explicit_cpus requires a topology"});
+    }
+    return std::vector<numa_handle>(n);
+  }
+
+  // The calling thread's mask is read here, not when loading, such that a topology shared between threads
+  // (e.g. `cached()`) is not restricted to the mask of the thread that happened to load it.
+
+  impl::sysfs::unique_cpu_set allowed = nullptr;
+
+  if (m_topology->this_system && !m_topology->cpus.empty()) {
+    auto max = std::ranges::max_element(m_topology->cpus, {}, &impl::sysfs::cpu::id);
+    allowed = impl::sysfs::try_affinity(max->id);
+  }
+
+  // The cpus we are allowed to use, still sorted by their path.
+
+  std::vector<impl::sysfs::cpu> cpus;
+
+  for (impl::sysfs::cpu const &cpu : m_topology->cpus) {
+
+    auto const &exclude = select.exclude;
+
+    if (std::find(exclude.begin(), exclude.end(), static_cast<unsigned int>(cpu.id)) != exclude.end()) {
+      continue;
+    }
+
+    auto id = static_cast<std::size_t>(cpu.id);
+
+    if (allowed && !CPU_ISSET_S(id, allowed.get_deleter().bytes, allowed.get())) {
+      continue;
+    }
+
+    constexpr std::size_t core = impl::sysfs::k_depth - 2;
+
+    if (strategy == numa_strategy::physical_cores_only && !cpus.empty() &&
+        cpus.back().path[core] == cpu.path[core]) {
+      continue; // An SMT sibling of the previous cpu.
+    }
+
+    cpus.push_back(cpu);
+  }
+
+  std::vector<int> ids;
+
+  if (strategy == numa_strategy::explicit_cpus) {
+
+    if (select.cpus.empty()) {
+      LF_THROW(hwloc_error{"numa_strategy::explicit_cpus requires a non-empty list of cpus"});
+    }
+
+    for (std::size_t i = 0; i < n; i++) {
+
+      int id = static_cast<int>(select.cpus[i % select.cpus.size()]);
+
+      auto match = [id](impl::sysfs::cpu const &cpu) {
+        return cpu.id == id;
+      };
+
+      if (std::find_if(cpus.begin(), cpus.end(), match) == cpus.end()) {
+        LF_THROW(hwloc_error{"explicit cpu " + std::to_string(id) + " is excluded or not in the topology"});
+      }
+
+      ids.push_back(id);
+    }
+  } else {
+
+    if (cpus.empty()) {
+      LF_THROW(hwloc_error{"no eligible cpus to distribute over"});
+    }
+
+    auto last = cpus.end();
+
+    if (strategy == numa_strategy::seq) {
+
+      // Take whole packages until we have enough cores.
+
+      std::set<long> cores;
+
+      for (last = cpus.begin(); last != cpus.end() && cores.size() < n;) {
+
+        long package = last->path[0];
+
+        for (; last != cpus.end() && last->path[0] == package; ++last) {
+          cores.insert(last->path[impl::sysfs::k_depth - 2]);
+        }
+      }
+    }
+
+    impl::sysfs::distrib(cpus.begin(), last, 0, n, ids);
+  }
+
+  LF_ASSERT(ids.size() == n);
+
+  std::map<int, std::size_t> numa_map;
+
+  return impl::map(std::move(ids), [&](int id) -> numa_handle {
+    //
+    auto singlet = impl::sysfs::alloc_cpu_set(static_cast<std::size_t>(id) + 1);
+
+    CPU_SET_S(static_cast<std::size_t>(id), singlet.get_deleter().bytes, singlet.get());
+
+    impl::sysfs::cpu const &cpu = m_topology->find(id);
+
+    if (!numa_map.contains(cpu.numa)) {
+      numa_map[cpu.numa] = numa_map.size();
+    }
+
+    return {
+        m_topology,
+        std::move(singlet),
+        numa_map[cpu.numa],
+        cpu.efficiency,
+    };
+  });
+}
+
+} // namespace ext
+
+namespace impl::detail {
+
+class distance_matrix {
+
+  using numa_handle = numa_topology::numa_handle;
+
+ public:
+  /**
+   * @brief Compute the topological distance between all pairs of objects in
+   * `obj`.
+   */
+  explicit distance_matrix(std::vector<numa_handle> const &handles)
+      : m_size{handles.size()},
+        m_matrix(m_size * m_size) {
+
+    std::vector cpus = impl::map(handles, [](numa_handle const &handle) -> sysfs::cpu const * {
+      if (!handle.topo) {
+        return nullptr; // An empty topology, everyone is equidistant.
+      }
+
+      std::size_t bytes = handle.cpup.get_deleter().bytes;
+
+      for (std::size_t id = 0; id < 8 * bytes; ++id) {
+        if (CPU_ISSET_S(id, bytes, handle.cpup.get())) {
+          return &handle.topo->find(static_cast<int>(id));
+        }
+      }
+      LF_THROW(hwloc_error{"empty cpu set in a handle"});
+    });
+
+    for (std::size_t i = 0; i < m_size; i++) {
+      for (std::size_t j = 0; j < m_size; j++) {
+
+        if (handles[i].topo != handles[j].topo) {
+          LF_THROW(hwloc_error{"numa_handles are in different topologies"});
+        }
+
+        m_matrix[i * m_size + j] = cpus[i] != nullptr ? sysfs::distance(*cpus[i], *cpus[j]) : 0;
+      }
+    }
+  }
+
+  auto operator()(std::size_t i, std::size_t j) const noexcept -> int { return m_matrix[i * m_size + j]; }
+
+  auto size() const noexcept -> std::size_t { return m_size; }
+
+ private:
+  std::size_t m_size;
+  std::vector<int> m_matrix;
+};
+
+} // namespace impl::detail
+
+inline namespace ext {
+
+#endif
+
+#if defined(LF_USE_HWLOC) || defined(LF_USE_SYSFS)
+
 template <typename T>
 inline auto numa_topology::distribute(std::vector<std::shared_ptr<T>> const &data,
-                                      numa_strategy strategy) -> std::vector<numa_node<T>> {
+                                      numa_strategy strategy,
+                                      cpu_selection const &select) const -> std::vector<numa_node<T>> {
 
-  std::vector handles = split(data.size(), strategy);
+  std::vector handles = split(data.size(), strategy, select);
 
   // Compute the topological distance between all pairs of objects.
 
@@ -481,6 +1392,16 @@ inline auto numa_topology::distribute(std::vector<std::shared_ptr<T>> const &dat
     }
   }
 
+  // Compute the handicaps.
+
+  auto fastest = std::ranges::max_element(nodes, {}, [](numa_node<T> const &node) {
+    return node.efficiency;
+  });
+
+  for (numa_node<T> &node : nodes) {
+    node.handicap = fastest->efficiency - node.efficiency;
+  }
+
   return nodes;
 }
 
@@ -491,21 +1412,41 @@ inline numa_topology::numa_topology()
                    LF_ASSERT(!ptr);
                  }} {}
 
+inline auto numa_topology::from_xml(std::string const & /* path */) -> numa_topology {
+  LF_THROW(hwloc_error{"loading a topology from XML requires hwloc"});
+}
+
+inline auto numa_topology::from_synthetic(std::string const & /* description */,
+                                          std::vector<std::vector<unsigned int>> const & /* kinds */)
+    -> numa_topology {
+  LF_THROW(hwloc_error{"building a synthetic topology requires hwloc"});
+}
+
+inline auto numa_topology::is_this_system() const noexcept -> bool { return false; }
+
 inline void numa_topology::numa_handle::bind() const {
   LF_ASSERT(!topo);
   LF_ASSERT(!cpup);
 }
 
-inline auto
-numa_topology::split(std::size_t n, numa_strategy /* strategy */) const -> std::vector<numa_handle> {
+inline auto numa_topology::split(std::size_t n,
+                                 numa_strategy strategy,
+                                 cpu_selection const & /* select */) const -> std::vector<numa_handle> {
+
+  // Nothing is bound hence, `exclude` cannot be honoured (as documented).
+  if (strategy == numa_strategy::explicit_cpus) {
+    LF_THROW(hwloc_error{"numa_strategy::explicit_cpus requires hwloc or sysfs"});
+  }
+
   return std::vector<numa_handle>(n);
 }
 
 template <typename T>
 inline auto numa_topology::distribute(std::vector<std::shared_ptr<T>> const &data,
-                                      numa_strategy strategy) -> std::vector<numa_node<T>> {
+                                      numa_strategy strategy,
+                                      cpu_selection const &select) const -> std::vector<numa_node<T>> {
 
-  std::vector<numa_handle> handles = split(data.size(), strategy);
+  std::vector<numa_handle> handles = split(data.size(), strategy, select);
 
   std::vector<numa_node<T>> views;
 
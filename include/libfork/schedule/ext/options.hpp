@@ -0,0 +1,87 @@
+#ifndef B5F0C3E2_9D14_4A7B_8E61_3C2A7F9D0B48
+#define B5F0C3E2_9D14_4A7B_8E61_3C2A7F9D0B48
+
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "libfork/schedule/ext/arbiter.hpp" // for thread_arbiter
+#include "libfork/schedule/ext/numa.hpp"    // for numa_topology, cpu_selection
+#include "libfork/schedule/ext/reactor.hpp" // for reactor
+
+/**
+ * @file options.hpp
+ *
+ * @brief Less common settings for constructing the pools.
+ */
+
+namespace lf {
+
+inline namespace ext {
+
+/**
+ * @brief Settings for constructing a `lf::busy_pool` or `lf::lazy_pool`.
+ *
+ * These have designated-initializer friendly defaults, e.g.
+ * ``lf::lazy_pool{n, strategy, {.warm_up = true}}``.
+ */
+struct pool_options {
+  /**
+   * @brief The topology to distribute workers over.
+   *
+   * By default this is the process-wide `numa_topology::cached()` such that pools do not reload the
+   * topology. Pass an injected topology (e.g. `numa_topology::from_synthetic`) to simulate placement.
+   */
+  numa_topology topology = numa_topology::cached();
+  /**
+   * @brief Processing units to pin to or to avoid, see `numa_topology::split`.
+   *
+   * The ``cpus`` are only used with `numa_strategy::explicit_cpus`, ``exclude`` is honoured by all
+   * strategies if the topology is not empty (otherwise workers are not bound at all).
+   */
+  cpu_selection placement = {};
+  /**
+   * @brief If true then each worker pre-faults its stack and deque (on its own, bound, thread) before the
+   * pool's constructor returns, this moves page faults out of the first tasks.
+   */
+  bool warm_up = false;
+  /**
+   * @brief If true then tasks submitted to the pool (the roots of task trees) are only scheduled onto
+   * workers bound to the fastest kind of core.
+   *
+   * This only matters on heterogeneous (e.g. performance/efficiency core) machines.
+   */
+  bool prefer_fast_cores = true;
+  /**
+   * @brief If true then each worker keeps its tasks in a private deque and idle workers request work
+   * instead of stealing it.
+   *
+   * Forks and joins then need no atomic read-modify-write operations or fences but, a thief must wait for
+   * its victim to reach a fork or join before it receives a task.
+   */
+  bool private_deques = false;
+  /**
+   * @brief If non-null, limit the pool's running workers with this arbiter (which must outlive the pool),
+   * for example ``&lf::thread_arbiter::global()``.
+   *
+   * Only a `lf::lazy_pool` can share an arbiter, the workers of a `lf::busy_pool` never yield their core.
+   */
+  thread_arbiter *arbiter = nullptr;
+  /**
+   * @brief If non-null, searching workers poll this reactor (which must outlive the pool) and the last idle
+   * worker parks in it instead of sleeping, see `lf::ext::reactor`.
+   *
+   * Only a `lf::lazy_pool` can drive a reactor, the workers of a `lf::busy_pool` never go idle.
+   */
+  reactor *events = nullptr;
+};
+
+} // namespace ext
+
+} // namespace lf
+
+#endif /* B5F0C3E2_9D14_4A7B_8E61_3C2A7F9D0B48 */
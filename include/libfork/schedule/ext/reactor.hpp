@@ -0,0 +1,73 @@
+#ifndef E3B81D5A_7C42_4F0E_9A6B_2D94C1F7A835
+#define E3B81D5A_7C42_4F0E_9A6B_2D94C1F7A835
+
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <chrono>  // for nanoseconds
+#include <cstddef> // for size_t
+
+/**
+ * @file reactor.hpp
+ *
+ * @brief An interface to an external event source that idle workers can poll.
+ */
+
+namespace lf {
+
+inline namespace ext {
+
+/**
+ * @brief An event loop (epoll, io_uring, a network stack, ...) that a pool's idle workers drive.
+ *
+ * A pool constructed with a reactor lets the last of its workers to go idle park in `poll()` instead of on
+ * its `lf::ext::event_count`, while the pool is busy its searching workers call `poll()` with a zero
+ * timeout. Hence, I/O readiness and compute can share the pool's cores without a dedicated I/O thread.
+ * Handlers run by `poll()` typically resume tasks or submit new work to the pool.
+ *
+ * When the pool has new work it calls `wake()` to return the parked worker to the pool, `wake()` must
+ * be sticky: if it is called before (or while) a thread enters `poll()` then that call must return
+ * promptly. Writing to an ``eventfd`` that is part of the polled set is the usual implementation.
+ *
+ * \rst
+ *
+ * .. warning::
+ *    A reactor must outlive the pools that use it.
+ *
+ * \endrst
+ */
+class reactor {
+ public:
+  /**
+   * @brief Handle ready events, blocking for at most `timeout` (forever if negative) until one is ready.
+   *
+   * This is only ever called by one worker of a pool at a time, errors must be handled internally.
+   *
+   * @return The number of events handled.
+   */
+  virtual auto poll(std::chrono::nanoseconds timeout) noexcept -> std::size_t = 0;
+
+  /**
+   * @brief Make a current or subsequent call to `poll()` return promptly, must be thread-safe.
+   */
+  virtual void wake() noexcept = 0;
+
+ protected:
+  reactor() = default;
+  reactor(reactor const &) = default;
+  reactor(reactor &&) noexcept = default;
+  auto operator=(reactor const &) -> reactor & = default;
+  auto operator=(reactor &&) noexcept -> reactor & = default;
+  ~reactor() = default;
+};
+
+} // namespace ext
+
+} // namespace lf
+
+#endif /* E3B81D5A_7C42_4F0E_9A6B_2D94C1F7A835 */
@@ -0,0 +1,218 @@
+#ifndef A8D2F5B1_3C6E_4F07_9E14_6B0C7D9E2A53
+#define A8D2F5B1_3C6E_4F07_9E14_6B0C7D9E2A53
+
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <chrono>             // for steady_clock, nanoseconds, duration_cast
+#include <condition_variable> // for condition_variable_any
+#include <coroutine>          // for coroutine_handle
+#include <cstddef>            // for size_t
+#include <cstdint>            // for uint64_t
+#include <functional>         // for function
+#include <mutex>              // for mutex, unique_lock
+#include <span>               // for span
+#include <stdexcept>          // for invalid_argument
+#include <stop_token>         // for stop_token
+#include <thread>             // for jthread
+#include <utility>            // for move
+#include <vector>             // for vector
+
+#include "libfork/core/ext/context.hpp"  // for worker_context
+#include "libfork/core/impl/utility.hpp" // for immovable
+#include "libfork/core/macro.hpp"        // for LF_THROW, LF_LOG
+
+/**
+ * @file stall_detector.hpp
+ *
+ * @brief A watchdog that reports workers stuck in a single strand of a task.
+ *
+ * This is only available if ``LF_STALL_DETECTOR`` is defined, otherwise workers do not advance their strand
+ * counters at fork/join boundaries.
+ */
+
+#ifdef LF_STALL_DETECTOR
+
+namespace lf {
+
+inline namespace ext {
+
+/**
+ * @brief Describes a worker that has been executing a single strand for longer than a threshold.
+ */
+struct stall_report {
+  /**
+   * @brief The index of the worker in the span passed to the `lf::ext::stall_detector`.
+   */
+  std::size_t worker;
+  /**
+   * @brief The stalled worker's context.
+   */
+  worker_context *context;
+  /**
+   * @brief The value of the worker's strand counter, see `lf::ext::worker_context::strand`.
+   */
+  std::uint64_t strand;
+  /**
+   * @brief A lower bound on the time the worker has spent in the current strand.
+   */
+  std::chrono::nanoseconds duration;
+  /**
+   * @brief The handle of the task the worker is executing, null unless ``LF_ASYNC_STACK`` is defined.
+   *
+   * The ``address()`` of this handle identifies the task, it must not be dereferenced, resumed or destroyed
+   * as the task may have completed by the time the report is delivered.
+   */
+  std::coroutine_handle<> task;
+};
+
+/**
+ * @brief A watchdog thread that periodically samples each worker's strand counter.
+ *
+ * If a worker stays in the same strand (see `lf::ext::worker_context::strand`) for longer than `threshold`
+ * then `callback` is invoked once for that strand, on the watchdog thread. Tasks that block or spin without
+ * forking/joining remove a worker from the pool, this helps find them.
+ *
+ * The resolution of the reported duration is the polling period.
+ *
+ * \rst
+ *
+ * .. warning::
+ *    The detector must be destroyed before the workers it is observing.
+ *
+ * \endrst
+ */
+class stall_detector : impl::immovable<stall_detector> {
+ public:
+  /**
+   * @brief The type of the user supplied reporting function.
+   */
+  using callback_t = std::function<void(stall_report const &)>;
+
+  /**
+   * @brief Construct a stall detector observing `workers`.
+   *
+   * @param workers The contexts to observe, for example ``pool.contexts()``.
+   * @param threshold The time after which a strand is considered stalled, must be positive.
+   * @param callback Invoked on the watchdog thread for each stall.
+   */
+  stall_detector(std::span<worker_context *const> workers,
+                 std::chrono::nanoseconds threshold,
+                 callback_t callback)
+      : m_workers(workers.begin(), workers.end()),
+        m_threshold(threshold),
+        m_callback(std::move(callback)) {
+
+    if (threshold <= std::chrono::nanoseconds::zero()) {
+      LF_THROW(std::invalid_argument("Stall threshold must be positive"));
+    }
+
+    if (!m_callback) {
+      LF_THROW(std::invalid_argument("Stall callback must be callable"));
+    }
+
+    m_thread = std::jthread{[this](std::stop_token token) {
+      watch(std::move(token));
+    }};
+  }
+
+  /**
+   * @brief Stop and join the watchdog thread.
+   */
+  ~stall_detector() noexcept { m_thread.request_stop(); }
+
+ private:
+  using clock = std::chrono::steady_clock;
+
+  /**
+   * @brief The last observed state of a worker.
+   */
+  struct observation {
+    std::uint64_t strand = 0;
+    clock::time_point since = clock::now();
+    bool reported = false;
+  };
+
+  void watch(std::stop_token token) {
+
+    std::vector<observation> seen(m_workers.size());
+
+    auto period = m_threshold / 4 > clock::duration::zero() ? m_threshold / 4 : m_threshold;
+
+    std::mutex mut;
+    std::unique_lock lock{mut};
+
+    for (;;) {
+
+      // Returns early only if a stop is requested.
+      if (m_wake.wait_for(lock, token, period, [&token] {
+            return token.stop_requested();
+          })) {
+        return;
+      }
+
+      clock::time_point now = clock::now();
+
+      for (std::size_t i = 0; i < m_workers.size(); ++i) {
+
+        std::uint64_t strand = m_workers[i]->strand();
+
+        if (strand != seen[i].strand) {
+          seen[i] = {strand, now, false};
+          continue;
+        }
+
+        // Even means not executing a task.
+        if (strand % 2 == 0 || seen[i].reported || now - seen[i].since < m_threshold) {
+          continue;
+        }
+
+        seen[i].reported = true;
+
+        LF_LOG("Worker {} stalled", i);
+
+        m_callback({
+            .worker = i,
+            .context = m_workers[i],
+            .strand = strand,
+            .duration = std::chrono::duration_cast<std::chrono::nanoseconds>(now - seen[i].since),
+            .task = running_task(m_workers[i], strand),
+        });
+      }
+    }
+  }
+
+  /**
+   * @brief Get the handle of the task `worker` is running if it is still in `strand`.
+   *
+   * The address is published by the worker itself hence, this never touches the task's frame.
+   */
+  static auto running_task([[maybe_unused]] worker_context const *worker,
+                           [[maybe_unused]] std::uint64_t strand) noexcept -> std::coroutine_handle<> {
+  #ifdef LF_ASYNC_STACK
+    if (void *task = worker->running_task(); task != nullptr && worker->strand() == strand) {
+      return std::coroutine_handle<>::from_address(task);
+    }
+  #endif
+    return nullptr;
+  }
+
+  std::vector<worker_context *> m_workers;
+  std::chrono::nanoseconds m_threshold;
+  callback_t m_callback;
+  std::condition_variable_any m_wake;
+  std::jthread m_thread; // Must be last such that it is joined first.
+};
+
+} // namespace ext
+
+} // namespace lf
+
+#endif /* LF_STALL_DETECTOR */
+
+#endif /* A8D2F5B1_3C6E_4F07_9E14_6B0C7D9E2A53 */
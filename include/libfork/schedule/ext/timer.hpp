@@ -0,0 +1,513 @@
+#ifndef A1F6C39E_4B7D_4D25_8E0A_72C5B9D3F816
+#define A1F6C39E_4B7D_4D25_8E0A_72C5B9D3F816
+
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <algorithm>          // for max
+#include <array>              // for array
+#include <chrono>             // for steady_clock, duration, time_point, ceil, milliseconds
+#include <condition_variable> // for condition_variable
+#include <cstddef>            // for size_t
+#include <cstdint>            // for uint64_t
+#include <limits>             // for numeric_limits
+#include <mutex>              // for mutex, lock_guard, unique_lock
+#include <stdexcept>          // for invalid_argument
+#include <thread>             // for thread
+#include <utility>            // for exchange
+
+#include "libfork/core/ext/context.hpp"  // for worker_context
+#include "libfork/core/ext/handles.hpp"  // for submit_handle
+#include "libfork/core/ext/tls.hpp"      // for context
+#include "libfork/core/impl/utility.hpp" // for immovable, non_null
+#include "libfork/core/macro.hpp"        // for LF_ASSERT, LF_THROW
+#include "libfork/core/scheduler.hpp"    // for context_switcher
+
+/**
+ * @file timer.hpp
+ *
+ * @brief A hierarchical timer wheel and a service that resumes sleeping tasks.
+ */
+
+namespace lf {
+
+inline namespace ext {
+
+/**
+ * @brief An intrusive timer, the wheel never allocates.
+ *
+ * A node must not be moved or destroyed while it is in a wheel.
+ */
+class timer_node {
+ public:
+  /**
+   * @brief The type of the function called when a timer expires.
+   */
+  using fire_fn = void (*)(timer_node *) noexcept;
+
+  /**
+   * @brief Construct a timer that calls `fn` when it expires.
+   */
+  explicit constexpr timer_node(fire_fn fn) noexcept : m_fire(fn) {}
+
+  /**
+   * @brief Call the expiry function, this may destroy the node.
+   */
+  void fire() noexcept { m_fire(this); }
+
+  /**
+   * @brief Test if this node is in a wheel.
+   */
+  [[nodiscard]] auto linked() const noexcept -> bool { return m_slot != nullptr; }
+
+  /**
+   * @brief The tick this timer expires at, valid while linked or after it was fired.
+   */
+  [[nodiscard]] auto expiry() const noexcept -> std::uint64_t { return m_expiry; }
+
+ private:
+  friend class timer_wheel;
+
+  timer_node **m_slot = nullptr;
+  timer_node *m_prev = nullptr;
+  timer_node *m_next = nullptr;
+  std::uint64_t m_expiry = 0;
+  fire_fn m_fire;
+};
+
+/**
+ * @brief A hierarchical timer wheel with O(1) insert and cancel, this is not thread-safe.
+ *
+ * Time is measured in integer ticks. The wheel has four levels of 64 slots, a level covers 64 times the
+ * span of the level below, timers further than 2^24 ticks in the future are held in an overflow list. As
+ * time advances timers cascade from coarser to finer levels until they expire from the finest level.
+ */
+class timer_wheel {
+
+  static constexpr std::size_t k_bits = 6;
+  static constexpr std::size_t k_slots = std::size_t{1} << k_bits;
+  static constexpr std::size_t k_levels = 4;
+  static constexpr std::uint64_t k_mask = k_slots - 1;
+
+ public:
+  /**
+   * @brief Returned by `next_expiry` if the wheel is empty.
+   */
+  static constexpr std::uint64_t never = std::numeric_limits<std::uint64_t>::max();
+
+  /**
+   * @brief Construct an empty wheel at tick `now`.
+   */
+  explicit constexpr timer_wheel(std::uint64_t now = 0) noexcept : m_now(now) {}
+
+  /**
+   * @brief The current tick.
+   */
+  [[nodiscard]] auto now() const noexcept -> std::uint64_t { return m_now; }
+
+  /**
+   * @brief The number of timers in the wheel.
+   */
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return m_size; }
+
+  /**
+   * @brief Add `node` to expire at tick `expiry`, timers at or before the current tick expire on the next.
+   */
+  void insert(timer_node *node, std::uint64_t expiry) noexcept {
+    LF_ASSERT(!impl::non_null(node)->linked());
+    node->m_expiry = std::max(expiry, m_now + 1);
+    link(node);
+    ++m_size;
+  }
+
+  /**
+   * @brief Remove `node` from the wheel, returns false if it was not in the wheel.
+   */
+  auto cancel(timer_node *node) noexcept -> bool {
+    if (!impl::non_null(node)->linked()) {
+      return false;
+    }
+    unlink(node);
+    --m_size;
+    return true;
+  }
+
+  /**
+   * @brief Advance time to tick `to`, returns the expired timers in a list linked through `next(...)`.
+   *
+   * The returned timers are no longer in the wheel, the caller should `fire()` them.
+   */
+  [[nodiscard]] auto advance(std::uint64_t to) noexcept -> timer_node * {
+
+    timer_node *expired = nullptr;
+
+    while (m_now < to) {
+
+      if (m_size == 0) {
+        m_now = to;
+        break;
+      }
+
+      ++m_now;
+
+      if ((m_now & k_mask) == 0) {
+        cascade(1);
+      }
+
+      timer_node **slot = &m_wheel[0][m_now & k_mask];
+
+      while (timer_node *node = *slot) {
+        unlink(node);
+        --m_size;
+        node->m_next = expired;
+        expired = node;
+      }
+    }
+
+    return expired;
+  }
+
+  /**
+   * @brief Get the next node in a list returned by `advance`.
+   */
+  [[nodiscard]] static auto next(timer_node const *node) noexcept -> timer_node * { return node->m_next; }
+
+  /**
+   * @brief A tick at or before the next expiry, `never` if the wheel is empty.
+   *
+   * This is exact for timers in the finest level, otherwise it is the next cascade.
+   */
+  [[nodiscard]] auto next_expiry() const noexcept -> std::uint64_t {
+
+    if (m_size == 0) {
+      return never;
+    }
+
+    for (std::uint64_t tick = m_now + 1;; ++tick) {
+      if ((tick & k_mask) == 0 || m_wheel[0][tick & k_mask] != nullptr) {
+        return tick;
+      }
+    }
+  }
+
+ private:
+  /**
+   * @brief Get the list that `node` belongs in given the current tick.
+   */
+  auto slot_for(std::uint64_t expiry) noexcept -> timer_node ** {
+
+    std::uint64_t delta = expiry - m_now;
+
+    for (std::size_t level = 0; level < k_levels; ++level) {
+      if (delta < (std::uint64_t{1} << (k_bits * (level + 1)))) {
+        return &m_wheel[level][(expiry >> (k_bits * level)) & k_mask];
+      }
+    }
+
+    return &m_overflow;
+  }
+
+  /**
+   * @brief Push `node` onto the front of its slot.
+   */
+  void link(timer_node *node) noexcept {
+
+    timer_node **slot = slot_for(node->m_expiry);
+
+    node->m_slot = slot;
+    node->m_prev = nullptr;
+    node->m_next = *slot;
+
+    if (*slot != nullptr) {
+      (*slot)->m_prev = node;
+    }
+
+    *slot = node;
+  }
+
+  /**
+   * @brief Remove `node` from its slot.
+   */
+  static void unlink(timer_node *node) noexcept {
+
+    if (node->m_prev != nullptr) {
+      node->m_prev->m_next = node->m_next;
+    } else {
+      *node->m_slot = node->m_next;
+    }
+
+    if (node->m_next != nullptr) {
+      node->m_next->m_prev = node->m_prev;
+    }
+
+    node->m_slot = nullptr;
+  }
+
+  /**
+   * @brief Move the timers in the current slot of `level` to finer levels.
+   *
+   * If this level has also wrapped then the next level is cascaded after this one.
+   */
+  void cascade(std::size_t level) noexcept {
+
+    std::uint64_t index = level < k_levels ? (m_now >> (k_bits * level)) & k_mask : 0;
+
+    timer_node **slot = level < k_levels ? &m_wheel[level][index] : &m_overflow;
+
+    // Detach the list first, timers that are still far away are re-linked into the overflow list.
+    timer_node *node = std::exchange(*slot, nullptr);
+
+    while (node != nullptr) {
+      timer_node *next = node->m_next;
+      link(node);
+      node = next;
+    }
+
+    if (index == 0 && level < k_levels) {
+      cascade(level + 1);
+    }
+  }
+
+  std::uint64_t m_now;
+  std::size_t m_size = 0;
+  std::array<std::array<timer_node *, k_slots>, k_levels> m_wheel = {};
+  timer_node *m_overflow = nullptr;
+};
+
+/**
+ * @brief A thread that runs a timer wheel, timers can be added and cancelled by any thread.
+ *
+ * Timers are fired by the service thread hence, their expiry functions should be short, i.e. reschedule a
+ * task with `lf::ext::worker_context::schedule`.
+ */
+class timer_service : impl::immovable<timer_service> {
+ public:
+  /**
+   * @brief The clock timers are measured against.
+   */
+  using clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Construct a service with a resolution of `tick`, `tick` must be positive.
+   */
+  explicit timer_service(clock::duration tick = std::chrono::milliseconds{1})
+      : m_epoch{clock::now()},
+        m_tick{tick} {
+    if (tick <= clock::duration::zero()) {
+      LF_THROW(std::invalid_argument("A timer's tick must be positive"));
+    }
+    m_thread = std::thread{[this] {
+      serve();
+    }};
+  }
+
+  /**
+   * @brief Get a process-wide timer service with a resolution of one millisecond.
+   */
+  [[nodiscard]] static auto global() -> timer_service & {
+    static timer_service service;
+    return service;
+  }
+
+  /**
+   * @brief The number of pending timers.
+   */
+  [[nodiscard]] auto size() -> std::size_t {
+    std::lock_guard lock{m_mutex};
+    return m_wheel.size();
+  }
+
+  /**
+   * @brief Add `node` to expire at or after `deadline`.
+   */
+  void add(timer_node *node, clock::time_point deadline) {
+
+    auto since = (deadline - m_epoch).count();
+    auto tick = m_tick.count();
+
+    std::uint64_t expiry = since <= 0 ? 0 : static_cast<std::uint64_t>((since + tick - 1) / tick);
+
+    std::lock_guard lock{m_mutex};
+
+    if (m_wheel.size() == 0) {
+      // Jump over idle time now, else the wheel is left at a stale tick and serve() steps through every tick.
+      [[maybe_unused]] timer_node *expired = m_wheel.advance(current());
+      LF_ASSERT(expired == nullptr);
+    }
+
+    m_wheel.insert(node, expiry);
+
+    if (node->expiry() < m_wake) {
+      m_cv.notify_one();
+    }
+  }
+
+  /**
+   * @brief Remove `node`, returns false if it has already expired (its function may still be running).
+   */
+  auto cancel(timer_node *node) -> bool {
+    std::lock_guard lock{m_mutex};
+    return m_wheel.cancel(node);
+  }
+
+  /**
+   * @brief Stop the service thread, there must be no pending timers.
+   */
+  ~timer_service() noexcept {
+    {
+      std::lock_guard lock{m_mutex};
+      LF_ASSERT(m_wheel.size() == 0);
+      m_stop = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+  }
+
+ private:
+  /**
+   * @brief The current tick, rounded down.
+   */
+  auto current() const noexcept -> std::uint64_t {
+    return static_cast<std::uint64_t>((clock::now() - m_epoch) / m_tick);
+  }
+
+  /**
+   * @brief The body of the service thread.
+   */
+  void serve() {
+
+    std::unique_lock lock{m_mutex};
+
+    while (!m_stop) {
+
+      if (timer_node *expired = m_wheel.advance(current())) {
+        lock.unlock();
+        while (expired != nullptr) {
+          // Read the next node first, firing may destroy the node.
+          timer_node *next = timer_wheel::next(expired);
+          expired->fire();
+          expired = next;
+        }
+        lock.lock();
+        continue;
+      }
+
+      m_wake = m_wheel.next_expiry();
+
+      if (m_wake == timer_wheel::never) {
+        m_cv.wait(lock);
+      } else {
+        m_cv.wait_until(lock, m_epoch + m_tick * m_wake);
+      }
+
+      m_wake = timer_wheel::never;
+    }
+  }
+
+  clock::time_point m_epoch;
+  clock::duration m_tick;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  timer_wheel m_wheel;
+  std::uint64_t m_wake = timer_wheel::never;
+  bool m_stop = false;
+  std::thread m_thread;
+};
+
+/**
+ * @brief An `lf::core::context_switcher` that suspends a task until a deadline.
+ *
+ * The task is resumed on the worker it was suspended on.
+ */
+class [[nodiscard("This should be immediately co_awaited")]] sleep_awaitable : timer_node {
+ public:
+  /**
+   * @brief Sleep until `deadline` using `service`.
+   */
+  sleep_awaitable(timer_service &service, timer_service::clock::time_point deadline) noexcept
+      : timer_node{wake},
+        m_service{&service},
+        m_deadline{deadline} {}
+
+  /**
+   * @brief Don't suspend if the deadline has passed.
+   */
+  [[nodiscard]] auto await_ready() const noexcept -> bool {
+    return timer_service::clock::now() >= m_deadline;
+  }
+
+  /**
+   * @brief Park this task in the timer service.
+   */
+  void await_suspend(submit_handle handle) {
+    m_handle = handle;
+    m_home = impl::non_null(impl::tls::context());
+    // After this the timer may fire (and this task resume) at any time.
+    m_service->add(this, m_deadline);
+  }
+
+  /**
+   * @brief A no-op.
+   */
+  static void await_resume() noexcept {}
+
+ private:
+  /**
+   * @brief Reschedule the task on its home worker.
+   */
+  static void wake(timer_node *node) noexcept {
+    auto *self = static_cast<sleep_awaitable *>(node);
+    self->m_home->schedule(self->m_handle);
+  }
+
+  timer_service *m_service;
+  timer_service::clock::time_point m_deadline;
+  submit_handle m_handle = nullptr;
+  worker_context *m_home = nullptr;
+};
+
+static_assert(context_switcher<sleep_awaitable>);
+
+/**
+ * @brief Suspend the current task until `deadline`, without blocking the worker.
+ */
+inline auto sleep_until(timer_service &service, timer_service::clock::time_point deadline) noexcept
+    -> sleep_awaitable {
+  return {service, deadline};
+}
+
+/**
+ * @brief Suspend the current task until `deadline` using the process-wide timer service.
+ */
+inline auto sleep_until(timer_service::clock::time_point deadline) -> sleep_awaitable {
+  return sleep_until(timer_service::global(), deadline);
+}
+
+/**
+ * @brief Suspend the current task for at least `duration`, without blocking the worker.
+ */
+template <typename Rep, typename Period>
+auto sleep_for(timer_service &service, std::chrono::duration<Rep, Period> duration) noexcept
+    -> sleep_awaitable {
+  return sleep_until(service, timer_service::clock::now() +
+                                  std::chrono::ceil<timer_service::clock::duration>(duration));
+}
+
+/**
+ * @brief Suspend the current task for at least `duration` using the process-wide timer service.
+ */
+template <typename Rep, typename Period>
+auto sleep_for(std::chrono::duration<Rep, Period> duration) -> sleep_awaitable {
+  return sleep_for(timer_service::global(), duration);
+}
+
+} // namespace ext
+
+} // namespace lf
+
+#endif /* A1F6C39E_4B7D_4D25_8E0A_72C5B9D3F816 */
@@ -0,0 +1,204 @@
+#ifndef E4A7C1D9_5B2F_4C3E_8D60_71F9A2B3C845
+#define E4A7C1D9_5B2F_4C3E_8D60_71F9A2B3C845
+
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <array>   // for array
+#include <atomic>  // for atomic, memory_order_relaxed
+#include <chrono>  // for nanoseconds, steady_clock
+#include <cstddef> // for size_t
+#include <cstdint> // for int64_t, uint8_t
+
+#include "libfork/core/impl/utility.hpp" // for immovable, k_cache_line
+
+/**
+ * @file utilization.hpp
+ *
+ * @brief Per-worker accounting of the time spent executing, searching for work and, sleeping.
+ *
+ * Accounting is compiled in only if ``LF_UTILIZATION`` is defined, otherwise every breakdown is zero.
+ */
+
+namespace lf {
+
+inline namespace ext {
+
+/**
+ * @brief A breakdown of the (monotonic, wall-clock) time a worker has spent in each scheduler state.
+ *
+ * Unlike OS CPU time, time a worker spends spinning in a steal loop is reported as `searching` rather
+ * than busy. Subtract two snapshots to get the breakdown over an interval.
+ */
+struct worker_utilization {
+  /**
+   * @brief Time spent running tasks.
+   */
+  std::chrono::nanoseconds executing{0};
+  /**
+   * @brief Time spent looking for work, i.e. polling submissions or in steal loops.
+   */
+  std::chrono::nanoseconds searching{0};
+  /**
+   * @brief Time spent blocked waiting to be woken.
+   */
+  std::chrono::nanoseconds sleeping{0};
+
+  /**
+   * @brief The total time accounted for.
+   */
+  [[nodiscard]] constexpr auto total() const noexcept -> std::chrono::nanoseconds {
+    return executing + searching + sleeping;
+  }
+
+  /**
+   * @brief The fraction of the total time spent executing tasks, zero if no time has been accounted for.
+   */
+  [[nodiscard]] constexpr auto busy_fraction() const noexcept -> double {
+    auto den = total().count();
+    return den > 0 ? static_cast<double>(executing.count()) / static_cast<double>(den) : 0.0;
+  }
+
+  /**
+   * @brief Accumulate another breakdown into this one.
+   */
+  constexpr auto operator+=(worker_utilization const &other) noexcept -> worker_utilization & {
+    executing += other.executing;
+    searching += other.searching;
+    sleeping += other.sleeping;
+    return *this;
+  }
+
+  /**
+   * @brief Sum two breakdowns.
+   */
+  [[nodiscard]] friend constexpr auto
+  operator+(worker_utilization lhs, worker_utilization const &rhs) noexcept -> worker_utilization {
+    return lhs += rhs;
+  }
+
+  /**
+   * @brief The breakdown over the interval between two snapshots.
+   */
+  [[nodiscard]] friend constexpr auto
+  operator-(worker_utilization const &lhs, worker_utilization const &rhs) noexcept -> worker_utilization {
+    return {lhs.executing - rhs.executing, lhs.searching - rhs.searching, lhs.sleeping - rhs.sleeping};
+  }
+};
+
+} // namespace ext
+
+namespace impl {
+
+/**
+ * @brief The state of a worker for the purpose of utilization accounting.
+ */
+enum class worker_state : std::uint8_t {
+  /**
+   * @brief Running tasks.
+   */
+  executing,
+  /**
+   * @brief Looking for work.
+   */
+  searching,
+  /**
+   * @brief Blocked waiting for work.
+   */
+  sleeping,
+};
+
+/**
+ * @brief A per-worker monotonic clock that accumulates the time spent in each `worker_state`.
+ *
+ * Transitions must only be made by the owning worker, snapshots may be taken concurrently by any thread.
+ * A concurrent snapshot is approximate as it may be torn across a transition. Unless ``LF_UTILIZATION``
+ * is defined transitions are no-ops (they do not read the clock) and snapshots are zero.
+ */
+class alignas(k_cache_line) utilization_clock : immovable<utilization_clock> {
+
+  using clock = std::chrono::steady_clock;
+
+  [[nodiscard]] static auto now() noexcept -> std::int64_t {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+  }
+
+  static constexpr std::size_t k_num_states = 3;
+
+#ifdef LF_UTILIZATION
+  static constexpr bool k_enabled = true;
+#else
+  static constexpr bool k_enabled = false;
+#endif
+
+ public:
+  /**
+   * @brief Begin accounting time to the searching state.
+   */
+  utilization_clock() noexcept : m_since{k_enabled ? now() : 0} {}
+
+  /**
+   * @brief Account the time since the last transition to the current state and switch to `next`.
+   */
+  void transition([[maybe_unused]] worker_state next) noexcept {
+#ifdef LF_UTILIZATION
+    std::int64_t stamp = now();
+
+    auto prev = m_state.load(std::memory_order_relaxed);
+    auto &acc = m_total[static_cast<std::size_t>(prev)];
+
+    // Only the owner writes so a load/store pair is sufficient.
+    acc.store(acc.load(std::memory_order_relaxed) + (stamp - m_since.load(std::memory_order_relaxed)),
+              std::memory_order_relaxed);
+
+    m_since.store(stamp, std::memory_order_relaxed);
+    m_state.store(next, std::memory_order_relaxed);
+#endif
+  }
+
+  /**
+   * @brief Get the time accounted to each state including the in-progress interval.
+   */
+  [[nodiscard]] auto snapshot() const noexcept -> worker_utilization {
+
+    std::array<std::int64_t, k_num_states> sum{};
+
+    if (!k_enabled) {
+      return {};
+    }
+
+    for (std::size_t i = 0; i < k_num_states; ++i) {
+      sum[i] = m_total[i].load(std::memory_order_relaxed);
+    }
+
+    auto state = static_cast<std::size_t>(m_state.load(std::memory_order_relaxed));
+
+    if (std::int64_t open = now() - m_since.load(std::memory_order_relaxed); open > 0) {
+      sum[state] += open;
+    }
+
+    using ns = std::chrono::nanoseconds;
+
+    return {
+        ns{sum[static_cast<std::size_t>(worker_state::executing)]},
+        ns{sum[static_cast<std::size_t>(worker_state::searching)]},
+        ns{sum[static_cast<std::size_t>(worker_state::sleeping)]},
+    };
+  }
+
+ private:
+  std::array<std::atomic<std::int64_t>, k_num_states> m_total{};
+  std::atomic<std::int64_t> m_since;
+  std::atomic<worker_state> m_state = worker_state::searching;
+};
+
+} // namespace impl
+
+} // namespace lf
+
+#endif /* E4A7C1D9_5B2F_4C3E_8D60_71F9A2B3C845 */
@@ -10,20 +10,24 @@
 // file, You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <algorithm> // for shuffle
+#include <concepts>  // for same_as
 #include <cstddef>   // for size_t
 #include <memory>    // for shared_ptr
 #include <random>    // for discrete_distribution
+#include <thread>    // for yield
 #include <utility>   // for exchange, move
 #include <vector>    // for vector
 
-#include "libfork/core/ext/context.hpp"    // for worker_context, nullary_function_t
-#include "libfork/core/ext/deque.hpp"      // for err
-#include "libfork/core/ext/handles.hpp"    // for submit_handle, task_handle
-#include "libfork/core/ext/tls.hpp"        // for finalize, worker_init
-#include "libfork/core/impl/utility.hpp"   // for non_null, map
-#include "libfork/core/macro.hpp"          // for LF_ASSERT, LF_LOG, LF_CATCH_ALL, LF_RETHROW
-#include "libfork/schedule/ext/numa.hpp"   // for numa_topology
-#include "libfork/schedule/ext/random.hpp" // for xoshiro
+#include "libfork/core/ext/context.hpp"         // for worker_context, nullary_function_t
+#include "libfork/core/ext/deque.hpp"           // for err
+#include "libfork/core/ext/handles.hpp"         // for submit_handle, task_handle
+#include "libfork/core/ext/resume.hpp"          // for resume
+#include "libfork/core/ext/tls.hpp"             // for finalize, worker_init, context, stack
+#include "libfork/core/impl/utility.hpp"        // for non_null, map
+#include "libfork/core/macro.hpp"               // for LF_ASSERT, LF_LOG, LF_CATCH_ALL, LF_RETHROW
+#include "libfork/schedule/ext/numa.hpp"        // for numa_topology, numa_node
+#include "libfork/schedule/ext/random.hpp"      // for xoshiro
+#include "libfork/schedule/ext/utilization.hpp" // for utilization_clock, worker_state, worker_utilization
 
 /**
  * @file numa_context.hpp
@@ -48,6 +52,11 @@ struct numa_context {
    * @brief The number of steal attempts we will make per target in a `try_steal` operation.
    */
   static constexpr std::size_t k_steal_attempts_per_target = 32;
+  /**
+   * @brief The number of times a thief yields, per efficiency class it is slower than the fastest worker,
+   * before each `try_steal` operation.
+   */
+  static constexpr int k_yields_per_handicap = 16;
   /**
    * @brief Thread-local RNG.
    */
@@ -72,6 +81,14 @@ struct numa_context {
    * @brief Our neighbors (excluding ourselves).
    */
   std::vector<numa_context *> m_neigh;
+  /**
+   * @brief Time spent by the owning worker in each state.
+   */
+  utilization_clock m_clock;
+  /**
+   * @brief The number of efficiency classes our core is slower than the fastest worker's.
+   */
+  int m_handicap = 0;
 
  public:
   /**
@@ -103,8 +120,14 @@ struct numa_context {
    *
    * The lifetime of the `context` and `topo` neighbors must outlive all use of this object (excluding
    * destruction).
+   *
+   * If `warm_up` then the worker's stack and deque are pre-faulted, if `private_deque` then the worker
+   * only shares its tasks on request, see `lf::ext::worker_init`.
    */
-  void init_worker_and_bind(nullary_function_t notify, numa_node const &topo) {
+  void init_worker_and_bind(nullary_function_t notify,
+                            numa_node const &topo,
+                            bool warm_up = false,
+                            bool private_deque = false) {
 
     LF_ASSERT(!topo.neighbors.empty());
     LF_ASSERT(!topo.neighbors.front().empty());
@@ -114,7 +137,15 @@ struct numa_context {
 
     topo.bind();
 
-    m_context = worker_init(std::move(notify));
+    m_handicap = topo.handicap;
+
+    m_context = worker_init(std::move(notify), private_deque);
+
+    if (warm_up) {
+      // After binding such that first-touch places the pages on our numa node.
+      tls::context()->prefault();
+      tls::stack()->prefault();
+    }
 
     std::vector<double> weights;
 
@@ -151,6 +182,11 @@ struct numa_context {
     // clang-format on
   }
 
+  /**
+   * @brief The number of efficiency classes the owning worker's core is slower than the fastest in the pool.
+   */
+  [[nodiscard]] auto handicap() const noexcept -> int { return m_handicap; }
+
   /**
    * @brief Call `lf::finalize` on the underlying worker context.
    */
@@ -161,6 +197,27 @@ struct numa_context {
    */
   auto get_underlying() noexcept -> worker_context * { return m_context; }
 
+  /**
+   * @brief Resume `handle` accounting the time to the executing state, then return to searching.
+   */
+  template <typename Handle>
+    requires std::same_as<Handle, task_handle> || std::same_as<Handle, submit_handle>
+  void resume(Handle handle) noexcept {
+    m_clock.transition(worker_state::executing);
+    lf::ext::resume(handle);
+    m_clock.transition(worker_state::searching);
+  }
+
+  /**
+   * @brief Account subsequent time to `state`, must be called by the owning worker.
+   */
+  void transition(worker_state state) noexcept { m_clock.transition(state); }
+
+  /**
+   * @brief Get the time the owning worker has spent in each state, may be called by any thread.
+   */
+  [[nodiscard]] auto utilization() const noexcept -> worker_utilization { return m_clock.snapshot(); }
+
   /**
    * @brief schedule a job to the owned worker context.
    */
@@ -175,6 +232,10 @@ struct numa_context {
 
   /**
    * @brief Try to steal a task from one of our friends, returns `nullptr` if we failed.
+   *
+   * On a heterogeneous machine slow workers first give the faster workers a head start hence, the tasks
+   * at the top of the victims' deques (the oldest and, typically, the largest) tend to be stolen onto the
+   * fast cores.
    */
   [[nodiscard]] auto try_steal() noexcept -> task_handle {
 
@@ -182,6 +243,13 @@ struct numa_context {
       return nullptr;
     }
 
+    for (int i = 0; i < m_handicap * k_yields_per_handicap; ++i) {
+      std::this_thread::yield();
+    }
+
+    // Waits on owners with private deques are bounded per operation, not per attempt.
+    int patience = worker_context::k_request_patience;
+
 #ifndef LF_DOXYGEN_SHOULD_SKIP_THIS
 
   #define LF_RETURN_OR_CONTINUE(expr)                                                                        \
@@ -189,7 +257,7 @@ struct numa_context {
       auto *context = expr;                                                                                  \
       LF_ASSERT(context);                                                                                    \
       LF_ASSERT(context->m_context);                                                                         \
-      auto [err, task] = context->m_context->try_steal();                                                    \
+      auto [err, task] = context->m_context->try_steal(m_context, patience);                                 \
                                                                                                              \
       switch (err) {                                                                                         \
         case lf::err::none:                                                                                  \
@@ -227,6 +295,26 @@ struct numa_context {
   }
 };
 
+/**
+ * @brief Get the indices of the nodes whose workers should receive submitted tasks.
+ *
+ * If `prefer_fast` these are the nodes on the fastest kind of core otherwise, every node.
+ */
+template <typename T>
+auto root_workers(std::vector<numa_topology::numa_node<T>> const &nodes, bool prefer_fast)
+    -> std::vector<std::size_t> {
+
+  std::vector<std::size_t> roots;
+
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    if (!prefer_fast || nodes[i].handicap == 0) {
+      roots.push_back(i);
+    }
+  }
+
+  return roots;
+}
+
 } // namespace lf::impl
 
 #endif /* C1B42944_8E33_4F6B_BAD6_5FB687F6C737 */
@@ -11,6 +11,7 @@
 
 #include <algorithm>  // for __max_element_fn, max_element
 #include <atomic>     // for atomic_flag, memory_order, memory_orde...
+#include <chrono>     // for nanoseconds
 #include <concepts>   // for same_as
 #include <cstddef>    // for size_t
 #include <functional> // for less
@@ -23,17 +24,21 @@
 #include <vector>     // for vector
 
 #include "libfork/core/defer.hpp"                 // for LF_DEFER
-#include "libfork/core/ext/context.hpp"           // for worker_context, nullary_function_t
+#include "libfork/core/ext/context.hpp"           // for worker_context, nullary_function_t, worker_memory
 #include "libfork/core/ext/handles.hpp"           // for submit_handle, task_handle
-#include "libfork/core/ext/resume.hpp"            // for resume
-#include "libfork/core/impl/utility.hpp"          // for k_cache_line
-#include "libfork/core/macro.hpp"                 // for LF_ASSERT, LF_LOG, LF_ASSERT_NO_ASSUME
+#include "libfork/core/impl/utility.hpp"          // for k_cache_line, map
+#include "libfork/core/macro.hpp"                 // for LF_ASSERT, LF_LOG, LF_ASSERT_NO_ASSUME, LF_PROBE
 #include "libfork/core/scheduler.hpp"             // for scheduler
-#include "libfork/schedule/busy_pool.hpp"         // for busy_vars
+#include "libfork/core/sender.hpp"                // for execution_scheduler
+#include "libfork/schedule/busy_pool.hpp"         // for busy_vars, start_workers
+#include "libfork/schedule/ext/arbiter.hpp"       // for thread_arbiter
 #include "libfork/schedule/ext/event_count.hpp"   // for event_count
 #include "libfork/schedule/ext/numa.hpp"          // for numa_strategy, numa_topology
+#include "libfork/schedule/ext/options.hpp"       // for pool_options
 #include "libfork/schedule/ext/random.hpp"        // for xoshiro, seed
-#include "libfork/schedule/impl/numa_context.hpp" // for numa_context
+#include "libfork/schedule/ext/reactor.hpp"       // for reactor
+#include "libfork/schedule/ext/utilization.hpp"   // for worker_state, worker_utilization
+#include "libfork/schedule/impl/numa_context.hpp" // for numa_context, root_workers
 
 /**
  * @file lazy_pool.hpp
@@ -56,6 +61,10 @@ static constexpr std::memory_order acq_rel = std::memory_order_acq_rel;
  * @brief Alias to the `std` version.
  */
 static constexpr std::memory_order release = std::memory_order_release;
+/**
+ * @brief Alias to the `std` version.
+ */
+static constexpr std::memory_order seq_cst = std::memory_order_seq_cst;
 
 /**
  * @brief A collection of heap allocated atomic variables used for tracking the state of the scheduler.
@@ -86,15 +95,39 @@ struct lazy_vars : busy_vars {
    * @brief Counters for each numa locality.
    */
   alignas(k_cache_line) std::vector<fat_counters> numa;
+  /**
+   * @brief This pool's registration with a thread arbiter, or null. Declared after `numa` as it uses it.
+   */
+  std::unique_ptr<thread_arbiter::client> arbiter;
+  /**
+   * @brief An external event source that idle workers poll, or null.
+   */
+  reactor *events = nullptr;
+  /**
+   * @brief Set while a worker is polling `events`.
+   */
+  alignas(k_cache_line) std::atomic_flag polling;
+
+  /**
+   * @brief The `event_count` hook that returns a worker parked in the reactor to the pool.
+   */
+  static void wake_poller(void *self) noexcept {
+    auto *vars = static_cast<lazy_vars *>(self);
+    // Pairs with the fence implied by `polling.test_and_set` in the poller, see `lazy_work`.
+    std::atomic_thread_fence(seq_cst);
+    if (vars->polling.test(std::memory_order_relaxed)) {
+      vars->events->wake();
+    }
+  }
 
   // Invariant: *** if (A > 0) then (T >= 1 OR S == 0) ***
 
   /**
    * Called by a thief with work, effect: thief->active, do work, active->sleep.
    */
-  template <typename Handle>
+  template <typename Handle, typename Context>
     requires std::same_as<Handle, task_handle> || std::same_as<Handle, submit_handle>
-  void thief_work_sleep(Handle handle, std::size_t tid) noexcept {
+  void thief_work_sleep(Handle handle, std::size_t tid, Context &context) noexcept {
 
     // Invariant: *** if (A > 0) then (Ti >= 1 OR Si == 0) for all i***
 
@@ -126,13 +159,96 @@ struct lazy_vars : busy_vars {
       }
     }
 
-    resume(handle);
+    context.resume(handle);
 
     // Finally A <- A - 1 does not invalidate the invariant in any domain.
     active.fetch_sub(1, release);
   }
 };
 
+/**
+ * @brief Make sure a worker holds a token from `arbiter`, returns false if the worker must park.
+ */
+inline auto lazy_keep_token(thread_arbiter::client &arbiter, bool &has_token) noexcept -> bool {
+
+  if (has_token && arbiter.should_yield()) {
+    arbiter.release();
+    has_token = false;
+  }
+
+  if (!has_token) {
+    has_token = arbiter.try_acquire();
+  }
+
+  return has_token;
+}
+
+/**
+ * @brief Wait for a token from `arbiter` or for a submission, returns false if the pool has stopped.
+ *
+ * A parked worker is not a thief hence, it counts as sleeping for the invariants in `lazy_work`.
+ */
+inline auto lazy_park(numa_context<lazy_vars> &context,
+                      std::size_t numa_tid,
+                      thread_arbiter::client &arbiter,
+                      bool &has_token) noexcept -> bool {
+
+  LF_ASSERT(!has_token);
+
+  lazy_vars &shared = context.shared();
+
+  auto &my_numa_vars = shared.numa[numa_tid];
+
+  auto key = my_numa_vars.notifier.prepare_wait();
+
+  // Only a pool with active workers has work to share, parked workers of idle pools are not woken.
+  bool demand = shared.active.load(acquire) > 0;
+
+  if (demand) {
+    arbiter.park();
+  }
+
+  auto unpark = [&]() noexcept {
+    if (demand) {
+      arbiter.unpark();
+    }
+  };
+
+  if (auto *submission = context.try_pop_all()) {
+    // A submission must be run by this worker, borrow a token for it.
+    my_numa_vars.notifier.cancel_wait();
+    unpark();
+    arbiter.acquire();
+    has_token = true;
+    my_numa_vars.thief.fetch_add(1, release);
+    shared.thief_work_sleep(submission, numa_tid, context);
+    return true;
+  }
+
+  if (shared.stop.test(acquire)) {
+    my_numa_vars.notifier.cancel_wait();
+    my_numa_vars.notifier.notify_all();
+    unpark();
+    return false;
+  }
+
+  if (arbiter.try_acquire()) {
+    my_numa_vars.notifier.cancel_wait();
+    unpark();
+    has_token = true;
+    return true;
+  }
+
+  LF_LOG("Parks waiting for a token");
+
+  context.transition(worker_state::sleeping);
+  my_numa_vars.notifier.wait(key);
+  context.transition(worker_state::searching);
+
+  unpark();
+  return true;
+}
+
 /**
  * @brief The function that workers run while the pool is alive (worker event-loop)
  */
@@ -155,7 +271,8 @@ inline auto lazy_work(numa_topology::numa_node<numa_context<lazy_vars>> node) no
     my_numa_vars.notifier.notify_all();
   }};
 
-  my_context->init_worker_and_bind(std::move(notify), node);
+  my_context->init_worker_and_bind(
+      std::move(notify), node, my_context->shared().warm_up, my_context->shared().private_deques);
 
   // Wait for everyone to have set up their numa_vars. If this throws an exception then
   // program terminates due to the noexcept marker.
@@ -168,6 +285,10 @@ inline auto lazy_work(numa_topology::numa_node<numa_context<lazy_vars>> node) no
     my_context->finalize_worker();
   };
 
+  thread_arbiter::client *arbiter = my_context->shared().arbiter.get();
+
+  bool has_token = false;
+
   // ----------------------------------- //
 
   /**
@@ -181,6 +302,10 @@ inline auto lazy_work(numa_topology::numa_node<numa_context<lazy_vars>> node) no
    *  A = number of active threads across all numa domains
    *
    * Invariant: *** if (A > 0) then (Ti >= 1 OR Si == 0) for all i***
+   *
+   * If the pool has an arbiter then a worker must hold a token to be a thief or active, workers parked
+   * waiting for a token count as sleeping. The invariant can be broken while parked, this costs
+   * parallelism, not progress, as active workers do not depend on thieves to complete their tasks.
    */
 
   /**
@@ -193,23 +318,47 @@ inline auto lazy_work(numa_topology::numa_node<numa_context<lazy_vars>> node) no
    */
 
 wake_up:
+
+  if (arbiter != nullptr && !lazy_keep_token(*arbiter, has_token)) {
+    if (lazy_park(*my_context, numa_tid, *arbiter, has_token)) {
+      goto wake_up;
+    }
+    return;
+  }
+
   /**
    * Invariant maintained by Lemma 1.
    */
   my_numa_vars.thief.fetch_add(1, release);
 
+search:
+
   /**
    * First we handle the fast path (work to do) before touching the notifier.
    */
   if (auto *submission = my_context->try_pop_all()) {
-    my_context->shared().thief_work_sleep(submission, numa_tid);
+    my_context->shared().thief_work_sleep(submission, numa_tid, *my_context);
     goto wake_up;
   }
   if (auto *stolen = my_context->try_steal()) {
-    my_context->shared().thief_work_sleep(stolen, numa_tid);
+    my_context->shared().thief_work_sleep(stolen, numa_tid, *my_context);
     goto wake_up;
   }
 
+  /**
+   * Drain the reactor without blocking such that its events are not delayed until a worker sleeps, its
+   * handlers may have submitted work.
+   */
+  if (reactor *events = my_context->shared().events; events != nullptr) {
+    if (!my_context->shared().polling.test_and_set(seq_cst)) {
+      std::size_t handled = events->poll(std::chrono::nanoseconds::zero());
+      my_context->shared().polling.clear(release);
+      if (handled > 0) {
+        goto search; // We are still a thief.
+      }
+    }
+  }
+
   /**
    * Now we are going to try and sleep if the conditions are correct.
    *
@@ -230,7 +379,7 @@ wake_up:
   if (auto *submission = my_context->try_pop_all()) {
     // Check our private **before** `stop`.
     my_numa_vars.notifier.cancel_wait();
-    my_context->shared().thief_work_sleep(submission, numa_tid);
+    my_context->shared().thief_work_sleep(submission, numa_tid, *my_context);
     goto wake_up;
   }
 
@@ -242,6 +391,9 @@ wake_up:
     my_numa_vars.notifier.cancel_wait();
     my_numa_vars.notifier.notify_all();
     my_numa_vars.thief.fetch_sub(1, release);
+    if (has_token) {
+      arbiter->release();
+    }
     return;
   }
 
@@ -259,7 +411,9 @@ wake_up:
    * This maintains invariant in numa.
    */
 
-  if (my_numa_vars.thief.fetch_sub(1, acq_rel) == 1) {
+  bool last = my_numa_vars.thief.fetch_sub(1, acq_rel) == 1;
+
+  if (last) {
 
     // If we are the last thief then invariant may be broken if A > 0 as S > 0 (because we are asleep).
 
@@ -271,9 +425,43 @@ wake_up:
   }
 
   LF_LOG("Goes to sleep");
+  LF_PROBE(worker_sleep, numa_tid);
+
+  if (has_token) {
+    arbiter->release();
+    has_token = false;
+  }
 
   // We are safe to sleep.
+  my_context->transition(worker_state::sleeping);
+
+  if (reactor *events = my_context->shared().events; events != nullptr && last) {
+    if (!my_context->shared().polling.test_and_set(seq_cst)) {
+      /**
+       * We are the last thief in our numa domain to sleep hence, the pool's poller, park in the reactor
+       * instead of on the futex. Earlier sleepers use the futex, while any thieves remain they poll the
+       * reactor without blocking and, the last of them ends up here. If the flag is held then its holder
+       * is a thief (that will later get here) or, already parked in the reactor.
+       *
+       * We are still counted as a waiter on the notifier hence, any notification that would wake us calls
+       * `wake_poller`. Either the notifier sees `polling` set and wakes the reactor or, we see the new
+       * epoch and skip the poll.
+       */
+      if (!my_numa_vars.notifier.notified(key)) {
+        events->poll(std::chrono::nanoseconds{-1});
+      }
+      my_context->shared().polling.clear(release);
+      my_numa_vars.notifier.cancel_wait();
+      my_context->transition(worker_state::searching);
+      LF_PROBE(worker_wake, numa_tid);
+      goto wake_up;
+    }
+  }
+
   my_numa_vars.notifier.wait(key);
+  my_context->transition(worker_state::searching);
+
+  LF_PROBE(worker_wake, numa_tid);
   // Note, this could be a spurious wakeup, that doesn't matter because we will just loop around.
   goto wake_up;
 }
@@ -287,6 +475,11 @@ wake_up:
  * This pool sleeps workers which cannot find any work, as such it should be the default choice for most
  * use cases. Additionally (if an installation of `hwloc` was found) this pool is NUMA aware.
  *
+ * If many pools share a process they can share a `lf::ext::thread_arbiter` to avoid oversubscription.
+ *
+ * An external event loop (`lf::ext::reactor`) can be driven by the pool's idle workers, its events are
+ * handled while at least one worker is searching for work or idle.
+ *
  * __Note:__ The `lazy_pool` must not be destructed until all submitted tasks have reached a point where they
  * will submit no-more work to the pool.
  */
@@ -299,6 +492,7 @@ class lazy_pool {
   std::vector<std::shared_ptr<impl::numa_context<impl::lazy_vars>>> m_worker = {};
   std::vector<std::thread> m_threads = {};
   std::vector<worker_context *> m_contexts = {};
+  std::vector<std::size_t> m_roots = {};
 
  public:
   /**
@@ -323,9 +517,11 @@ class lazy_pool {
    *
    * @param n The number of worker threads to create, defaults to the number of hardware threads.
    * @param strategy The numa strategy for distributing workers.
+   * @param options Less common settings (including an arbiter or a reactor), see `lf::ext::pool_options`.
    */
   explicit lazy_pool(std::size_t n = std::thread::hardware_concurrency(),
-                     numa_strategy strategy = numa_strategy::fan)
+                     numa_strategy strategy = numa_strategy::fan,
+                     pool_options const &options = {})
       : m_num_threads(n) {
 
     LF_ASSERT_NO_ASSUME(m_share && !m_share->stop.test(std::memory_order_acquire));
@@ -335,7 +531,10 @@ class lazy_pool {
       m_rng.long_jump();
     }
 
-    std::vector nodes = numa_topology{}.distribute(m_worker, strategy);
+    std::vector nodes = options.topology.distribute(m_worker, strategy, options.placement);
+
+    m_roots = impl::root_workers(nodes, options.prefer_fast_cores);
+    m_dist = std::uniform_int_distribution<std::size_t>{0, m_roots.size() - 1};
 
     LF_ASSERT(!nodes.empty());
 
@@ -347,12 +546,28 @@ class lazy_pool {
 
     m_share->numa = std::vector<impl::lazy_vars::fat_counters>(num_numa);
 
+    if (reactor *events = options.events; events != nullptr) {
+      m_share->events = events;
+      for (auto &&domain : m_share->numa) {
+        domain.notifier.on_notify(impl::lazy_vars::wake_poller, m_share.get());
+      }
+    }
+
+    if (thread_arbiter *arbiter = options.arbiter; arbiter != nullptr) {
+      m_share->arbiter = std::make_unique<thread_arbiter::client>(*arbiter, [share = m_share.get()]() {
+        for (auto &&domain : share->numa) {
+          domain.notifier.notify_all();
+        }
+      });
+    }
+
+    m_share->warm_up = options.warm_up;
+    m_share->private_deques = options.private_deques;
+
     [&]() noexcept {
       // All workers must be created, if we fail to create them all then we must terminate else
       // the workers will hang on the latch.
-      for (auto &&node : nodes) {
-        m_threads.emplace_back(impl::lazy_work, std::move(node));
-      }
+      impl::start_workers(m_threads, nodes, impl::lazy_work);
 
       // Wait for everyone to have set up their numa_vars before submitting. This
       // must be noexcept as if we fail the countdown then the workers will hang.
@@ -366,15 +581,41 @@ class lazy_pool {
   }
 
   /**
-   * @brief Schedule a job on a random worker.
+   * @brief Schedule a job on a random worker, see `lf::ext::pool_options::prefer_fast_cores`.
    */
-  void schedule(submit_handle job) { m_worker[m_dist(m_rng)]->schedule(job); }
+  void schedule(submit_handle job) { m_worker[m_roots[m_dist(m_rng)]]->schedule(job); }
+
+  /**
+   * @brief Get a P2300 scheduler handle to this pool, see `lf::core::as_sender`.
+   */
+  [[nodiscard]] auto get_scheduler() noexcept { return execution_scheduler{*this}; }
 
   /**
    * @brief Get a view of the worker's contexts.
    */
   auto contexts() noexcept -> std::span<worker_context *> { return m_contexts; }
 
+  /**
+   * @brief Get a snapshot of the time each worker has spent executing, searching and, sleeping.
+   *
+   * Subtract two snapshots to measure the utilization of the pool over an interval. This is all zeros
+   * unless ``LF_UTILIZATION`` is defined.
+   */
+  [[nodiscard]] auto utilization() const -> std::vector<worker_utilization> {
+    return impl::map(m_worker, [](auto const &worker) {
+      return worker->utilization();
+    });
+  }
+
+  /**
+   * @brief Get a snapshot of the memory held by each worker's stack, deque and submission queue.
+   */
+  [[nodiscard]] auto memory_report() const -> std::vector<worker_memory> {
+    return impl::map(m_contexts, [](worker_context const *context) {
+      return context->memory();
+    });
+  }
+
   /**
    * @brief Destroy the lazy pool object, stops all workers.
    */
@@ -0,0 +1,280 @@
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <array>                                 // for array
+#include <catch2/catch_template_test_macros.hpp> // for TEMPLATE_TEST_CASE
+#include <catch2/catch_test_macros.hpp>          // for REQUIRE, TEST_CASE
+#include <coroutine>                             // for coroutine_handle
+#include <cstddef>                               // for size_t
+
+#include "libfork/core.hpp"     // for current_task_stack, task, fork, call, join, sync_wait
+#include "libfork/schedule.hpp" // for busy_pool, lazy_pool, unit_pool
+
+using namespace lf;
+
+namespace {
+
+/**
+ * @brief Returns the depth of the async stack at every leaf or -1 if any task saw an inconsistent stack.
+ */
+inline constexpr auto depth = [](auto depth, int n) -> task<int> {
+  //
+  std::array<std::coroutine_handle<>, 64> buf{};
+
+  auto before = current_task_stack(buf);
+
+  if (n == 0) {
+    co_return static_cast<int>(before.size());
+  }
+
+  int a = 0;
+  int b = 0;
+
+  co_await lf::fork(&a, depth)(n - 1);
+  co_await lf::call(&b, depth)(n - 1);
+
+  co_await lf::join;
+
+  // After a join this task may be running on a different worker but its logical stack is unchanged.
+  auto after = current_task_stack(buf);
+
+  if (a != b || after.size() != before.size()) {
+    co_return -1;
+  }
+
+  co_return a;
+};
+
+} // namespace
+
+TEMPLATE_TEST_CASE("Async stack depth", "[async_stack][template]", unit_pool, busy_pool, lazy_pool) {
+
+  std::array<std::coroutine_handle<>, 1> buf{};
+
+  // Not a worker.
+  REQUIRE(current_task_stack(buf).empty());
+
+  for (int n = 0; n < 10; ++n) {
+#ifdef LF_ASYNC_STACK
+    REQUIRE(sync_wait(TestType{}, depth, n) == n + 1);
+#else
+    REQUIRE(sync_wait(TestType{}, depth, n) == 0);
+#endif
+  }
+}
+
+#if defined(LF_ASYNC_STACK) && defined(__unix__)
+
+  #include <sstream> // for ostringstream, istringstream
+
+// !BEGIN-EXAMPLE
+
+  #include <algorithm>  // for min
+  #include <atomic>     // for atomic, memory_order_relaxed
+  #include <csignal>    // for sigaction, SIGPROF
+  #include <cstdio>     // for snprintf
+  #include <map>        // for map
+  #include <ostream>    // for ostream
+  #include <span>       // for span
+  #include <string>     // for string, getline, stoul
+  #include <sys/time.h> // for setitimer, ITIMER_PROF
+
+  #include "libfork/core.hpp"     // for current_task_stack
+  #include "libfork/schedule.hpp" // for lazy_pool
+
+namespace {
+
+// A poor man's sampling profiler that records logical task stacks in a SIGPROF handler.
+
+constexpr std::size_t max_depth = 32;
+constexpr std::size_t max_samples = 1 << 14;
+
+struct sample {
+  std::size_t size;
+  std::array<void *, max_depth> pcs;
+  std::array<void *, max_depth> frames;
+};
+
+std::array<sample, max_samples> samples; // NOLINT
+std::atomic<std::size_t> num_samples = 0;
+
+extern "C" void on_sigprof(int /* signal */) {
+
+  std::array<std::coroutine_handle<>, max_depth> buf;
+
+  std::span stack = lf::current_task_stack(buf);
+
+  if (stack.empty()) {
+    return; // Not in a task.
+  }
+
+  std::size_t idx = num_samples.fetch_add(1, std::memory_order_relaxed);
+
+  if (idx >= max_samples) {
+    return;
+  }
+
+  samples[idx].size = stack.size();
+
+  for (std::size_t i = 0; i < stack.size(); ++i) {
+    // The first word of a coroutine frame is the address of its resume function, this identifies the task.
+    samples[idx].pcs[i] = *static_cast<void **>(stack[i].address());
+    samples[idx].frames[i] = stack[i].address();
+  }
+}
+
+inline constexpr auto work = [](auto work, int n) -> lf::task<int> {
+  if (n < 2) {
+    co_return n;
+  }
+  int a = 0;
+  int b = 0;
+  co_await lf::fork(&a, work)(n - 1);
+  co_await lf::call(&b, work)(n - 2);
+  co_await lf::join;
+  co_return a + b;
+};
+
+inline constexpr auto root = [](auto, int n) -> lf::task<int> {
+  int r = 0;
+  co_await lf::call(&r, work)(n);
+  co_await lf::join;
+  co_return r;
+};
+
+/**
+ * @brief Profile `root(n)` and write "folded" stacks (root first) to `out`, returns the number of samples.
+ *
+ * Each line is a ``;`` separated list of resume-function addresses and a count. Symbolize them (e.g. with
+ * addr2line or dladdr) and feed them to flamegraph.pl, or convert them to pprof's format, to view a profile
+ * of logical task call stacks. Alternatively, a perf/eBPF agent can call ``current_task_stack`` instead.
+ */
+auto profile(int n, std::ostream &out) -> std::size_t {
+
+  struct sigaction action = {};
+  struct sigaction previous = {};
+
+  action.sa_handler = on_sigprof;
+  action.sa_flags = SA_RESTART;
+
+  sigaction(SIGPROF, &action, &previous);
+
+  num_samples = 0;
+
+  itimerval timer = {{0, 1000}, {0, 1000}}; // Sample every 1ms of CPU time.
+  setitimer(ITIMER_PROF, &timer, nullptr);
+
+  lf::lazy_pool pool{};
+
+  for (int i = 0; i < 100 && num_samples.load() < 16; ++i) {
+    lf::sync_wait(pool, root, n);
+  }
+
+  itimerval stop = {};
+  setitimer(ITIMER_PROF, &stop, nullptr);
+
+  sigaction(SIGPROF, &previous, nullptr);
+
+  std::map<std::string, int> folded;
+
+  std::size_t count = std::min(num_samples.load(), max_samples);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    std::string line;
+    for (std::size_t j = samples[i].size; j-- > 0;) {
+      std::array<char, 32> hex{};
+      std::snprintf(hex.data(), hex.size(), "%p", samples[i].pcs[j]);
+      line += hex.data();
+      line += j == 0 ? "" : ";";
+    }
+    ++folded[line];
+  }
+
+  for (auto const &[line, hits] : folded) {
+    out << line << ' ' << hits << '\n';
+  }
+
+  return count;
+}
+
+} // namespace
+
+// !END-EXAMPLE
+
+TEST_CASE("Async stack sampling", "[async_stack]") {
+
+  constexpr int n = 30; // The deepest stack holds n tasks (plus the root), most samples are near the leaves.
+
+  constexpr std::size_t deepest_possible = n + 1;
+
+  std::ostringstream out;
+
+  std::size_t count = profile(n, out);
+
+  REQUIRE(count > 0);
+
+  bool consistent = true;
+  std::size_t deepest = 0;
+
+  void *root_pc = samples[0].pcs[samples[0].size - 1];
+  void *child_pc = nullptr;
+
+  for (std::size_t i = 0; i < count; ++i) {
+
+    sample const &elem = samples[i];
+
+    consistent = consistent && elem.size >= 1 && elem.size <= deepest_possible;
+
+    if (!consistent) {
+      break;
+    }
+
+    // Every chain ends at the root task, which appears nowhere else.
+    consistent = consistent && elem.pcs[elem.size - 1] == root_pc;
+
+    for (std::size_t j = 0; j + 1 < elem.size; ++j) {
+      consistent = consistent && elem.pcs[j] != root_pc;
+    }
+
+    // The parent of the root's child is the root, `work` tasks only reach it through that child. Forked
+    // and called `work` tasks are distinct instantiations hence, only this position has a fixed task.
+    if (elem.size >= 2) {
+      child_pc = child_pc == nullptr ? elem.pcs[elem.size - 2] : child_pc;
+      consistent = consistent && elem.pcs[elem.size - 2] == child_pc;
+    }
+
+    // A parent chain never revisits a frame.
+    for (std::size_t j = 0; j < elem.size; ++j) {
+      for (std::size_t k = j + 1; k < elem.size; ++k) {
+        consistent = consistent && elem.frames[j] != elem.frames[k];
+      }
+    }
+
+    deepest = std::max(deepest, elem.size);
+  }
+
+  REQUIRE(consistent);
+  REQUIRE(child_pc != nullptr);
+  REQUIRE(deepest > deepest_possible / 2);
+
+  // One folded line per distinct stack, each with a positive count.
+  std::size_t lines = 0;
+  std::size_t hits = 0;
+
+  std::istringstream in{out.str()};
+
+  for (std::string line; std::getline(in, line);) {
+    ++lines;
+    hits += std::stoul(line.substr(line.rfind(' ') + 1));
+  }
+
+  REQUIRE(lines > 0);
+  REQUIRE(hits == count);
+}
+
+#endif
@@ -6,7 +6,9 @@
 // License, v. 2.0. If a copy of the MPL was not distributed with this
 // file, You can obtain one at https://mozilla.org/MPL/2.0/.
 
+#include <algorithm>                     // for max, all_of
 #include <catch2/catch_test_macros.hpp> // for operator""_catch_sr, operator==, AssertionHandler
+#include <cstddef>                       // for size_t
 
 // !BEGIN-EXAMPLE
 
@@ -15,7 +17,7 @@
 #include <thread>   // for thread
 #include <vector>   // for vector
 
-#include "libfork/core.hpp" // for deque, err, steal_t, return_nullopt
+#include "libfork/core.hpp" // for deque, bounded_deque, err, steal_t, return_nullopt
 
 namespace {
 
@@ -179,4 +181,138 @@ TEST_CASE("Single producer + pop(), multiple consumer", "[deque]") {
   REQUIRE(remaining == 0);
 }
 
+TEST_CASE("Owner push/pop races multiple consumer", "[deque]") {
+
+#if defined(LF_ASYMMETRIC_FENCES) && defined(__linux__)
+  // Otherwise this silently tests the symmetric fences.
+  REQUIRE(lf::impl::asymmetric_fences());
+#endif
+
+  lf::deque<int> deque;
+
+  constexpr int max = 200000;
+  unsigned int nthreads = std::max(2U, std::thread::hardware_concurrency());
+
+  std::vector<std::atomic<int>> seen(max);
+  std::atomic<int> remaining(max);
+
+  auto consume = [&](int item) {
+    seen[static_cast<std::size_t>(item)].fetch_add(1);
+    remaining.fetch_sub(1);
+  };
+
+  std::vector<std::thread> threads;
+
+  for (unsigned int i = 0; i < nthreads; ++i) {
+    threads.emplace_back([&]() {
+      while (remaining.load() > 0) {
+        if (auto item = deque.steal()) {
+          consume(*item);
+        }
+      }
+    });
+  }
+
+  // Keep the deque almost empty such that most pops race a steal for the last item.
+  for (int i = 0; i < max; ++i) {
+    deque.push(i);
+    if (i % 2 == 1) {
+      if (std::optional item = deque.pop()) {
+        consume(*item);
+      }
+    }
+  }
+
+  while (std::optional item = deque.pop()) {
+    consume(*item);
+  }
+
+  for (auto &thr : threads) {
+    thr.join();
+  }
+
+  REQUIRE(remaining == 0);
+
+  REQUIRE(std::ranges::all_of(seen, [](std::atomic<int> const &count) {
+    return count.load() == 1;
+  }));
+}
+
+TEST_CASE("Bounded deque", "[deque]") {
+
+  lf::bounded_deque<int, 8> deque;
+
+  REQUIRE(deque.empty());
+  REQUIRE(deque.capacity() == 8);
+
+  // Wrap around the buffer a few times.
+  for (int round = 0; round < 5; ++round) {
+
+    for (int i = 0; i < 8; ++i) {
+      REQUIRE(deque.push(i));
+    }
+
+    REQUIRE(!deque.push(8));
+    REQUIRE(deque.ssize() == 8);
+
+    // Thieves see a queue, the owner sees a stack.
+    REQUIRE(*deque.steal() == 0);
+    REQUIRE(*deque.steal() == 1);
+
+    for (int i = 7; i >= 2; --i) {
+      REQUIRE(deque.pop() == i);
+    }
+
+    REQUIRE(!deque.pop());
+    REQUIRE(deque.steal().code == lf::err::empty);
+  }
+}
+
+TEST_CASE("Bounded deque, multiple consumer", "[deque]") {
+
+  lf::bounded_deque<int, 64> deque;
+
+  constexpr int max = 100000;
+  unsigned int nthreads = std::thread::hardware_concurrency();
+
+  std::vector<std::thread> threads;
+  std::atomic<int> remaining(max);
+  std::atomic<long> sum = 0;
+
+  for (unsigned int i = 0; i < nthreads; ++i) {
+    threads.emplace_back([&]() {
+      while (remaining.load() > 0) {
+        if (auto item = deque.steal()) {
+          sum.fetch_add(*item);
+          remaining.fetch_sub(1);
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < max; ++i) {
+    // When full the owner consumes one itself.
+    while (!deque.push(i)) {
+      if (std::optional item = deque.pop()) {
+        sum.fetch_add(*item);
+        remaining.fetch_sub(1);
+      }
+    }
+  }
+
+  while (remaining.load() > 0) {
+    if (std::optional item = deque.pop()) {
+      sum.fetch_add(*item);
+      remaining.fetch_sub(1);
+    }
+  }
+
+  for (auto &thr : threads) {
+    thr.join();
+  }
+
+  REQUIRE(remaining == 0);
+  REQUIRE(sum == long{max} * (max - 1) / 2);
+}
+
 // NOLINTEND
\ No newline at end of file
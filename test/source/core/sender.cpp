@@ -0,0 +1,205 @@
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <catch2/catch_template_test_macros.hpp> // for TEMPLATE_TEST_CASE
+#include <catch2/catch_test_macros.hpp>          // for REQUIRE
+#include <exception>                             // for exception_ptr, rethrow_exception
+#include <optional>                              // for optional
+#include <semaphore>                             // for binary_semaphore
+#include <stdexcept>                             // for runtime_error
+#include <thread>                                // for thread, this_thread
+#include <utility>                               // for move
+
+#include "libfork/core.hpp"     // for task, fork, call, join, as_sender
+#include "libfork/schedule.hpp" // for lazy_pool, busy_pool
+
+using namespace lf;
+
+namespace {
+
+inline constexpr auto fib = [](auto fib, int n) -> task<int> {
+  //
+  if (n < 2) {
+    co_return n;
+  }
+
+  int a = 0;
+  int b = 0;
+
+  co_await lf::fork(&a, fib)(n - 1);
+  co_await lf::call(&b, fib)(n - 2);
+
+  co_await lf::join;
+
+  co_return a + b;
+};
+
+inline constexpr auto fail = [](auto) -> task<int> {
+  throw std::runtime_error("fail");
+  co_return 0;
+};
+
+/**
+ * @brief Where a receiver writes its completion.
+ */
+template <typename T>
+struct outcome {
+  std::optional<T> value;
+  std::exception_ptr error;
+  std::thread::id where;
+  std::binary_semaphore done{0};
+};
+
+template <typename T>
+struct receiver {
+
+  using receiver_concept = impl::exec::receiver_t;
+
+  void set_value(T val) && noexcept {
+    out->value = std::move(val);
+    out->where = std::this_thread::get_id();
+    out->done.release();
+  }
+
+  void set_error(std::exception_ptr err) && noexcept {
+    out->error = std::move(err);
+    out->done.release();
+  }
+
+  void set_stopped() && noexcept { out->done.release(); }
+
+  outcome<T> *out;
+};
+
+struct unit {};
+
+template <>
+struct receiver<unit> {
+
+  using receiver_concept = impl::exec::receiver_t;
+
+  void set_value() && noexcept {
+    out->value = unit{};
+    out->where = std::this_thread::get_id();
+    out->done.release();
+  }
+
+  void set_error(std::exception_ptr err) && noexcept {
+    out->error = std::move(err);
+    out->done.release();
+  }
+
+  void set_stopped() && noexcept { out->done.release(); }
+
+  outcome<unit> *out;
+};
+
+/**
+ * @brief Starts a second operation from the worker that completes the first.
+ */
+template <typename Op>
+struct chain {
+
+  using receiver_concept = impl::exec::receiver_t;
+
+  void set_value(int val) && noexcept {
+    out->value = val;
+    next->start();
+  }
+
+  void set_error(std::exception_ptr err) && noexcept {
+    out->error = std::move(err);
+    out->done.release();
+  }
+
+  void set_stopped() && noexcept { out->done.release(); }
+
+  Op *next;
+  outcome<int> *out;
+};
+
+} // namespace
+
+TEMPLATE_TEST_CASE("Sender runs a root", "[sender][template]", lazy_pool, busy_pool) {
+
+  TestType pool{2};
+
+  for (int i = 0; i < 20; ++i) {
+
+    outcome<int> out;
+
+    auto op = as_sender(pool, fib, 20).connect(receiver<int>{&out});
+
+    op.start();
+    out.done.acquire();
+
+    REQUIRE(out.value == 6765);
+    REQUIRE(out.error == nullptr);
+    REQUIRE(out.where != std::this_thread::get_id());
+  }
+}
+
+TEMPLATE_TEST_CASE("Sender forwards exceptions", "[sender][template]", lazy_pool, busy_pool) {
+
+  TestType pool{2};
+
+  outcome<int> out;
+
+  auto op = as_sender(pool, fail).connect(receiver<int>{&out});
+
+  op.start();
+  out.done.acquire();
+
+  REQUIRE(!out.value);
+  REQUIRE(out.error != nullptr);
+  REQUIRE_THROWS_AS(std::rethrow_exception(out.error), std::runtime_error);
+}
+
+TEMPLATE_TEST_CASE("Scheduler completes on a worker", "[sender][template]", lazy_pool, busy_pool) {
+
+  TestType pool{2};
+
+  auto sch = pool.get_scheduler();
+
+  REQUIRE(sch == pool.get_scheduler());
+
+  outcome<unit> out;
+
+  auto sender = sch.schedule();
+
+  REQUIRE(sender.get_env().query(impl::exec::get_completion_scheduler_t<impl::exec::set_value_t>{}) == sch);
+
+  auto op = sender.connect(receiver<unit>{&out});
+
+  op.start();
+  out.done.acquire();
+
+  REQUIRE(out.value);
+  REQUIRE(out.where != std::this_thread::get_id());
+}
+
+TEMPLATE_TEST_CASE("Sender can be started by a worker", "[sender][template]", lazy_pool, busy_pool) {
+
+  TestType pool{2};
+
+  for (int i = 0; i < 20; ++i) {
+
+    outcome<int> first;
+    outcome<int> second;
+
+    auto next = as_sender(pool, fib, 15).connect(receiver<int>{&second});
+
+    auto op = as_sender(pool, fib, 20).connect(chain<decltype(next)>{&next, &first});
+
+    op.start();
+    second.done.acquire();
+
+    REQUIRE(first.value == 6765);
+    REQUIRE(second.value == 610);
+  }
+}
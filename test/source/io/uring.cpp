@@ -0,0 +1,178 @@
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#if __has_include(<linux/io_uring.h>)
+
+  #include <array>                        // for array
+  #include <catch2/catch_test_macros.hpp> // for REQUIRE, TEST_CASE, WARN
+  #include <chrono>                       // for nanoseconds
+  #include <cstddef>                      // for byte, size_t
+  #include <cstdlib>                      // for mkstemp
+  #include <memory>                       // for unique_ptr, make_unique
+  #include <span>                         // for span
+  #include <system_error>                 // for system_error
+  #include <unistd.h>                     // for close, unlink
+  #include <vector>                       // for vector
+
+  #include "libfork/core.hpp"     // for task, fork, call, join, sync_wait
+  #include "libfork/io.hpp"       // for uring, read, write
+  #include "libfork/schedule.hpp" // for lazy_pool, numa_strategy
+
+using namespace lf;
+
+namespace {
+
+inline constexpr std::size_t k_block = 512;
+
+using block = std::array<std::byte, k_block>;
+
+/**
+ * @brief Write `blocks` in parallel, block `i` to offset `(first + i) * k_block`, returns the bytes written.
+ */
+inline constexpr auto write_all = [](auto self, io::uring *ring, int fd, std::span<block const> blocks,
+                                     std::size_t first) -> task<std::size_t> {
+  //
+  if (blocks.size() == 1) {
+    co_return co_await io::write(*ring, fd, blocks[0], first * k_block);
+  }
+
+  std::size_t half = blocks.size() / 2;
+
+  std::size_t a = 0;
+  std::size_t b = 0;
+
+  co_await lf::fork(&a, self)(ring, fd, blocks.first(half), first);
+  co_await lf::call(&b, self)(ring, fd, blocks.subspan(half), first + half);
+
+  co_await lf::join;
+
+  co_return a + b;
+};
+
+/**
+ * @brief Read blocks `[begin, end)` in parallel and count the bytes that hold their expected value.
+ */
+inline constexpr auto read_all = [](auto self, io::uring *ring, int fd, std::size_t begin, std::size_t end)
+    -> task<std::size_t> {
+  //
+  if (end - begin == 1) {
+
+    block buf{};
+
+    std::size_t n = co_await io::read(*ring, fd, buf, begin * k_block);
+
+    std::size_t ok = 0;
+
+    for (std::size_t i = 0; i < n; ++i) {
+      ok += static_cast<std::size_t>(buf[i] == std::byte(begin * k_block + i));
+    }
+
+    co_return ok;
+  }
+
+  std::size_t mid = begin + (end - begin) / 2;
+
+  std::size_t a = 0;
+  std::size_t b = 0;
+
+  co_await lf::fork(&a, self)(ring, fd, begin, mid);
+  co_await lf::call(&b, self)(ring, fd, mid, end);
+
+  co_await lf::join;
+
+  co_return a + b;
+};
+
+inline constexpr auto read_bad = [](auto, io::uring *ring) -> task<bool> {
+  //
+  block buf{};
+
+  try {
+    co_await io::read(*ring, -1, buf, 0);
+  } catch (std::system_error const &) {
+    co_return true;
+  }
+
+  co_return false;
+};
+
+/**
+ * @brief Make a ring, null if the kernel forbids io_uring.
+ */
+auto make_ring() -> std::unique_ptr<io::uring> {
+  try {
+    return std::make_unique<io::uring>(64);
+  } catch (std::system_error const &) {
+    return nullptr;
+  }
+}
+
+} // namespace
+
+TEST_CASE("io_uring reads and writes", "[io]") {
+
+  auto ring = make_ring();
+
+  if (!ring) {
+    WARN("io_uring unavailable, skipping");
+    return;
+  }
+
+  char path[] = "/tmp/libfork_uring_XXXXXX";
+
+  int fd = mkstemp(path);
+
+  REQUIRE(fd >= 0);
+
+  unlink(path);
+
+  constexpr std::size_t n = 64;
+
+  std::vector<block> blocks(n);
+
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t j = 0; j < k_block; ++j) {
+      blocks[i][j] = std::byte(i * k_block + j);
+    }
+  }
+
+  lazy_pool pool{4, numa_strategy::fan, {.events = ring.get()}};
+
+  std::span<block const> all = blocks;
+
+  REQUIRE(sync_wait(pool, write_all, ring.get(), fd, all, std::size_t{0}) == n * k_block);
+  REQUIRE(sync_wait(pool, read_all, ring.get(), fd, std::size_t{0}, n) == n * k_block);
+
+  REQUIRE(sync_wait(pool, read_bad, ring.get()));
+
+  REQUIRE(ring->in_flight() == 0);
+
+  close(fd);
+}
+
+TEST_CASE("io_uring wake-ups are sticky", "[io]") {
+
+  auto ring = make_ring();
+
+  if (!ring) {
+    WARN("io_uring unavailable, skipping");
+    return;
+  }
+
+  // Nothing to do and not woken.
+  REQUIRE(ring->poll(std::chrono::nanoseconds::zero()) == 0);
+  REQUIRE(ring->poll(std::chrono::nanoseconds{1'000'000}) == 0);
+
+  // A wake-up before the poll must not be lost, else this blocks forever.
+  ring->wake();
+  ring->wake();
+
+  REQUIRE(ring->poll(std::chrono::nanoseconds{-1}) == 0);
+}
+
+#endif
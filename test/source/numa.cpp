@@ -8,16 +8,22 @@
 // License, v. 2.0. If a copy of the MPL was not distributed with this
 // file, You can obtain one at https://mozilla.org/MPL/2.0/.
 
+#include <algorithm>                    // for max
 #include <catch2/catch_test_macros.hpp> // for operator==, operator""_catch_sr, AssertionHandler
 #include <cstddef>                      // for size_t
+#include <cstdio>                       // for remove
+#include <cstring>                      // for memcmp
+#include <filesystem>                   // for path, create_directories, remove_all, temp_directory_path
+#include <fstream>                      // for ofstream
 #include <iostream>                     // for basic_ostream, char_traits, operator<<, cout
 #include <memory>                       // for shared_ptr, __shared_ptr_access, make_shared
 #include <set>                          // for set
+#include <string>                       // for string
 #include <thread>                       // for thread
 #include <utility>                      // for move
 #include <vector>                       // for vector
 
-#include "libfork/schedule.hpp" // for distance_matrix, numa_topology
+#include "libfork/schedule.hpp" // for distance_matrix, numa_topology, hwloc_error
 
 using namespace lf;
 
@@ -26,25 +32,68 @@ using namespace impl;
 TEST_CASE("make_topology", "[numa]") {
   for (int i = 0; i < 10; i++) {
     numa_topology topo = {};
-#ifdef LF_USE_HWLOC
-    REQUIRE(topo);
-#else
-    REQUIRE(!topo);
-#endif
+    REQUIRE(static_cast<bool>(topo) == numa_support());
   }
 }
 
-#ifdef LF_USE_HWLOC
+#if defined(LF_USE_HWLOC) || defined(LF_USE_SYSFS)
 
 namespace {
 
 struct comp {
   auto operator()(numa_topology::numa_handle const &lhs,
                   numa_topology::numa_handle const &rhs) const noexcept -> bool {
+  #ifdef LF_USE_HWLOC
     return hwloc_bitmap_compare(lhs.cpup.get(), rhs.cpup.get()) < 0;
+  #else
+    return std::memcmp(lhs.cpup.get(), rhs.cpup.get(), sizeof(cpu_set_t)) < 0;
+  #endif
   }
 };
 
+/**
+ * @brief Count the distinct numa nodes in a split.
+ */
+auto count_numa(std::vector<numa_topology::numa_handle> const &handles) -> std::size_t {
+
+  std::set<std::size_t> numa;
+
+  for (auto const &handle : handles) {
+    numa.insert(handle.numa);
+  }
+
+  return numa.size();
+}
+
+/**
+ * @brief Get the processing unit a singlet handle is bound to.
+ */
+auto cpu_of(numa_topology::numa_handle const &handle) -> unsigned int {
+  #ifdef LF_USE_HWLOC
+  return static_cast<unsigned int>(hwloc_bitmap_first(handle.cpup.get()));
+  #else
+  for (unsigned int i = 0;; i++) {
+    if (CPU_ISSET_S(i, handle.cpup.get_deleter().bytes, handle.cpup.get())) {
+      return i;
+    }
+  }
+  #endif
+}
+
+/**
+ * @brief Map a split to the processing units it is bound to.
+ */
+auto cpus_of(std::vector<numa_topology::numa_handle> const &handles) -> std::vector<unsigned int> {
+
+  std::vector<unsigned int> cpus;
+
+  for (auto const &handle : handles) {
+    cpus.push_back(cpu_of(handle));
+  }
+
+  return cpus;
+}
+
 } // namespace
 
 TEST_CASE("split", "[numa]") {
@@ -117,6 +166,389 @@ TEST_CASE("distances", "[numa]") {
 
 #endif
 
+#ifdef LF_USE_HWLOC
+
+TEST_CASE("synthetic", "[numa]") {
+
+  REQUIRE(numa_topology{}.is_this_system());
+
+  // A 4-socket, 8 numa node machine with 64 cores and 128 PUs.
+  numa_topology topo = numa_topology::from_synthetic("pack:4 numa:2 core:8 pu:2");
+
+  REQUIRE(topo);
+  REQUIRE(!topo.is_this_system());
+
+  // Sequential fills the first socket.
+  REQUIRE(count_numa(topo.split(16, numa_strategy::seq)) == 2);
+  // Fan spreads over the whole machine.
+  REQUIRE(count_numa(topo.split(16, numa_strategy::fan)) == 8);
+
+  std::vector handles = topo.split(64, numa_strategy::fan);
+
+  // Binding to an imaginary machine is a noop.
+  for (auto const &handle : handles) {
+    handle.bind();
+  }
+
+  impl::detail::distance_matrix dist{handles};
+
+  // PU -> core -> numa -> package -> machine.
+  int max = 0;
+
+  for (std::size_t i = 0; i < dist.size(); i++) {
+    for (std::size_t j = 0; j < dist.size(); j++) {
+      max = std::max(max, dist(i, j));
+    }
+  }
+
+  REQUIRE(max == 4);
+
+  // Victims are grouped by distance: self, SMT sibling, numa node, package, everyone else.
+  std::vector<std::shared_ptr<int>> ints;
+
+  for (int i = 0; i < 128; i++) {
+    ints.push_back(std::make_shared<int>(i));
+  }
+
+  for (auto &&node : topo.distribute(ints, numa_strategy::fan)) {
+    REQUIRE(node.neighbors.size() == 5);
+    REQUIRE(node.neighbors[1].size() == 1);
+    REQUIRE(node.neighbors[2].size() == 14);
+    REQUIRE(node.neighbors[3].size() == 16);
+    REQUIRE(node.neighbors[4].size() == 96);
+  }
+
+  REQUIRE_THROWS_AS(numa_topology::from_synthetic("not a topology"), hwloc_error);
+}
+
+TEST_CASE("cpu selection", "[numa]") {
+
+  // PUs 2i and 2i + 1 are SMT siblings, each numa node has 16 PUs.
+  numa_topology topo = numa_topology::from_synthetic("pack:4 numa:2 core:8 pu:2");
+
+  cpu_selection first_node;
+
+  for (unsigned int i = 0; i < 16; i++) {
+    first_node.exclude.push_back(i);
+  }
+
+  for (auto strategy : {numa_strategy::fan, numa_strategy::seq, numa_strategy::physical_cores_only}) {
+    for (unsigned int cpu : cpus_of(topo.split(40, strategy, first_node))) {
+      REQUIRE(cpu >= 16);
+    }
+  }
+
+  // Sequential now fills the remainder of the first package.
+  REQUIRE(count_numa(topo.split(8, numa_strategy::seq, first_node)) == 1);
+
+  // One PU per physical core, until the cores run out.
+  std::vector cores = cpus_of(topo.split(64, numa_strategy::physical_cores_only));
+
+  REQUIRE(std::set(cores.begin(), cores.end()).size() == 64);
+
+  for (unsigned int cpu : cores) {
+    REQUIRE(cpu % 2 == 0);
+  }
+
+  // Explicit cpus are used in order and wrap around.
+  cpu_selection pinned{.cpus = {3, 70, 9}};
+
+  std::vector<unsigned int> expect{3, 70, 9, 3, 70};
+
+  REQUIRE(cpus_of(topo.split(5, numa_strategy::explicit_cpus, pinned)) == expect);
+
+  REQUIRE_THROWS_AS(topo.split(1, numa_strategy::explicit_cpus), hwloc_error);
+  REQUIRE_THROWS_AS(topo.split(1, numa_strategy::explicit_cpus, {.cpus = {128}}), hwloc_error);
+  REQUIRE_THROWS_AS(topo.split(1, numa_strategy::explicit_cpus, {{3}, {3}}), hwloc_error);
+
+  // Neighbors reflect the selection: no SMT siblings, 7 cores in the numa node, 8 in the package.
+  std::vector<std::shared_ptr<int>> ints;
+
+  for (int i = 0; i < 64; i++) {
+    ints.push_back(std::make_shared<int>(i));
+  }
+
+  for (auto &&node : topo.distribute(ints, numa_strategy::physical_cores_only)) {
+    REQUIRE(node.neighbors.size() == 4);
+    REQUIRE(node.neighbors[1].size() == 7);
+    REQUIRE(node.neighbors[2].size() == 8);
+    REQUIRE(node.neighbors[3].size() == 48);
+  }
+
+  cpu_selection everything;
+
+  for (unsigned int i = 0; i < 128; i++) {
+    everything.exclude.push_back(i);
+  }
+
+  REQUIRE_THROWS_AS(topo.split(1, numa_strategy::fan, everything), hwloc_error);
+}
+
+TEST_CASE("cpu kinds", "[numa]") {
+
+  // Homogeneous machines have a single class.
+  for (auto const &handle : numa_topology::from_synthetic("pack:2 core:4 pu:2").split(16)) {
+    REQUIRE(handle.efficiency == 0);
+  }
+
+  // A hybrid machine: the first package has fast cores, the second slow ones.
+  numa_topology topo = numa_topology::from_synthetic("pack:2 core:4 pu:2", {{8, 9, 10, 11, 12, 13, 14, 15},
+                                                                            {0, 1, 2, 3, 4, 5, 6, 7}});
+
+  for (auto const &handle : topo.split(16)) {
+    REQUIRE(handle.efficiency == (cpu_of(handle) < 8 ? 1 : 0));
+  }
+
+  std::vector<std::shared_ptr<int>> ints;
+
+  for (int i = 0; i < 8; i++) {
+    ints.push_back(std::make_shared<int>(i));
+  }
+
+  std::vector nodes = topo.distribute(ints);
+
+  for (auto const &node : nodes) {
+    REQUIRE(node.handicap == (cpu_of(node) < 8 ? 0 : 1));
+  }
+
+  REQUIRE(root_workers(nodes, false).size() == 8);
+
+  for (std::size_t i : root_workers(nodes, true)) {
+    REQUIRE(nodes[i].handicap == 0);
+  }
+
+  REQUIRE(root_workers(nodes, true).size() == 4);
+
+  // Only slow cores, nobody is handicapped.
+  for (auto const &node : topo.distribute(ints, numa_strategy::fan, {.exclude = {0, 1, 2, 3, 4, 5, 6, 7}})) {
+    REQUIRE(node.efficiency == 0);
+    REQUIRE(node.handicap == 0);
+  }
+}
+
+TEST_CASE("xml", "[numa]") {
+
+  std::string path = "libfork_numa_test.xml";
+
+  {
+    // Export via hwloc directly, a real user would use lstopo on the target machine.
+    hwloc_topology *raw = nullptr;
+    REQUIRE(hwloc_topology_init(&raw) == 0);
+    REQUIRE(hwloc_topology_set_synthetic(raw, "pack:2 numa:2 core:4 pu:1") == 0);
+    REQUIRE(hwloc_topology_load(raw) == 0);
+    REQUIRE(hwloc_topology_export_xml(raw, path.c_str(), 0) == 0);
+    hwloc_topology_destroy(raw);
+  }
+
+  numa_topology loaded = numa_topology::from_xml(path);
+
+  std::remove(path.c_str());
+
+  REQUIRE(loaded);
+  REQUIRE(!loaded.is_this_system());
+  REQUIRE(count_numa(loaded.split(16, numa_strategy::fan)) == 4);
+  REQUIRE(count_numa(loaded.split(4, numa_strategy::seq)) == 2);
+
+  REQUIRE_THROWS_AS(numa_topology::from_xml("/does/not/exist.xml"), hwloc_error);
+}
+
+#endif
+
+#ifdef LF_USE_SYSFS
+
+namespace {
+
+void write(std::filesystem::path const &path, std::string const &content) {
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream{path} << content << '\n';
+}
+
+/**
+ * @brief Fake a 2 package machine with 2 cores per package and 2 threads per core, L2 is per core.
+ *
+ * The cores in the first package are bigger.
+ */
+auto fake_sysfs() -> std::filesystem::path {
+
+  auto root = std::filesystem::temp_directory_path() / "libfork_fake_sysfs";
+
+  std::filesystem::remove_all(root);
+
+  write(root / "cpu/online", "0-7");
+  write(root / "node/node0/cpulist", "0-1,4-5");
+  write(root / "node/node1/cpulist", "2-3,6-7");
+
+  // Linux numbers the first thread of every core first, cpu i and i + 4 are siblings.
+  for (int i = 0; i < 8; i++) {
+
+    auto cpu = root / ("cpu/cpu" + std::to_string(i));
+
+    int core = i % 4;
+    int pack = core / 2;
+
+    std::string siblings = std::to_string(core) + "," + std::to_string(core + 4);
+    std::string package = std::to_string(2 * pack) + "-" + std::to_string(2 * pack + 1) + "," +
+                          std::to_string(2 * pack + 4) + "-" + std::to_string(2 * pack + 5);
+
+    write(cpu / "topology/physical_package_id", std::to_string(pack));
+    write(cpu / "cpu_capacity", pack == 0 ? "1024" : "512");
+    write(cpu / "topology/core_cpus_list", siblings);
+
+    write(cpu / "cache/index0/level", "1");
+    write(cpu / "cache/index0/type", "Data");
+    write(cpu / "cache/index0/shared_cpu_list", siblings);
+    write(cpu / "cache/index1/level", "2");
+    write(cpu / "cache/index1/type", "Unified");
+    write(cpu / "cache/index1/shared_cpu_list", siblings);
+    write(cpu / "cache/index2/level", "3");
+    write(cpu / "cache/index2/type", "Unified");
+    write(cpu / "cache/index2/shared_cpu_list", package);
+  }
+
+  return root;
+}
+
+} // namespace
+
+TEST_CASE("sysfs list", "[numa]") {
+  REQUIRE(sysfs::parse_list("0-3,8,10-11\n") == std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+  REQUIRE(sysfs::parse_list("5") == std::vector<int>{5});
+  REQUIRE(sysfs::parse_list("").empty());
+}
+
+TEST_CASE("sysfs", "[numa]") {
+
+  REQUIRE(numa_topology{}.is_this_system());
+
+  auto root = fake_sysfs();
+
+  numa_topology topo = numa_topology::from_sysfs(root.string());
+
+  REQUIRE(topo);
+  REQUIRE(!topo.is_this_system());
+
+  // Fan spreads over packages, sequential fills the first package.
+  REQUIRE(count_numa(topo.split(2, numa_strategy::fan)) == 2);
+  REQUIRE(count_numa(topo.split(2, numa_strategy::seq)) == 1);
+  REQUIRE(count_numa(topo.split(3, numa_strategy::seq)) == 2);
+
+  // Fan uses every core before any SMT sibling.
+  std::set<numa_topology::numa_handle, comp> unique;
+
+  for (auto &&handle : topo.split(4, numa_strategy::fan)) {
+    handle.bind(); // A noop.
+    unique.emplace(std::move(handle));
+  }
+
+  REQUIRE(unique.size() == 4);
+
+  std::vector<std::shared_ptr<int>> ints;
+
+  for (int i = 0; i < 8; i++) {
+    ints.push_back(std::make_shared<int>(i));
+  }
+
+  // Self, SMT sibling, the other core in the package, the other package.
+  for (auto &&node : topo.distribute(ints)) {
+    REQUIRE(node.neighbors.size() == 4);
+    REQUIRE(node.neighbors[1].size() == 1);
+    REQUIRE(node.neighbors[2].size() == 2);
+    REQUIRE(node.neighbors[3].size() == 4);
+  }
+
+  // Physical cores are the first sibling of each core.
+  std::vector cores = cpus_of(topo.split(4, numa_strategy::physical_cores_only));
+
+  REQUIRE(std::set(cores.begin(), cores.end()) == std::set<unsigned int>{0, 1, 2, 3});
+
+  REQUIRE(cpus_of(topo.split(2, numa_strategy::explicit_cpus, {.cpus = {5, 2}})) ==
+          std::vector<unsigned int>{5, 2});
+
+  // Excluding the first threads of each core leaves the siblings.
+  cpu_selection siblings{.exclude = {0, 1, 2, 3}};
+
+  for (unsigned int cpu : cpus_of(topo.split(8, numa_strategy::fan, siblings))) {
+    REQUIRE(cpu >= 4);
+  }
+
+  // The first package has the bigger cores.
+  for (auto const &node : topo.distribute(ints)) {
+    bool big = cpu_of(node) % 4 < 2;
+    REQUIRE(node.efficiency == (big ? 1 : 0));
+    REQUIRE(node.handicap == (big ? 0 : 1));
+  }
+
+  REQUIRE_THROWS_AS(topo.split(1, numa_strategy::explicit_cpus, {.cpus = {9}}), hwloc_error);
+  REQUIRE_THROWS_AS(topo.split(1, numa_strategy::explicit_cpus, {{1}, {1}}), hwloc_error);
+
+  std::filesystem::remove_all(root);
+
+  REQUIRE_THROWS_AS(numa_topology::from_sysfs(root.string()), hwloc_error);
+}
+
+TEST_CASE("sysfs beyond CPU_SETSIZE", "[numa]") {
+
+  auto root = std::filesystem::temp_directory_path() / "libfork_fake_sysfs_large";
+
+  std::filesystem::remove_all(root);
+
+  // Nothing but the online cpus, everything else takes its default.
+  write(root / "cpu/online", std::to_string(CPU_SETSIZE) + "-" + std::to_string(CPU_SETSIZE + 1));
+
+  numa_topology topo = numa_topology::from_sysfs(root.string());
+
+  auto big = static_cast<unsigned int>(CPU_SETSIZE);
+
+  REQUIRE(std::set<unsigned int>{big, big + 1} == [&] {
+    std::vector cpus = cpus_of(topo.split(2));
+    return std::set(cpus.begin(), cpus.end());
+  }());
+
+  std::vector<std::shared_ptr<int>> ints{std::make_shared<int>(0), std::make_shared<int>(1)};
+
+  for (auto &&node : topo.distribute(ints)) {
+    node.bind(); // A noop.
+    REQUIRE(node.neighbors.size() == 2);
+  }
+
+  std::filesystem::remove_all(root);
+}
+
+TEST_CASE("sysfs topologies are not restricted to the loading thread", "[numa]") {
+
+  cpu_set_t mask;
+
+  REQUIRE(sched_getaffinity(0, sizeof(mask), &mask) == 0);
+
+  auto allowed = static_cast<std::size_t>(CPU_COUNT(&mask));
+
+  unsigned int first = cpus_of(numa_topology{}.split(1))[0];
+
+  numa_topology loaded;
+  std::vector<unsigned int> pinned;
+
+  std::thread{[&] {
+    cpu_set_t one;
+    CPU_ZERO(&one);
+    CPU_SET(first, &one);
+
+    if (sched_setaffinity(0, sizeof(one), &one) == 0) {
+      loaded = numa_topology{};
+      pinned = cpus_of(loaded.split(2));
+    }
+  }}.join();
+
+  // A pinned thread only distributes over its own cpu.
+  REQUIRE(pinned == std::vector{first, first});
+
+  // But, the topology it loaded can use every cpu we are allowed on.
+  std::vector cpus = cpus_of(loaded.split(allowed));
+
+  REQUIRE(std::set(cpus.begin(), cpus.end()).size() == allowed);
+}
+
+#endif
+
 TEST_CASE("distribute", "[numa]") {
 
   for (unsigned int i = 1; i <= 2 * std::thread::hardware_concurrency(); i++) {
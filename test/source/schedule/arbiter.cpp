@@ -0,0 +1,164 @@
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <algorithm>                    // for max
+#include <atomic>                       // for atomic, memory_order_relaxed
+#include <catch2/catch_test_macros.hpp> // for REQUIRE, TEST_CASE, REQUIRE_THROWS_AS
+#include <chrono>                       // for steady_clock, seconds
+#include <cstddef>                      // for size_t
+#include <stdexcept>                    // for invalid_argument
+#include <thread>                       // for thread, yield
+
+#include "libfork/core.hpp"     // for task, fork, call, join, sync_wait, nullary_function_t
+#include "libfork/schedule.hpp" // for lazy_pool, busy_pool, thread_arbiter
+
+using namespace lf;
+
+namespace {
+
+/**
+ * @brief The most tokens held at once, sampled from within tasks.
+ */
+std::atomic<std::size_t> high_water = 0;
+
+inline constexpr auto fib = [](auto fib, int n, thread_arbiter *arb) -> task<int> {
+  //
+  if (n < 2) {
+    std::size_t now = arb->running();
+    for (std::size_t prev = high_water.load(std::memory_order_relaxed); now > prev;) {
+      if (high_water.compare_exchange_weak(prev, now, std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    co_return n;
+  }
+
+  int a = 0;
+  int b = 0;
+
+  co_await lf::fork(&a, fib)(n - 1, arb);
+  co_await lf::call(&b, fib)(n - 2, arb);
+
+  co_await lf::join;
+
+  co_return a + b;
+};
+
+/**
+ * @brief Wait (with a timeout) for all of the arbiter's tokens to be returned.
+ */
+auto drains(thread_arbiter const &arb) -> bool {
+
+  auto stop = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+  while (arb.running() != 0 || arb.parked() != 0) {
+    if (std::chrono::steady_clock::now() > stop) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+
+  return true;
+}
+
+} // namespace
+
+TEST_CASE("Arbiter rejects zero tokens", "[arbiter]") {
+  REQUIRE_THROWS_AS(thread_arbiter{0}, std::invalid_argument);
+}
+
+TEST_CASE("Busy pools reject an arbiter", "[arbiter]") {
+  thread_arbiter arb{1};
+  REQUIRE_THROWS_AS(busy_pool(1, numa_strategy::fan, {.arbiter = &arb}), std::invalid_argument);
+}
+
+TEST_CASE("Arbiter limits a single pool", "[arbiter]") {
+
+  thread_arbiter arb{1};
+
+  high_water = 0;
+
+  {
+    lazy_pool pool{8, numa_strategy::fan, {.arbiter = &arb}};
+
+    for (int i = 0; i < 10; ++i) {
+      REQUIRE(sync_wait(pool, fib, 20, &arb) == 6765);
+    }
+
+    REQUIRE(drains(arb));
+  }
+
+  // One token plus one borrowed to serve a submission, a previous root's token may not have been repaid.
+  REQUIRE(high_water <= 3);
+}
+
+TEST_CASE("Arbiter shares tokens between pools", "[arbiter]") {
+
+  thread_arbiter arb{2};
+
+  high_water = 0;
+
+  {
+    lazy_pool a{4, numa_strategy::fan, {.arbiter = &arb}};
+    lazy_pool b{4, numa_strategy::fan, {.arbiter = &arb}};
+
+    int res_a = 0;
+    int res_b = 0;
+
+    std::thread other{[&] {
+      for (int i = 0; i < 5; ++i) {
+        res_a = std::max(res_a, sync_wait(a, fib, 22, &arb));
+      }
+    }};
+
+    for (int i = 0; i < 5; ++i) {
+      res_b = std::max(res_b, sync_wait(b, fib, 22, &arb));
+    }
+
+    other.join();
+
+    REQUIRE(res_a == 17711);
+    REQUIRE(res_b == 17711);
+
+    REQUIRE(drains(arb));
+  }
+
+  // Two tokens plus one borrowed per pool and, possibly, an unpaid token from a previous root.
+  REQUIRE(high_water <= 5);
+}
+
+TEST_CASE("Arbiter hands out tokens that do not divide between pools", "[arbiter]") {
+
+  thread_arbiter arb{3};
+
+  thread_arbiter::client a{arb, nullary_function_t{[]() {}}};
+  thread_arbiter::client b{arb, nullary_function_t{[]() {}}};
+
+  // Both pools want more tokens than their share.
+  a.park();
+  b.park();
+
+  REQUIRE(a.try_acquire());
+  REQUIRE(b.try_acquire());
+
+  // Nobody is below their share hence, the last token is not left idle.
+  REQUIRE(a.try_acquire());
+  REQUIRE(!b.try_acquire());
+  REQUIRE(!a.should_yield());
+
+  REQUIRE(arb.running() == 3);
+
+  a.release();
+  a.release();
+  b.release();
+
+  a.unpark();
+  b.unpark();
+
+  REQUIRE(arb.running() == 0);
+}
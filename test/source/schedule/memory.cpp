@@ -0,0 +1,127 @@
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <catch2/catch_template_test_macros.hpp> // for TEMPLATE_TEST_CASE
+#include <catch2/catch_test_macros.hpp>          // for REQUIRE
+#include <cstddef>                               // for size_t
+
+#include "libfork/core.hpp"     // for task, fork, join, sync_wait, worker_memory
+#include "libfork/schedule.hpp" // for busy_pool, lazy_pool, numa_strategy
+
+using namespace lf;
+
+namespace {
+
+/**
+ * @brief Nest `n` forks such that (without thieves) the worker's deque holds `n` tasks.
+ */
+inline constexpr auto deep = [](auto deep, int n) -> task<int> {
+  //
+  if (n == 0) {
+    co_return 0;
+  }
+
+  int a = 0;
+
+  co_await lf::fork(&a, deep)(n - 1);
+  co_await lf::join;
+
+  co_return a + 1;
+};
+
+} // namespace
+
+TEMPLATE_TEST_CASE("Memory report", "[memory][template]", busy_pool, lazy_pool) {
+
+  // A single worker means no steals hence, a deterministic deque depth.
+  TestType sch{1};
+
+  auto before = sch.memory_report();
+
+  REQUIRE(before.size() == 1);
+  REQUIRE(before[0].stack_bytes > 0);
+  REQUIRE(before[0].deque_bytes > 0);
+  REQUIRE(before[0].deque_garbage_bytes == 0);
+
+  constexpr int depth = 5000;
+
+  REQUIRE(sync_wait(sch, deep, depth) == depth);
+
+  auto after = sch.memory_report();
+
+#ifdef LF_BOUNDED_DEQUE
+  // A bounded deque never grows, forks that overflow it run inline.
+  REQUIRE(after[0].deque_bytes == before[0].deque_bytes);
+  REQUIRE(after[0].deque_garbage_bytes == 0);
+#else
+  // Deque must have grown.
+  REQUIRE(after[0].deque_bytes > before[0].deque_bytes);
+  REQUIRE(after[0].deque_garbage_bytes > 0);
+#endif
+
+  // The stack must have grown to hold the frames.
+  REQUIRE(after[0].stack_high_water > before[0].stack_bytes);
+  REQUIRE(after[0].stack_high_water >= after[0].stack_bytes);
+
+  // The root has been collected.
+  REQUIRE(after[0].submit_backlog == 0);
+  REQUIRE(after[0].submit_high_water >= 1);
+}
+
+TEMPLATE_TEST_CASE("Warm up pre-faults", "[memory][template]", busy_pool, lazy_pool) {
+
+  TestType cold{1};
+  TestType warm{1, numa_strategy::fan, {.warm_up = true}};
+
+  // A warm worker caches a second stacklet.
+  REQUIRE(warm.memory_report()[0].stack_bytes > cold.memory_report()[0].stack_bytes);
+  REQUIRE(warm.memory_report()[0].deque_bytes == cold.memory_report()[0].deque_bytes);
+
+  REQUIRE(sync_wait(warm, deep, 100) == 100);
+}
+
+TEMPLATE_TEST_CASE("Memory report counts private deques", "[memory][template]", busy_pool, lazy_pool) {
+
+  TestType sch{1, numa_strategy::fan, {.private_deques = true}};
+
+  auto before = sch.memory_report();
+
+  REQUIRE(sync_wait(sch, deep, 5000) == 5000);
+
+  // Private tasks are never given away hence, the private deque must have grown.
+  REQUIRE(sch.memory_report()[0].deque_bytes > before[0].deque_bytes);
+}
+
+#ifdef LF_BOUNDED_DEQUE
+
+TEMPLATE_TEST_CASE("Bounded deque overflow", "[memory][template]", busy_pool, lazy_pool) {
+
+  // Forks past the capacity keep their parent in the worker's private overflow.
+  constexpr int depth = 4 * LF_BOUNDED_DEQUE;
+
+  for (std::size_t n = 1; n <= 4; ++n) {
+
+    TestType sch{n};
+
+    auto before = sch.memory_report();
+
+    // Repeat to interleave overflowing with thieves draining the bounded part.
+    for (int i = 0; i < 10; ++i) {
+      REQUIRE(sync_wait(sch, deep, depth) == depth);
+    }
+
+    auto after = sch.memory_report();
+
+    for (std::size_t i = 0; i < n; ++i) {
+      REQUIRE(after[i].deque_bytes == before[i].deque_bytes);
+      REQUIRE(after[i].deque_garbage_bytes == 0);
+    }
+  }
+}
+
+#endif
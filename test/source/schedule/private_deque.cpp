@@ -0,0 +1,181 @@
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <array>                                 // for array
+#include <atomic>                                // for atomic
+#include <catch2/catch_template_test_macros.hpp> // for TEMPLATE_TEST_CASE
+#include <catch2/catch_test_macros.hpp>          // for REQUIRE, TEST_CASE
+#include <cstddef>                               // for size_t
+#include <thread>                                // for thread, yield
+#include <vector>                                // for vector
+
+#include "libfork/core.hpp"     // for task, fork, call, join, sync_wait, worker_init, finalize, err
+#include "libfork/schedule.hpp" // for busy_pool, lazy_pool, numa_strategy, pool_options
+
+using namespace lf;
+
+namespace {
+
+inline constexpr auto fib = [](auto fib, int n) -> task<int> {
+  //
+  if (n < 2) {
+    co_return n;
+  }
+
+  int a = 0;
+  int b = 0;
+
+  co_await lf::fork(&a, fib)(n - 1);
+  co_await lf::call(&b, fib)(n - 2);
+
+  co_await lf::join;
+
+  co_return a + b;
+};
+
+/**
+ * @brief Distinct (never dereferenced) task handles.
+ */
+struct fake_tasks {
+
+  std::array<int, 3> storage{};
+
+  auto operator[](std::size_t i) -> task_handle { return reinterpret_cast<task_handle>(&storage[i]); }
+};
+
+auto noop() -> nullary_function_t {
+  return nullary_function_t{[]() {}};
+}
+
+} // namespace
+
+TEST_CASE("Private deques hand out their oldest task", "[private_deque]") {
+
+  fake_tasks tasks;
+
+  std::atomic<worker_context *> victim = nullptr;
+  std::atomic<bool> done = false;
+
+  bool kept_fork = true;
+  task_handle after = nullptr;
+  bool empty_after = false;
+
+  std::thread owner{[&]() {
+    victim.store(worker_init(noop(), true));
+
+    impl::full_context *context = impl::tls::context();
+
+    context->next_strand(1); // Executing a task.
+    context->push(tasks[0]);
+    context->push(tasks[1]);
+
+    // Fork-join until the thief has taken both, steal requests are answered in here.
+    while (!done.load()) {
+      context->push(tasks[2]);
+      kept_fork = kept_fork && context->pop() == tasks[2];
+    }
+
+    after = context->pop();
+    empty_after = context->empty();
+
+    context->next_strand(1);
+    finalize(victim.load());
+  }};
+
+  worker_context *me = worker_init(noop(), true);
+
+  REQUIRE(me->private_deque());
+
+  while (victim.load() == nullptr) {
+    std::this_thread::yield();
+  }
+
+  std::vector<task_handle> stolen;
+
+  while (stolen.size() < 2) {
+    if (auto [code, task] = victim.load()->try_steal(me); code == err::none) {
+      stolen.push_back(task);
+    }
+  }
+
+  done.store(true);
+  owner.join();
+  finalize(me);
+
+  REQUIRE(stolen == std::vector{tasks[0], tasks[1]});
+  REQUIRE(kept_fork);
+  REQUIRE(after == nullptr);
+  REQUIRE(empty_after);
+}
+
+TEST_CASE("Unanswered steal requests are withdrawn", "[private_deque]") {
+
+  fake_tasks tasks;
+
+  std::atomic<worker_context *> victim = nullptr;
+  std::atomic<bool> asked = false;
+
+  task_handle popped = nullptr;
+
+  std::thread owner{[&]() {
+    victim.store(worker_init(noop(), true));
+
+    impl::full_context *context = impl::tls::context();
+
+    context->next_strand(1);
+    context->push(tasks[0]);
+
+    // A long serial strand, we never poll for requests.
+    while (!asked.load()) {
+      std::this_thread::yield();
+    }
+
+    popped = context->pop();
+
+    context->next_strand(1);
+    finalize(victim.load());
+  }};
+
+  worker_context *me = worker_init(noop(), true);
+
+  while (victim.load() == nullptr) {
+    std::this_thread::yield();
+  }
+
+  // Without patience no request is posted.
+  int broke = 0;
+  err impatient = victim.load()->try_steal(me, broke).code;
+
+  int patience = 10;
+  err code = victim.load()->try_steal(me, patience).code;
+
+  asked.store(true);
+  owner.join();
+  finalize(me);
+
+  REQUIRE(impatient == err::empty);
+  REQUIRE(code == err::empty);
+  REQUIRE(patience == 0);
+  REQUIRE(popped == tasks[0]);
+}
+
+TEMPLATE_TEST_CASE("Pools with private deques", "[private_deque][template]", busy_pool, lazy_pool) {
+
+  for (std::size_t n : {1U, 2U, 4U}) {
+
+    TestType pool{n, numa_strategy::fan, {.private_deques = true}};
+
+    for (worker_context *context : pool.contexts()) {
+      REQUIRE(context->private_deque());
+    }
+
+    for (int i = 0; i < 10; ++i) {
+      REQUIRE(sync_wait(pool, fib, 20) == 6765);
+    }
+  }
+}
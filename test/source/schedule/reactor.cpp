@@ -0,0 +1,216 @@
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <atomic>                       // for atomic, memory_order_relaxed
+#include <catch2/catch_test_macros.hpp> // for REQUIRE, TEST_CASE
+#include <chrono>                       // for steady_clock, seconds, nanoseconds
+#include <condition_variable>           // for condition_variable
+#include <cstddef>                      // for size_t
+#include <functional>                   // for function
+#include <mutex>                        // for mutex, lock_guard, unique_lock
+#include <thread>                       // for this_thread, thread
+#include <utility>                      // for exchange, move
+#include <vector>                       // for vector
+
+#include "libfork/core.hpp"     // for task, fork, call, join, sync_wait
+#include "libfork/schedule.hpp" // for lazy_pool, reactor, event_count
+
+using namespace lf;
+
+namespace {
+
+/**
+ * @brief A portable reactor whose events are callbacks posted by other threads.
+ */
+class queue_reactor final : public reactor {
+ public:
+  auto poll(std::chrono::nanoseconds timeout) noexcept -> std::size_t override {
+
+    std::unique_lock lock{m_mut};
+
+    m_polls.fetch_add(1, std::memory_order_relaxed);
+
+    auto ready = [&] {
+      return m_woken || !m_events.empty();
+    };
+
+    if (timeout < std::chrono::nanoseconds::zero()) {
+      m_cv.wait(lock, ready);
+    } else {
+      m_cv.wait_for(lock, timeout, ready);
+    }
+
+    m_woken = false;
+
+    std::vector events = std::exchange(m_events, {});
+
+    lock.unlock();
+
+    for (auto &&event : events) {
+      event();
+    }
+
+    return events.size();
+  }
+
+  void wake() noexcept override {
+    {
+      std::lock_guard lock{m_mut};
+      m_woken = true;
+    }
+    m_cv.notify_one();
+  }
+
+  void post(std::function<void()> event) {
+    {
+      std::lock_guard lock{m_mut};
+      m_events.push_back(std::move(event));
+    }
+    m_cv.notify_one();
+  }
+
+  [[nodiscard]] auto polls() const noexcept -> std::size_t { return m_polls.load(std::memory_order_relaxed); }
+
+ private:
+  std::mutex m_mut;
+  std::condition_variable m_cv;
+  bool m_woken = false;
+  std::vector<std::function<void()>> m_events;
+  std::atomic<std::size_t> m_polls = 0;
+};
+
+inline constexpr auto fib = [](auto fib, int n) -> task<int> {
+  //
+  if (n < 2) {
+    co_return n;
+  }
+
+  int a = 0;
+  int b = 0;
+
+  co_await lf::fork(&a, fib)(n - 1);
+  co_await lf::call(&b, fib)(n - 2);
+
+  co_await lf::join;
+
+  co_return a + b;
+};
+
+inline constexpr auto busy = [](auto, queue_reactor *loop, std::atomic<int> *handled) -> task<bool> {
+  //
+  loop->post([handled] {
+    handled->fetch_add(1);
+  });
+
+  // Keep the pool busy (never idle) until the event has been handled.
+  auto stop = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+  while (handled->load() == 0 && std::chrono::steady_clock::now() < stop) {
+    int a = 0;
+    co_await lf::fork(&a, fib)(10);
+    co_await lf::join;
+  }
+
+  co_return handled->load() > 0;
+};
+
+/**
+ * @brief Spin (with a timeout) until `pred()` is true.
+ */
+template <typename F>
+auto within_timeout(F pred) -> bool {
+
+  auto stop = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+  while (!pred()) {
+    if (std::chrono::steady_clock::now() > stop) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+
+  return true;
+}
+
+void count(void *arg) noexcept { static_cast<std::atomic<int> *>(arg)->fetch_add(1); }
+
+} // namespace
+
+TEST_CASE("Event count notify hook", "[reactor]") {
+
+  event_count ec;
+  std::atomic<int> hooks = 0;
+
+  ec.on_notify(count, &hooks);
+
+  // No waiters, no hook.
+  ec.notify_all();
+  REQUIRE(hooks == 0);
+
+  auto key = ec.prepare_wait();
+  REQUIRE(!ec.notified(key));
+
+  ec.notify_one();
+  REQUIRE(hooks == 1);
+  REQUIRE(ec.notified(key));
+
+  ec.cancel_wait();
+}
+
+TEST_CASE("Idle workers drive a reactor", "[reactor]") {
+
+  queue_reactor loop;
+
+  {
+    lazy_pool pool{3, numa_strategy::fan, {.events = &loop}};
+
+    // An idle pool parks a worker in the reactor.
+    REQUIRE(within_timeout([&] {
+      return loop.polls() > 0;
+    }));
+
+    std::atomic<int> handled = 0;
+    std::atomic<bool> off_thread = true;
+
+    for (int i = 0; i < 100; ++i) {
+      loop.post([&, caller = std::this_thread::get_id()] {
+        if (std::this_thread::get_id() == caller) {
+          off_thread = false;
+        }
+        handled.fetch_add(1);
+      });
+    }
+
+    REQUIRE(within_timeout([&] {
+      return handled == 100;
+    }));
+
+    REQUIRE(off_thread);
+
+    // Work submitted to the pool must wake the worker parked in the reactor.
+    for (int i = 0; i < 20; ++i) {
+      REQUIRE(sync_wait(pool, fib, 15) == 610);
+    }
+
+    // Destruction must also return the worker from the reactor.
+  }
+
+  REQUIRE(loop.polls() > 0);
+}
+
+TEST_CASE("Searching workers poll a reactor", "[reactor]") {
+
+  queue_reactor loop;
+
+  lazy_pool pool{2, numa_strategy::fan, {.events = &loop}};
+
+  for (int i = 0; i < 10; ++i) {
+    std::atomic<int> handled = 0;
+    REQUIRE(sync_wait(pool, busy, &loop, &handled));
+  }
+}
@@ -0,0 +1,139 @@
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <catch2/catch_test_macros.hpp> // for REQUIRE, TEST_CASE
+#include <chrono>                       // for milliseconds, steady_clock
+#include <cstddef>                      // for size_t
+#include <mutex>                        // for mutex, lock_guard
+#include <thread>                       // for sleep_for
+#include <vector>                       // for vector
+
+#include "libfork/core.hpp"     // for task, fork, call, join, sync_wait
+#include "libfork/schedule.hpp" // for lazy_pool, stall_detector, stall_report
+
+#ifdef LF_STALL_DETECTOR
+
+using namespace lf;
+using namespace std::chrono_literals;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct recorder {
+  std::mutex mut;
+  std::vector<stall_report> reports;
+
+  auto callback() -> stall_detector::callback_t {
+    return [this](stall_report const &report) {
+      std::lock_guard lock{mut};
+      reports.push_back(report);
+    };
+  }
+
+  auto size() -> std::size_t {
+    std::lock_guard lock{mut};
+    return reports.size();
+  }
+};
+
+inline constexpr auto spin = [](auto, recorder *rec, std::chrono::milliseconds linger) -> task<> {
+  // A serial loop that never reaches a fork/join boundary, runs until reported (with a safety bound).
+  for (auto stop = clock_type::now() + 60s; rec->size() == 0 && clock_type::now() < stop;) {
+  }
+  // Give the detector the chance to (incorrectly) report the same strand again.
+  for (auto stop = clock_type::now() + linger; clock_type::now() < stop;) {
+  }
+  co_return;
+};
+
+inline constexpr auto fib = [](auto fib, int n) -> task<int> {
+  //
+  if (n < 2) {
+    co_return n;
+  }
+
+  int a = 0;
+  int b = 0;
+
+  co_await lf::fork(&a, fib)(n - 1);
+  co_await lf::call(&b, fib)(n - 2);
+
+  co_await lf::join;
+
+  co_return a + b;
+};
+
+inline constexpr auto churn = [](auto, std::chrono::milliseconds time) -> task<bool> {
+  // Lots of short strands for longer than the threshold.
+  bool ok = true;
+
+  for (auto stop = clock_type::now() + time; clock_type::now() < stop;) {
+    int a = 0;
+    co_await lf::fork(&a, fib)(10);
+    co_await lf::join;
+    ok = ok && a == 55;
+  }
+
+  co_return ok;
+};
+
+} // namespace
+
+TEST_CASE("Stall detector reports a spinning task once", "[stall_detector]") {
+
+  lazy_pool pool{2};
+
+  recorder rec;
+
+  {
+    stall_detector watchdog{pool.contexts(), 50ms, rec.callback()};
+    sync_wait(pool, spin, &rec, 200ms);
+  }
+
+  REQUIRE(rec.reports.size() == 1);
+  REQUIRE(rec.reports[0].duration >= 50ms);
+  REQUIRE(rec.reports[0].strand % 2 == 1);
+  REQUIRE(rec.reports[0].context == pool.contexts()[rec.reports[0].worker]);
+
+  #ifdef LF_ASYNC_STACK
+  REQUIRE(rec.reports[0].task);
+  #else
+  REQUIRE(!rec.reports[0].task);
+  #endif
+}
+
+TEST_CASE("Stall detector ignores idle workers", "[stall_detector]") {
+
+  lazy_pool pool{2};
+
+  recorder rec;
+
+  {
+    stall_detector watchdog{pool.contexts(), 1ms, rec.callback()};
+    std::this_thread::sleep_for(50ms);
+  }
+
+  REQUIRE(rec.reports.empty());
+}
+
+TEST_CASE("Stall detector ignores progressing workers", "[stall_detector]") {
+
+  lazy_pool pool{2};
+
+  recorder rec;
+
+  {
+    stall_detector watchdog{pool.contexts(), 500ms, rec.callback()};
+    REQUIRE(sync_wait(pool, churn, 1500ms));
+  }
+
+  REQUIRE(rec.reports.empty());
+}
+
+#endif
@@ -0,0 +1,122 @@
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <catch2/catch_template_test_macros.hpp> // for TEMPLATE_TEST_CASE
+#include <catch2/catch_test_macros.hpp>          // for REQUIRE
+#include <cstddef>                               // for size_t
+#include <set>                                   // for set
+#include <vector>                                // for vector
+
+#include "libfork/core.hpp"     // for task, fork, call, join, sync_wait, worker_context
+#include "libfork/schedule.hpp" // for busy_pool, lazy_pool, numa_topology, pool_options
+
+using namespace lf;
+
+namespace {
+
+inline constexpr auto fib = [](auto fib, int n) -> task<int> {
+  //
+  if (n < 2) {
+    co_return n;
+  }
+
+  int a = 0;
+  int b = 0;
+
+  co_await lf::fork(&a, fib)(n - 1);
+  co_await lf::call(&b, fib)(n - 2);
+
+  co_await lf::join;
+
+  co_return a + b;
+};
+
+inline constexpr auto where = [](auto self) -> task<worker_context *> {
+  co_return self.context();
+};
+
+/**
+ * @brief Construct a pool, check every worker started and run something on it.
+ */
+template <typename Pool>
+void start_and_run(std::size_t n, numa_strategy strategy, pool_options const &options) {
+
+  Pool pool{n, strategy, options};
+
+  auto contexts = pool.contexts();
+
+  REQUIRE(contexts.size() == n);
+
+  std::set<worker_context *> unique{contexts.begin(), contexts.end()};
+
+  REQUIRE(unique.size() == n);
+  REQUIRE(!unique.contains(nullptr));
+
+  REQUIRE(sync_wait(pool, fib, 15) == 610);
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("Pools start every worker", "[startup][template]", busy_pool, lazy_pool) {
+
+  REQUIRE(static_cast<bool>(numa_topology::cached()) == numa_support());
+
+  for (std::size_t n : {1U, 2U, 3U, 6U, 13U}) {
+    for (bool warm : {false, true}) {
+      start_and_run<TestType>(n, numa_strategy::fan, {.warm_up = warm});
+      start_and_run<TestType>(n, numa_strategy::seq, {.warm_up = warm});
+    }
+  }
+
+#ifdef LF_USE_HWLOC
+  // Placement on an imaginary machine, binding is a noop.
+  pool_options big{.topology = numa_topology::from_synthetic("pack:4 numa:2 core:4 pu:2")};
+
+  start_and_run<TestType>(8, numa_strategy::fan, big);
+  start_and_run<TestType>(8, numa_strategy::seq, big);
+#endif
+}
+
+#ifdef LF_USE_HWLOC
+
+TEMPLATE_TEST_CASE("Roots prefer fast cores", "[startup][template]", busy_pool, lazy_pool) {
+
+  // Two fast and two slow cores.
+  numa_topology hybrid = numa_topology::from_synthetic("pack:2 core:2 pu:1", {{2, 3}, {0, 1}});
+
+  // Workers are distributed in the same order as the handles.
+  std::vector handles = hybrid.split(4);
+
+  for (bool prefer : {false, true}) {
+
+    pool_options options{.topology = hybrid, .prefer_fast_cores = prefer};
+
+    TestType pool{4, numa_strategy::fan, options};
+
+    std::set<std::size_t> used;
+
+    for (int i = 0; i < 200; i++) {
+
+      worker_context *context = sync_wait(pool, where);
+
+      for (std::size_t j = 0; j < 4; j++) {
+        if (pool.contexts()[j] == context) {
+          used.insert(j);
+        }
+      }
+    }
+
+    for (std::size_t j : used) {
+      REQUIRE((handles[j].efficiency == 1 || !prefer));
+    }
+
+    REQUIRE(used.size() == (prefer ? 2 : 4));
+  }
+}
+
+#endif
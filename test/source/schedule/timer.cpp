@@ -0,0 +1,183 @@
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <algorithm>                    // for max
+#include <atomic>                       // for atomic
+#include <catch2/catch_test_macros.hpp> // for REQUIRE, TEST_CASE
+#include <chrono>                       // for steady_clock, milliseconds
+#include <cstddef>                      // for size_t
+#include <cstdint>                      // for uint64_t
+#include <random>                       // for mt19937_64, uniform_int_distribution
+#include <vector>                       // for vector
+
+#include "libfork/core.hpp"     // for task, fork, call, join, sync_wait
+#include "libfork/schedule.hpp" // for lazy_pool, busy_pool, timer_wheel, timer_node, sleep_for
+
+using namespace lf;
+
+namespace {
+
+/**
+ * @brief A timer that records the tick it fired at.
+ */
+struct probe : timer_node {
+
+  probe() : timer_node{record} {}
+
+  static void record(timer_node *node) noexcept { static_cast<probe *>(node)->fired = true; }
+
+  bool fired = false;
+};
+
+/**
+ * @brief Advance `wheel` to `to` and mark the expired timers, returns false if any fired early or late.
+ */
+auto step(timer_wheel &wheel, std::uint64_t to) -> bool {
+
+  bool ok = true;
+
+  for (timer_node *node = wheel.advance(to); node != nullptr;) {
+    timer_node *next = timer_wheel::next(node);
+    ok = ok && node->expiry() == to;
+    node->fire();
+    node = next;
+  }
+
+  return ok;
+}
+
+using namespace std::chrono_literals;
+
+inline constexpr auto nap = [](auto nap, int n, std::chrono::milliseconds dur) -> task<> {
+  //
+  if (n == 1) {
+    co_await lf::sleep_for(dur);
+    co_return;
+  }
+
+  co_await lf::fork(nap)(n / 2, dur);
+  co_await lf::call(nap)(n - n / 2, dur);
+
+  co_await lf::join;
+};
+
+/**
+ * @brief Sleep for `dur` until `done` is set, returns the number of naps.
+ */
+inline constexpr auto doze = [](auto, std::atomic<bool> *done, std::chrono::milliseconds dur) -> task<int> {
+  //
+  int naps = 0;
+
+  while (!done->load()) {
+    co_await lf::sleep_for(dur);
+    ++naps;
+  }
+
+  co_return naps;
+};
+
+/**
+ * @brief Fork a dozing child then wake it from the parent.
+ */
+inline constexpr auto wake = [](auto, std::chrono::milliseconds dur) -> task<int> {
+  //
+  std::atomic<bool> done = false;
+
+  int naps = 0;
+
+  co_await lf::fork(&naps, doze)(&done, dur);
+
+  done.store(true);
+
+  co_await lf::join;
+
+  co_return naps;
+};
+
+} // namespace
+
+TEST_CASE("Timer wheel fires on time", "[timer]") {
+
+  std::mt19937_64 rng{42};
+
+  // Cover every level and the overflow list.
+  std::uniform_int_distribution<std::uint64_t> near{0, 300};
+  std::uniform_int_distribution<std::uint64_t> far{0, std::uint64_t{1} << 25};
+
+  timer_wheel wheel{12345};
+
+  std::vector<probe> timers(2000);
+
+  std::uint64_t last = 0;
+
+  for (std::size_t i = 0; i < timers.size(); ++i) {
+    std::uint64_t expiry = wheel.now() + 1 + (i % 4 == 0 ? far(rng) : near(rng));
+    wheel.insert(&timers[i], expiry);
+    last = std::max(last, expiry);
+  }
+
+  // Cancel some.
+  for (std::size_t i = 0; i < timers.size(); i += 7) {
+    REQUIRE(wheel.cancel(&timers[i]));
+    REQUIRE(!wheel.cancel(&timers[i]));
+  }
+
+  REQUIRE(wheel.size() == timers.size() - (timers.size() + 6) / 7);
+
+  // Step one tick at a time near the start then, jump by the wheel's own hint.
+  while (wheel.now() < 1000 + 12345) {
+    REQUIRE(step(wheel, wheel.now() + 1));
+  }
+
+  while (wheel.size() > 0) {
+    std::uint64_t next = wheel.next_expiry();
+    REQUIRE(next > wheel.now());
+    REQUIRE(step(wheel, next));
+  }
+
+  REQUIRE(wheel.now() <= last);
+
+  for (std::size_t i = 0; i < timers.size(); ++i) {
+    REQUIRE(timers[i].fired == (i % 7 != 0));
+  }
+}
+
+TEST_CASE("Timer wheel jumps when empty", "[timer]") {
+
+  timer_wheel wheel;
+
+  REQUIRE(wheel.next_expiry() == timer_wheel::never);
+  REQUIRE(wheel.advance(1'000'000) == nullptr);
+  REQUIRE(wheel.now() == 1'000'000);
+
+  probe past;
+
+  // A timer in the past fires on the next tick.
+  wheel.insert(&past, 10);
+  REQUIRE(wheel.next_expiry() == 1'000'001);
+  REQUIRE(step(wheel, 1'000'001));
+  REQUIRE(past.fired);
+}
+
+TEST_CASE("Sleeping tasks do not block workers", "[timer]") {
+
+  // With one worker the parent can only set the flag while its child is asleep, else this never returns.
+  lazy_pool pool{1};
+
+  REQUIRE(sync_wait(pool, wake, 1ms) > 0);
+
+  auto start = std::chrono::steady_clock::now();
+
+  sync_wait(pool, nap, 1, 20ms);
+
+  REQUIRE(std::chrono::steady_clock::now() - start >= 20ms);
+
+  sync_wait(pool, nap, 100, 1ms);
+
+  REQUIRE(timer_service::global().size() == 0);
+}
@@ -0,0 +1,97 @@
+// Copyright © Conor Williams <conorwilliams@outlook.com>
+
+// SPDX-License-Identifier: MPL-2.0
+
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <catch2/catch_template_test_macros.hpp> // for TEMPLATE_TEST_CASE
+#include <catch2/catch_test_macros.hpp>          // for REQUIRE, TEST_CASE
+#include <chrono>                                // for milliseconds, nanoseconds
+#include <concepts>                              // for same_as
+#include <thread>                                // for sleep_for
+#include <vector>                                // for vector
+
+#include "libfork/core.hpp"     // for task, fork, call, join, sync_wait
+#include "libfork/schedule.hpp" // for busy_pool, lazy_pool, worker_utilization
+
+using namespace lf;
+
+namespace {
+
+inline constexpr auto fib = [](auto fib, int n) -> task<int> {
+  //
+  if (n < 2) {
+    co_return n;
+  }
+
+  int a = 0;
+  int b = 0;
+
+  co_await lf::fork(&a, fib)(n - 1);
+  co_await lf::call(&b, fib)(n - 2);
+
+  co_await lf::join;
+
+  co_return a + b;
+};
+
+auto sum(std::vector<worker_utilization> const &workers) -> worker_utilization {
+  worker_utilization out;
+  for (auto const &worker : workers) {
+    out += worker;
+  }
+  return out;
+}
+
+} // namespace
+
+TEST_CASE("Utilization arithmetic", "[utilization]") {
+
+  using std::chrono::nanoseconds;
+
+  worker_utilization a{nanoseconds{3}, nanoseconds{2}, nanoseconds{5}};
+  worker_utilization b{nanoseconds{1}, nanoseconds{1}, nanoseconds{1}};
+
+  REQUIRE(a.total() == nanoseconds{10});
+  REQUIRE(a.busy_fraction() == 0.3);
+  REQUIRE((a - b).total() == nanoseconds{7});
+  REQUIRE((a + b).executing == nanoseconds{4});
+  REQUIRE(worker_utilization{}.busy_fraction() == 0.0);
+}
+
+TEMPLATE_TEST_CASE("Utilization accounting", "[utilization][template]", busy_pool, lazy_pool) {
+
+  using namespace std::chrono_literals;
+
+  TestType sch{2};
+
+#ifdef LF_UTILIZATION
+
+  worker_utilization before = sum(sch.utilization());
+
+  REQUIRE(sch.utilization().size() == 2);
+
+  REQUIRE(sync_wait(sch, fib, 25) == 75025);
+
+  std::this_thread::sleep_for(50ms);
+
+  worker_utilization delta = sum(sch.utilization()) - before;
+
+  REQUIRE(delta.executing > 0ns);
+
+  // Two workers have been alive for at least the 50ms we slept.
+  REQUIRE(delta.total() >= 2 * 50ms);
+
+  if constexpr (std::same_as<TestType, busy_pool>) {
+    REQUIRE(delta.sleeping == 0ns);
+  } else {
+    REQUIRE(delta.sleeping > 0ns);
+  }
+#else
+  // Accounting is compiled out.
+  REQUIRE(sync_wait(sch, fib, 25) == 75025);
+  REQUIRE(sum(sch.utilization()).total() == 0ns);
+#endif
+}